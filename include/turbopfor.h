@@ -41,6 +41,16 @@ const unsigned char * p4Dec256v32(const unsigned char * in, unsigned n, uint32_t
 /// Decode n 32-bit integers using P4 with 256-element SIMD blocks and delta1
 const unsigned char * p4D1Dec256v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start);
 
+/// Encode n 32-bit integers using the Stream-VByte layout: ceil(n/4) control
+/// bytes (two bits per value holding its byte length minus one), then the
+/// values' low 1-4 little-endian bytes back to back. A separate stream format
+/// from P4; the split layout lets the decoder process four values per table
+/// lookup instead of walking a serial varint chain.
+unsigned char * streamVByteEnc32(const uint32_t * in, unsigned n, unsigned char * out);
+
+/// Decode n 32-bit integers encoded by streamVByteEnc32
+const unsigned char * streamVByteDec32(const unsigned char * in, unsigned n, uint32_t * out);
+
 /// Encode n 64-bit integers using P4 (PFor) compression
 unsigned char * p4Enc64(uint64_t * in, unsigned n, unsigned char * out);
 
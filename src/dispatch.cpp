@@ -29,80 +29,207 @@ const unsigned char * p4D1Dec32(const unsigned char * in, unsigned n, uint32_t *
     return turbopfor::scalar::p4D1Dec32(in, n, out, start);
 }
 
-// p4enc128v32 and p4dec128v32/p4d1dec128v32 use SIMD if available, otherwise scalar
+// Stream-VByte has a single implementation; its SSSE3 fast path sits behind
+// a compile-time guard inside the scalar TU.
+unsigned char * streamVByteEnc32(const uint32_t * in, unsigned n, unsigned char * out)
+{
+    return turbopfor::scalar::streamVByteEnc32(in, n, out);
+}
+
+const unsigned char * streamVByteDec32(const unsigned char * in, unsigned n, uint32_t * out)
+{
+    return turbopfor::scalar::streamVByteDec32(in, n, out);
+}
+
+// p4enc128v32 and p4dec128v32/p4d1dec128v32 use the SSE kernels when they
+// are compiled in. With the kernels present, selection happens once at load
+// time through an IFUNC resolver, so the same binary still runs (on the
+// scalar path) on CPUs without SSE4.2 instead of faulting.
+#if defined(ENABLE_SSE42) && defined(__ELF__)
+
+extern "C" void * turbopforResolveP4Enc128v32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4Enc128v32);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4Enc128v32);
+}
+
+unsigned char * p4Enc128v32(uint32_t * in, unsigned n, unsigned char * out) __attribute__((ifunc("turbopforResolveP4Enc128v32")));
+
+extern "C" void * turbopforResolveP4D1Enc128v32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4D1Enc128v32);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4D1Enc128v32);
+}
+
+unsigned char * p4D1Enc128v32(uint32_t * in, unsigned n, unsigned char * out, uint32_t start) __attribute__((ifunc("turbopforResolveP4D1Enc128v32")));
+
+extern "C" void * turbopforResolveP4Dec128v32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4Dec128v32);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4Dec128v32);
+}
+
+const unsigned char * p4Dec128v32(const unsigned char * in, unsigned n, uint32_t * out) __attribute__((ifunc("turbopforResolveP4Dec128v32")));
+
+extern "C" void * turbopforResolveP4D1Dec128v32()
+{
+    __builtin_cpu_init();
+    // The AVX2 tier is selected here, against a plain named variant, rather
+    // than via target_clones on the implementations: every function whose
+    // address this resolver takes must not itself be an IFUNC, because
+    // IRELATIVE relocations carry no ordering guarantee and the outer
+    // resolver can observe the inner one's still-empty GOT slot.
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4D1Dec128v32Avx2);
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4D1Dec128v32);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4D1Dec128v32);
+}
+
+const unsigned char * p4D1Dec128v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start) __attribute__((ifunc("turbopforResolveP4D1Dec128v32")));
+
+#elif defined(ENABLE_SSE42)
+
 unsigned char * p4Enc128v32(uint32_t * in, unsigned n, unsigned char * out)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4Enc128v32(in, n, out);
-#else
-    return turbopfor::scalar::p4Enc128v32(in, n, out);
-#endif
 }
 
 unsigned char * p4D1Enc128v32(uint32_t * in, unsigned n, unsigned char * out, uint32_t start)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4D1Enc128v32(in, n, out, start);
-#else
-    return turbopfor::scalar::p4D1Enc128v32(in, n, out, start);
-#endif
 }
 
 const unsigned char * p4Dec128v32(const unsigned char * in, unsigned n, uint32_t * out)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4Dec128v32(in, n, out);
-#else
-    return turbopfor::scalar::p4Dec128v32(in, n, out);
-#endif
 }
 
 const unsigned char * p4D1Dec128v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4D1Dec128v32(in, n, out, start);
+}
+
 #else
+
+unsigned char * p4Enc128v32(uint32_t * in, unsigned n, unsigned char * out)
+{
+    return turbopfor::scalar::p4Enc128v32(in, n, out);
+}
+
+unsigned char * p4D1Enc128v32(uint32_t * in, unsigned n, unsigned char * out, uint32_t start)
+{
+    return turbopfor::scalar::p4D1Enc128v32(in, n, out, start);
+}
+
+const unsigned char * p4Dec128v32(const unsigned char * in, unsigned n, uint32_t * out)
+{
+    return turbopfor::scalar::p4Dec128v32(in, n, out);
+}
+
+const unsigned char * p4D1Dec128v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
+{
     return turbopfor::scalar::p4D1Dec128v32(in, n, out, start);
+}
+
 #endif
+
+// p4enc256v32 and p4dec256v32/p4d1dec256v32 use the AVX2 kernels when they
+// are compiled in, resolved at load time as above.
+#if defined(ENABLE_AVX2) && defined(__ELF__)
+
+extern "C" void * turbopforResolveP4Enc256v32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4Enc256v32);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4Enc256v32);
+}
+
+unsigned char * p4Enc256v32(uint32_t * in, unsigned n, unsigned char * out) __attribute__((ifunc("turbopforResolveP4Enc256v32")));
+
+extern "C" void * turbopforResolveP4D1Enc256v32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4D1Enc256v32);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4D1Enc256v32);
+}
+
+unsigned char * p4D1Enc256v32(uint32_t * in, unsigned n, unsigned char * out, uint32_t start) __attribute__((ifunc("turbopforResolveP4D1Enc256v32")));
+
+extern "C" void * turbopforResolveP4Dec256v32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4Dec256v32);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4Dec256v32);
 }
 
-// p4enc256v32 and p4dec256v32/p4d1dec256v32 use SIMD (AVX2) if available, otherwise scalar
+const unsigned char * p4Dec256v32(const unsigned char * in, unsigned n, uint32_t * out) __attribute__((ifunc("turbopforResolveP4Dec256v32")));
+
+extern "C" void * turbopforResolveP4D1Dec256v32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4D1Dec256v32);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4D1Dec256v32);
+}
+
+const unsigned char * p4D1Dec256v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start) __attribute__((ifunc("turbopforResolveP4D1Dec256v32")));
+
+#elif defined(ENABLE_AVX2)
+
 unsigned char * p4Enc256v32(uint32_t * in, unsigned n, unsigned char * out)
 {
-#ifdef ENABLE_AVX2
     return turbopfor::simd::p4Enc256v32(in, n, out);
-#else
-    return turbopfor::scalar::p4Enc256v32(in, n, out);
-#endif
 }
 
 unsigned char * p4D1Enc256v32(uint32_t * in, unsigned n, unsigned char * out, uint32_t start)
 {
-#ifdef ENABLE_AVX2
     return turbopfor::simd::p4D1Enc256v32(in, n, out, start);
-#else
-    return turbopfor::scalar::p4D1Enc256v32(in, n, out, start);
-#endif
 }
 
 const unsigned char * p4Dec256v32(const unsigned char * in, unsigned n, uint32_t * out)
 {
-#ifdef ENABLE_AVX2
     return turbopfor::simd::p4Dec256v32(in, n, out);
-#else
-    return turbopfor::scalar::p4Dec256v32(in, n, out);
-#endif
 }
 
 const unsigned char * p4D1Dec256v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
 {
-#ifdef ENABLE_AVX2
     return turbopfor::simd::p4D1Dec256v32(in, n, out, start);
+}
+
 #else
+
+unsigned char * p4Enc256v32(uint32_t * in, unsigned n, unsigned char * out)
+{
+    return turbopfor::scalar::p4Enc256v32(in, n, out);
+}
+
+unsigned char * p4D1Enc256v32(uint32_t * in, unsigned n, unsigned char * out, uint32_t start)
+{
+    return turbopfor::scalar::p4D1Enc256v32(in, n, out, start);
+}
+
+const unsigned char * p4Dec256v32(const unsigned char * in, unsigned n, uint32_t * out)
+{
+    return turbopfor::scalar::p4Dec256v32(in, n, out);
+}
+
+const unsigned char * p4D1Dec256v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
+{
     return turbopfor::scalar::p4D1Dec256v32(in, n, out, start);
-#endif
 }
 
+#endif
+
 // p4enc64 and p4d1dec64 always use scalar versions
 unsigned char * p4Enc64(uint64_t * in, unsigned n, unsigned char * out)
 {
@@ -124,85 +251,191 @@ const unsigned char * p4D1Dec64(const unsigned char * in, unsigned n, uint64_t *
     return turbopfor::scalar::p4D1Dec64(in, n, out, start);
 }
 
-// p4enc128v64 and p4dec128v64/p4d1dec128v64 use SIMD if available.
+// p4enc128v64 and p4dec128v64/p4d1dec128v64 use the SSE kernels when they
+// are compiled in, resolved at load time as above.
 // The STO64 pair-swap bug has been fixed (IP32 reordering is now reversed
 // in all decode templates via _mm_shuffle_epi32 before output).
 // The 64-bit start value handling uses a safe fallback: when start > UINT32_MAX,
 // the fused D1 path (which uses 32-bit prefix sum) falls back to SIMD unpack +
 // scalar delta1, avoiding truncation.
+#if defined(ENABLE_SSE42) && defined(__ELF__)
+
+extern "C" void * turbopforResolveP4Enc128v64()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4Enc128v64);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4Enc128v64);
+}
+
+unsigned char * p4Enc128v64(uint64_t * in, unsigned n, unsigned char * out) __attribute__((ifunc("turbopforResolveP4Enc128v64")));
+
+extern "C" void * turbopforResolveP4D1Enc128v64()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4D1Enc128v64);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4D1Enc128v64);
+}
+
+unsigned char * p4D1Enc128v64(uint64_t * in, unsigned n, unsigned char * out, uint64_t start) __attribute__((ifunc("turbopforResolveP4D1Enc128v64")));
+
+extern "C" void * turbopforResolveP4Dec128v64()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4Dec128v64);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4Dec128v64);
+}
+
+const unsigned char * p4Dec128v64(const unsigned char * in, unsigned n, uint64_t * out) __attribute__((ifunc("turbopforResolveP4Dec128v64")));
+
+extern "C" void * turbopforResolveP4D1Dec128v64()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4D1Dec128v64);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4D1Dec128v64);
+}
+
+const unsigned char * p4D1Dec128v64(const unsigned char * in, unsigned n, uint64_t * out, uint64_t start) __attribute__((ifunc("turbopforResolveP4D1Dec128v64")));
+
+#elif defined(ENABLE_SSE42)
+
 unsigned char * p4Enc128v64(uint64_t * in, unsigned n, unsigned char * out)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4Enc128v64(in, n, out);
-#else
-    return turbopfor::scalar::p4Enc128v64(in, n, out);
-#endif
 }
 
 unsigned char * p4D1Enc128v64(uint64_t * in, unsigned n, unsigned char * out, uint64_t start)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4D1Enc128v64(in, n, out, start);
-#else
-    return turbopfor::scalar::p4D1Enc128v64(in, n, out, start);
-#endif
 }
 
 const unsigned char * p4Dec128v64(const unsigned char * in, unsigned n, uint64_t * out)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4Dec128v64(in, n, out);
-#else
-    return turbopfor::scalar::p4Dec128v64(in, n, out);
-#endif
 }
 
 const unsigned char * p4D1Dec128v64(const unsigned char * in, unsigned n, uint64_t * out, uint64_t start)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4D1Dec128v64(in, n, out, start);
+}
+
 #else
+
+unsigned char * p4Enc128v64(uint64_t * in, unsigned n, unsigned char * out)
+{
+    return turbopfor::scalar::p4Enc128v64(in, n, out);
+}
+
+unsigned char * p4D1Enc128v64(uint64_t * in, unsigned n, unsigned char * out, uint64_t start)
+{
+    return turbopfor::scalar::p4D1Enc128v64(in, n, out, start);
+}
+
+const unsigned char * p4Dec128v64(const unsigned char * in, unsigned n, uint64_t * out)
+{
+    return turbopfor::scalar::p4Dec128v64(in, n, out);
+}
+
+const unsigned char * p4D1Dec128v64(const unsigned char * in, unsigned n, uint64_t * out, uint64_t start)
+{
     return turbopfor::scalar::p4D1Dec128v64(in, n, out, start);
+}
+
 #endif
+
+// 256v64 functions use the SSE kernels when they are compiled in, resolved
+// at load time as above. The 256v64 decode wraps 128v64 decode (2x blocks),
+// which uses the corrected SIMD path with the pair-swap fix.
+#if defined(ENABLE_SSE42) && defined(__ELF__)
+
+extern "C" void * turbopforResolveP4Enc256v64()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4Enc256v64);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4Enc256v64);
+}
+
+unsigned char * p4Enc256v64(uint64_t * in, unsigned n, unsigned char * out) __attribute__((ifunc("turbopforResolveP4Enc256v64")));
+
+extern "C" void * turbopforResolveP4D1Enc256v64()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4D1Enc256v64);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4D1Enc256v64);
 }
 
-// 256v64 functions use SIMD (SSE4.2) if available, otherwise scalar.
-// The 256v64 decode wraps 128v64 decode (2× blocks), which now uses the
-// corrected SIMD path with the pair-swap fix.
+unsigned char * p4D1Enc256v64(uint64_t * in, unsigned n, unsigned char * out, uint64_t start) __attribute__((ifunc("turbopforResolveP4D1Enc256v64")));
+
+extern "C" void * turbopforResolveP4Dec256v64()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4Dec256v64);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4Dec256v64);
+}
+
+const unsigned char * p4Dec256v64(const unsigned char * in, unsigned n, uint64_t * out) __attribute__((ifunc("turbopforResolveP4Dec256v64")));
+
+extern "C" void * turbopforResolveP4D1Dec256v64()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2"))
+        return reinterpret_cast<void *>(&turbopfor::simd::p4D1Dec256v64);
+    return reinterpret_cast<void *>(&turbopfor::scalar::p4D1Dec256v64);
+}
+
+const unsigned char * p4D1Dec256v64(const unsigned char * in, unsigned n, uint64_t * out, uint64_t start) __attribute__((ifunc("turbopforResolveP4D1Dec256v64")));
+
+#elif defined(ENABLE_SSE42)
+
 unsigned char * p4Enc256v64(uint64_t * in, unsigned n, unsigned char * out)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4Enc256v64(in, n, out);
-#else
-    return turbopfor::scalar::p4Enc256v64(in, n, out);
-#endif
 }
 
 unsigned char * p4D1Enc256v64(uint64_t * in, unsigned n, unsigned char * out, uint64_t start)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4D1Enc256v64(in, n, out, start);
-#else
-    return turbopfor::scalar::p4D1Enc256v64(in, n, out, start);
-#endif
 }
 
 const unsigned char * p4Dec256v64(const unsigned char * in, unsigned n, uint64_t * out)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4Dec256v64(in, n, out);
-#else
-    return turbopfor::scalar::p4Dec256v64(in, n, out);
-#endif
 }
 
 const unsigned char * p4D1Dec256v64(const unsigned char * in, unsigned n, uint64_t * out, uint64_t start)
 {
-#ifdef ENABLE_SSE42
     return turbopfor::simd::p4D1Dec256v64(in, n, out, start);
+}
+
 #else
+
+unsigned char * p4Enc256v64(uint64_t * in, unsigned n, unsigned char * out)
+{
+    return turbopfor::scalar::p4Enc256v64(in, n, out);
+}
+
+unsigned char * p4D1Enc256v64(uint64_t * in, unsigned n, unsigned char * out, uint64_t start)
+{
+    return turbopfor::scalar::p4D1Enc256v64(in, n, out, start);
+}
+
+const unsigned char * p4Dec256v64(const unsigned char * in, unsigned n, uint64_t * out)
+{
+    return turbopfor::scalar::p4Dec256v64(in, n, out);
+}
+
+const unsigned char * p4D1Dec256v64(const unsigned char * in, unsigned n, uint64_t * out, uint64_t start)
+{
     return turbopfor::scalar::p4D1Dec256v64(in, n, out, start);
-#endif
 }
 
+#endif
+
 } // namespace turbopfor
+
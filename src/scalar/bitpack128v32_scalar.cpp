@@ -30,6 +30,14 @@
 
 #include "p4_scalar_internal.h"
 
+#include <array>
+#include <utility>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    include <emmintrin.h>
+#    define TURBOPFOR_BITPACK128V32_SSE2 1
+#endif
+
 namespace turbopfor::scalar::detail
 {
 
@@ -42,149 +50,201 @@ constexpr unsigned V128_GROUP_COUNT = 32;
 // Number of SIMD lanes
 constexpr unsigned V128_LANE_COUNT = 4;
 
-// Pack 128 x 32-bit values using SIMD-compatible bitpacking format
-//
-// This matches the SIMD implementation: processes 32 groups of 4 values,
-// packing b bits from each value horizontally, writing output when 32-bit
-// boundaries are crossed.
-//
-// Parameters:
-//   in: Input array of 128 uint32_t values
-//   out: Output buffer (must have space for (128 * b + 7) / 8 bytes)
-//   b: Bit width (0-32)
-//
-// Returns: Pointer to end of packed data
-unsigned char * bitpack128v32Scalar(const uint32_t * in, unsigned char * out, unsigned b)
-{
-    // Special case: b=0 means all values are 0, no output needed
-    if (b == 0u)
-        return out;
+#ifdef TURBOPFOR_BITPACK128V32_SSE2
 
-    // Special case: b=32 means no compression, copy with endian conversion
-    if (b == 32u)
+// One group of the compile-time packer. With B a template parameter the bit
+// offset of every group is a constant, so the boundary-crossing test folds
+// away and the 32-group body compiles to straight-line code with a static
+// store cadence — no data-dependent branch survives per group.
+template <unsigned B, unsigned G>
+struct Pack128v32Step
+{
+    static TURBOPFOR_ALWAYS_INLINE void run(const uint32_t * __restrict in, unsigned char *& out, __m128i & ov, const __m128i & mask_vec)
     {
-        copyU32ArrayToLe(out, in, V128_BLOCK_SIZE);
-        return out + V128_BLOCK_SIZE * sizeof(uint32_t);
+        constexpr unsigned offset = (G * B) % 32u;
+
+        const __m128i iv = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + G * V128_LANE_COUNT)), mask_vec);
+
+        if constexpr (offset == 0u)
+            ov = iv;
+        else
+            ov = _mm_or_si128(ov, _mm_slli_epi32(iv, static_cast<int>(offset)));
+
+        if constexpr (offset + B >= 32u)
+        {
+            // One 16-byte store covers all four lanes of the drained line.
+            // Deliberately not _mm_stream_si128: the destination has no
+            // alignment guarantee and a block emits at most 512 bytes, far
+            // below the footprint where bypassing the cache pays off.
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out), ov);
+            out += sizeof(__m128i);
+            if constexpr (offset + B > 32u)
+                ov = _mm_srli_epi32(iv, static_cast<int>(32u - offset));
+            // Exact fit: the next group has offset 0 and overwrites ov.
+        }
+
+        Pack128v32Step<B, G + 1u>::run(in, out, ov, mask_vec);
     }
+};
 
-    const uint32_t mask = (1u << b) - 1u;
+template <unsigned B>
+struct Pack128v32Step<B, V128_GROUP_COUNT>
+{
+    static TURBOPFOR_ALWAYS_INLINE void run(const uint32_t *, unsigned char *&, __m128i &, const __m128i &) { }
+};
 
-    // Accumulator for 4 lanes, each lane accumulates bits until 32-bit boundary
-    uint32_t ov[V128_LANE_COUNT] = {0, 0, 0, 0};
-    unsigned shift = 0;
+#else
 
-    // Process 32 groups, each group has 4 values (one per lane)
-    for (unsigned g = 0; g < V128_GROUP_COUNT; ++g)
+// Portable variant of the compile-time packer: 64-bit lane accumulators hold
+// spilled bits in their high half, so the static store cadence is the only
+// control flow the unrolled body contains.
+template <unsigned B, unsigned G>
+struct Pack128v32Step
+{
+    static TURBOPFOR_ALWAYS_INLINE void run(const uint32_t * __restrict in, unsigned char *& out, uint64_t * ov)
     {
-        // Read 4 values for this group (one per lane)
-        uint32_t iv[V128_LANE_COUNT];
+        constexpr unsigned offset = (G * B) % 32u;
+        constexpr uint32_t mask = (1u << B) - 1u;
+
         for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
-        {
-            iv[lane] = in[g * V128_LANE_COUNT + lane] & mask;
-        }
+            ov[lane] |= static_cast<uint64_t>(in[G * V128_LANE_COUNT + lane] & mask) << offset;
 
-        // Pack bits into accumulator
-        if (shift == 0u)
-        {
-            // Start fresh accumulator
-            for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
-            {
-                ov[lane] = iv[lane];
-            }
-        }
-        else
+        if constexpr (offset + B >= 32u)
         {
-            // OR into existing accumulator with shift
             for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
             {
-                ov[lane] |= iv[lane] << shift;
+                storeU32Fast(out, static_cast<uint32_t>(ov[lane]));
+                out += sizeof(uint32_t);
+                ov[lane] >>= 32u;
             }
         }
 
-        shift += b;
+        Pack128v32Step<B, G + 1u>::run(in, out, ov);
+    }
+};
 
-        // Check if we've filled 32 bits (need to write output)
-        if (shift >= 32u)
-        {
-            // Write 4 lanes (16 bytes)
-            for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
-            {
-                storeU32Fast(out, ov[lane]);
-                out += sizeof(uint32_t);
-            }
+template <unsigned B>
+struct Pack128v32Step<B, V128_GROUP_COUNT>
+{
+    static TURBOPFOR_ALWAYS_INLINE void run(const uint32_t *, unsigned char *&, uint64_t *) { }
+};
 
-            shift -= 32u;
+#endif
 
-            if (shift > 0u)
-            {
-                // Carry over high bits that didn't fit
-                for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
-                {
-                    ov[lane] = iv[lane] >> (b - shift);
-                }
-            }
-            else
-            {
-                // Reset accumulator
-                for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
-                {
-                    ov[lane] = 0;
-                }
-            }
-        }
+// Pack 128 x 32-bit values for one compile-time bit width. 128 * B bits is a
+// whole number of 16-byte lines, so the final group always drains and no tail
+// flush is needed.
+template <unsigned B>
+static unsigned char * pack128v32Fixed(const uint32_t * in, unsigned char * out)
+{
+    if constexpr (B == 0u)
+    {
+        return out;
     }
-
-    // Write any remaining bits
-    if (shift > 0u)
+    else if constexpr (B == 32u)
     {
-        for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
-        {
-            storeU32Fast(out, ov[lane]);
-            out += sizeof(uint32_t);
-        }
+        copyU32ArrayToLe(out, in, V128_BLOCK_SIZE);
+        return out + V128_BLOCK_SIZE * sizeof(uint32_t);
     }
+    else
+    {
+#ifdef TURBOPFOR_BITPACK128V32_SSE2
+        const __m128i mask_vec = _mm_set1_epi32(static_cast<int>((1u << B) - 1u));
+        __m128i ov = _mm_setzero_si128();
+        Pack128v32Step<B, 0u>::run(in, out, ov, mask_vec);
+#else
+        uint64_t ov[V128_LANE_COUNT] = {0, 0, 0, 0};
+        Pack128v32Step<B, 0u>::run(in, out, ov);
+#endif
+        return out;
+    }
+}
+
+using Pack128v32Fn = unsigned char * (*)(const uint32_t *, unsigned char *);
 
-    return out;
+// Constexpr dispatch table over the 33 specializations, generated from an
+// index sequence so the entries can never drift out of step with the range
+// of valid bit widths.
+template <std::size_t... Bs>
+static constexpr std::array<Pack128v32Fn, sizeof...(Bs)> makePack128v32Table(std::index_sequence<Bs...>)
+{
+    return {&pack128v32Fixed<static_cast<unsigned>(Bs)>...};
 }
 
-// Unpack 128 x 32-bit values from SIMD-compatible bitpacking format
+static constexpr auto pack128v32_table = makePack128v32Table(std::make_index_sequence<MAX_BITS_32 + 1u>{});
+
+// Pack 128 x 32-bit values using SIMD-compatible bitpacking format
+//
+// Indexes the per-bit-width specialization; each entry is straight-line code
+// with every shift amount and the mask folded to immediates.
 //
 // Parameters:
-//   in: Input buffer containing packed data
-//   out: Output array for 128 uint32_t values
+//   in: Input array of 128 uint32_t values
+//   out: Output buffer (must have space for (128 * b + 7) / 8 bytes)
 //   b: Bit width (0-32)
 //
-// Returns: Pointer to end of consumed input data
-const unsigned char * bitunpack128v32Scalar(const unsigned char * in, uint32_t * out, unsigned b)
+// Returns: Pointer to end of packed data
+unsigned char * bitpack128v32Scalar(const uint32_t * in, unsigned char * out, unsigned b)
 {
-    // Special case: b=0 means all values are 0
-    if (b == 0u)
-    {
-        std::memset(out, 0, V128_BLOCK_SIZE * sizeof(uint32_t));
-        return in;
-    }
+    return pack128v32_table[b](in, out);
+}
+
+#ifdef TURBOPFOR_BITPACK128V32_SSE2
 
-    // Special case: b=32 means no compression, copy with endian conversion
-    if (b == 32u)
+// One group of the compile-time unpacker, SSE2 variant: the four lanes of a
+// group are one __m128i, so extraction is a single immediate shift + and per
+// group (the direct inverse of the SSE2 packer). Loads sit at static
+// positions, exactly as in the portable variant below.
+template <unsigned B, unsigned G>
+struct Unpack128v32Step
+{
+    static TURBOPFOR_ALWAYS_INLINE void run(const unsigned char *& inp, uint32_t * __restrict out, __m128i & iv, const __m128i & mask_vec)
     {
-        copyU32ArrayFromLe(out, in, V128_BLOCK_SIZE);
-        return in + V128_BLOCK_SIZE * sizeof(uint32_t);
-    }
+        constexpr unsigned offset = (G * B) % 32u;
 
-    const uint32_t mask = (1u << b) - 1u;
+        if constexpr (offset == 0u)
+        {
+            iv = _mm_loadu_si128(reinterpret_cast<const __m128i *>(inp));
+            inp += sizeof(__m128i);
+        }
 
-    // Input value for 4 lanes
-    uint32_t iv[V128_LANE_COUNT] = {0, 0, 0, 0};
-    unsigned shift = 0;
+        __m128i ov = _mm_and_si128(_mm_srli_epi32(iv, static_cast<int>(offset)), mask_vec);
 
-    // Track position in input stream
-    const unsigned char * inp = in;
+        if constexpr (offset + B > 32u)
+        {
+            // The value spans two input lines: reload and OR in the high bits.
+            iv = _mm_loadu_si128(reinterpret_cast<const __m128i *>(inp));
+            inp += sizeof(__m128i);
+            ov = _mm_or_si128(ov, _mm_and_si128(_mm_slli_epi32(iv, static_cast<int>(32u - offset)), mask_vec));
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + G * V128_LANE_COUNT), ov);
 
-    // Process 32 groups, each group produces 4 output values
-    for (unsigned g = 0; g < V128_GROUP_COUNT; ++g)
+        Unpack128v32Step<B, G + 1u>::run(inp, out, iv, mask_vec);
+    }
+};
+
+template <unsigned B>
+struct Unpack128v32Step<B, V128_GROUP_COUNT>
+{
+    static TURBOPFOR_ALWAYS_INLINE void run(const unsigned char *&, uint32_t *, __m128i &, const __m128i &) { }
+};
+
+#else
+
+// One group of the compile-time unpacker. For a given B the load cadence is
+// deterministic (a fresh 16-byte line every 32/gcd(32,B) groups), so with B a
+// template parameter every load sits at a static position and the per-group
+// shift == 0 test of the old loop disappears.
+template <unsigned B, unsigned G>
+struct Unpack128v32Step
+{
+    static TURBOPFOR_ALWAYS_INLINE void run(const unsigned char *& inp, uint32_t * __restrict out, uint32_t * iv)
     {
-        // If shift is 0, we need to load new input
-        if (shift == 0u)
+        constexpr unsigned offset = (G * B) % 32u;
+        constexpr uint32_t mask = (1u << B) - 1u;
+
+        if constexpr (offset == 0u)
         {
             for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
             {
@@ -193,41 +253,89 @@ const unsigned char * bitunpack128v32Scalar(const unsigned char * in, uint32_t *
             }
         }
 
-        // Extract b bits for each lane
         uint32_t ov[V128_LANE_COUNT];
         for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
-        {
-            ov[lane] = (iv[lane] >> shift) & mask;
-        }
+            ov[lane] = (iv[lane] >> offset) & mask;
 
-        shift += b;
-
-        // Check if we need more bits from next input word
-        if (shift >= 32u)
+        if constexpr (offset + B > 32u)
         {
-            shift -= 32u;
-
-            if (shift > 0u)
+            // The value spans two input words: reload and OR in the high bits.
+            for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
             {
-                // Load next input words and get remaining high bits
-                for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
-                {
-                    iv[lane] = loadU32Fast(inp);
-                    inp += sizeof(uint32_t);
-                    // OR in high bits from new word
-                    ov[lane] |= (iv[lane] << (b - shift)) & mask;
-                }
+                iv[lane] = loadU32Fast(inp);
+                inp += sizeof(uint32_t);
+                ov[lane] |= (iv[lane] << (32u - offset)) & mask;
             }
         }
 
-        // Store 4 output values
         for (unsigned lane = 0; lane < V128_LANE_COUNT; ++lane)
-        {
-            out[g * V128_LANE_COUNT + lane] = ov[lane];
-        }
+            out[G * V128_LANE_COUNT + lane] = ov[lane];
+
+        Unpack128v32Step<B, G + 1u>::run(inp, out, iv);
+    }
+};
+
+template <unsigned B>
+struct Unpack128v32Step<B, V128_GROUP_COUNT>
+{
+    static TURBOPFOR_ALWAYS_INLINE void run(const unsigned char *&, uint32_t *, uint32_t *) { }
+};
+
+#endif
+
+// Unpack 128 x 32-bit values for one compile-time bit width.
+template <unsigned B>
+static const unsigned char * unpack128v32Fixed(const unsigned char * in, uint32_t * out)
+{
+    if constexpr (B == 0u)
+    {
+        std::memset(out, 0, V128_BLOCK_SIZE * sizeof(uint32_t));
+        return in;
+    }
+    else if constexpr (B == 32u)
+    {
+        copyU32ArrayFromLe(out, in, V128_BLOCK_SIZE);
+        return in + V128_BLOCK_SIZE * sizeof(uint32_t);
+    }
+    else
+    {
+        const unsigned char * inp = in;
+#ifdef TURBOPFOR_BITPACK128V32_SSE2
+        const __m128i mask_vec = _mm_set1_epi32(static_cast<int>((1u << B) - 1u));
+        __m128i iv = _mm_setzero_si128();
+        Unpack128v32Step<B, 0u>::run(inp, out, iv, mask_vec);
+#else
+        uint32_t iv[V128_LANE_COUNT] = {0, 0, 0, 0};
+        Unpack128v32Step<B, 0u>::run(inp, out, iv);
+#endif
+        return in + (V128_BLOCK_SIZE * B) / 8u;
     }
+}
+
+using Unpack128v32Fn = const unsigned char * (*)(const unsigned char *, uint32_t *);
+
+template <std::size_t... Bs>
+static constexpr std::array<Unpack128v32Fn, sizeof...(Bs)> makeUnpack128v32Table(std::index_sequence<Bs...>)
+{
+    return {&unpack128v32Fixed<static_cast<unsigned>(Bs)>...};
+}
 
-    return in + (V128_BLOCK_SIZE * b + 7u) / 8u;
+static constexpr auto unpack128v32_table = makeUnpack128v32Table(std::make_index_sequence<MAX_BITS_32 + 1u>{});
+
+// Unpack 128 x 32-bit values from SIMD-compatible bitpacking format
+//
+// Indexes the per-bit-width specialization; loads, shifts and the mask are
+// all static within each entry.
+//
+// Parameters:
+//   in: Input buffer containing packed data
+//   out: Output array for 128 uint32_t values
+//   b: Bit width (0-32)
+//
+// Returns: Pointer to end of consumed input data
+const unsigned char * bitunpack128v32Scalar(const unsigned char * in, uint32_t * out, unsigned b)
+{
+    return unpack128v32_table[b](in, out);
 }
 
 } // namespace turbopfor::scalar::detail
@@ -27,9 +27,19 @@
 //     [0,8,16,24] [1,9,17,25] [2,10,18,26] ... [7,15,23,31]
 //
 // Total output size: (256 * b + 7) / 8 bytes
+//
+// Note on input access: the interleaving is purely an OUTPUT property. Group
+// g holds the eight CONSECUTIVE elements v[8g..8g+7], so a vector kernel
+// reads each group with one contiguous 32-byte load — no strided gather and
+// no 8x8 dword transpose is ever needed on the input side.
 
 #include "p4_scalar_internal.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    include <immintrin.h>
+#    define TURBOPFOR_BITPACK256V32_AVX2 1
+#endif
+
 namespace turbopfor::scalar::detail
 {
 
@@ -42,109 +52,155 @@ constexpr unsigned V256_GROUP_COUNT = 32;
 // Number of SIMD lanes (AVX2 = 256 bits = 8 x 32-bit)
 constexpr unsigned V256_LANE_COUNT = 8;
 
-// Pack 256 x 32-bit values using AVX2-compatible bitpacking format
-//
-// This matches the AVX2 implementation: processes 32 groups of 8 values,
-// packing b bits from each value horizontally, writing output when 32-bit
-// boundaries are crossed.
+// Lane-parameterized portable kernels shared by the v-format loops below.
 //
-// Parameters:
-//   in: Input array of 256 uint32_t values
-//   out: Output buffer (must have space for (256 * b + 7) / 8 bytes)
-//   b: Bit width (0-32)
-//
-// Returns: Pointer to end of packed data
-unsigned char * bitpack256v32Scalar(const uint32_t * in, unsigned char * out, unsigned b)
+// Every v-format block is GROUP_COUNT = 32 groups of LANES consecutive
+// elements (128v32 is 4 lanes, 256v32 is 8), and the packing rule per lane is
+// identical, so one template covers the family; LANES = 1 would even
+// degenerate to the plain horizontal bitstream. The horizontal packer keeps
+// its own 64-bit SWAR words regardless — the wire formats differ for
+// LANES > 1, and a one-lane 32-bit loop would halve its store width.
+template <unsigned LANES>
+static unsigned char * vpack32Portable(const uint32_t * in, unsigned char * out, unsigned b)
 {
-    // Special case: b=0 means all values are 0, no output needed
-    if (b == 0u)
-        return out;
-
-    // Special case: b=32 means no compression, copy with endian conversion
-    if (b == 32u)
-    {
-        copyU32ArrayToLe(out, in, V256_BLOCK_SIZE);
-        return out + V256_BLOCK_SIZE * sizeof(uint32_t);
-    }
-
-    const uint32_t mask = (1u << b) - 1u;
+    constexpr unsigned group_count = 32u;
+    const uint32_t mask = maskBits(b);
 
-    // Accumulator for 8 lanes, each lane accumulates bits until 32-bit boundary
-    uint32_t ov[V256_LANE_COUNT] = {0};
+    // 64-bit accumulator per lane: bits that spill past the 32-bit line ride
+    // in the high half, so every group is an unconditional shift-and-OR and
+    // the only control flow left is the flush on crossing a word boundary.
+    uint64_t ov[LANES] = {};
     unsigned shift = 0;
 
-    // Process 32 groups, each group has 8 values (one per lane)
-    for (unsigned g = 0; g < V256_GROUP_COUNT; ++g)
+    for (unsigned g = 0; g < group_count; ++g)
     {
-        // Read 8 values for this group (one per lane)
-        uint32_t iv[V256_LANE_COUNT];
-        for (unsigned lane = 0; lane < V256_LANE_COUNT; ++lane)
-        {
-            iv[lane] = in[g * V256_LANE_COUNT + lane] & mask;
-        }
-
-        // Pack bits into accumulator
-        if (shift == 0u)
-        {
-            // Start fresh accumulator
-            for (unsigned lane = 0; lane < V256_LANE_COUNT; ++lane)
-            {
-                ov[lane] = iv[lane];
-            }
-        }
-        else
+        for (unsigned lane = 0; lane < LANES; ++lane)
         {
-            // OR into existing accumulator with shift
-            for (unsigned lane = 0; lane < V256_LANE_COUNT; ++lane)
-            {
-                ov[lane] |= iv[lane] << shift;
-            }
+            ov[lane] |= static_cast<uint64_t>(in[g * LANES + lane] & mask) << shift;
         }
 
         shift += b;
 
-        // Check if we've filled 32 bits (need to write output)
+        // Filled 32 bits: write one line and drop to the spilled high half
         if (shift >= 32u)
         {
-            // Write 8 lanes (32 bytes)
-            for (unsigned lane = 0; lane < V256_LANE_COUNT; ++lane)
+            for (unsigned lane = 0; lane < LANES; ++lane)
             {
-                storeU32Fast(out, ov[lane]);
+                storeU32Fast(out, static_cast<uint32_t>(ov[lane]));
                 out += sizeof(uint32_t);
+                ov[lane] >>= 32u;
             }
 
             shift -= 32u;
+        }
+    }
 
-            if (shift > 0u)
-            {
-                // Carry over high bits that didn't fit
-                for (unsigned lane = 0; lane < V256_LANE_COUNT; ++lane)
-                {
-                    ov[lane] = iv[lane] >> (b - shift);
-                }
-            }
-            else
+    return out;
+}
+
+template <unsigned LANES>
+static const unsigned char * vunpack32Portable(const unsigned char * in, uint32_t * out, unsigned b)
+{
+    constexpr unsigned group_count = 32u;
+    const uint32_t mask = maskBits(b);
+
+    // 64-bit buffer per lane holding the unconsumed bits of up to two input
+    // words. Refilling only when fewer than b bits remain replaces the two
+    // nested carry branches with a single predictable one, and the refill
+    // count per lane is exactly b words, so the reads never pass the stream
+    // end even when the block drains at a word boundary.
+    uint64_t iv[LANES] = {};
+    unsigned avail = 0;
+
+    const unsigned char * inp = in;
+
+    for (unsigned g = 0; g < group_count; ++g)
+    {
+        if (avail < b)
+        {
+            for (unsigned lane = 0; lane < LANES; ++lane)
             {
-                // Reset accumulator
-                for (unsigned lane = 0; lane < V256_LANE_COUNT; ++lane)
-                {
-                    ov[lane] = 0;
-                }
+                iv[lane] |= static_cast<uint64_t>(loadU32Fast(inp)) << avail;
+                inp += sizeof(uint32_t);
             }
+            avail += 32u;
         }
+
+        for (unsigned lane = 0; lane < LANES; ++lane)
+        {
+            out[g * LANES + lane] = static_cast<uint32_t>(iv[lane]) & mask;
+            iv[lane] >>= b;
+        }
+
+        avail -= b;
     }
 
-    // Write any remaining bits
-    if (shift > 0u)
+    return in + (static_cast<size_t>(group_count) * LANES * b + 7u) / 8u;
+}
+
+// Fused variant of vunpack32Portable: groups hold consecutive elements, so
+// the delta1 prefix sum just walks the lanes in order and the deltas never
+// touch memory.
+template <unsigned LANES>
+static const unsigned char * vunpackd1_32Portable(const unsigned char * in, uint32_t * out, uint32_t start, unsigned b)
+{
+    constexpr unsigned group_count = 32u;
+    const uint32_t mask = maskBits(b);
+
+    uint64_t iv[LANES] = {};
+    unsigned avail = 0;
+    uint32_t acc = start;
+
+    const unsigned char * inp = in;
+
+    for (unsigned g = 0; g < group_count; ++g)
     {
-        for (unsigned lane = 0; lane < V256_LANE_COUNT; ++lane)
+        if (avail < b)
+        {
+            for (unsigned lane = 0; lane < LANES; ++lane)
+            {
+                iv[lane] |= static_cast<uint64_t>(loadU32Fast(inp)) << avail;
+                inp += sizeof(uint32_t);
+            }
+            avail += 32u;
+        }
+
+        for (unsigned lane = 0; lane < LANES; ++lane)
         {
-            storeU32Fast(out, ov[lane]);
-            out += sizeof(uint32_t);
+            acc += (static_cast<uint32_t>(iv[lane]) & mask) + 1u;
+            out[g * LANES + lane] = acc;
+            iv[lane] >>= b;
         }
+
+        avail -= b;
     }
 
-    return out;
+    return in + (static_cast<size_t>(group_count) * LANES * b + 7u) / 8u;
+}
+
+
+// Pack 256 x 32-bit values using AVX2-compatible bitpacking format
+//
+// This matches the AVX2 implementation: processes 32 groups of 8 values,
+// packing b bits from each value horizontally, writing output when 32-bit
+// boundaries are crossed.
+//
+// Parameters:
+//   in: Input array of 256 uint32_t values
+//   out: Output buffer (must have space for (256 * b + 7) / 8 bytes)
+//   b: Bit width (0-32)
+//
+// Returns: Pointer to end of packed data
+static unsigned char * bitpack256v32ScalarPortable(const uint32_t * in, unsigned char * out, unsigned b)
+{
+    // Special case: b=0 means all values are 0, no output needed
+    if (b == 0u)
+        return out;
+
+    // b=32 needs no special case: maskBits(32) is all ones and the lane
+    // accumulators flush every group, which writes the values in plain
+    // little-endian order.
+    return vpack32Portable<V256_LANE_COUNT>(in, out, b);
 }
 
 // Unpack 256 x 32-bit values from AVX2-compatible bitpacking format
@@ -155,7 +211,7 @@ unsigned char * bitpack256v32Scalar(const uint32_t * in, unsigned char * out, un
 //   b: Bit width (0-32)
 //
 // Returns: Pointer to end of consumed input data
-const unsigned char * bitunpack256v32Scalar(const unsigned char * in, uint32_t * out, unsigned b)
+static const unsigned char * bitunpack256v32ScalarPortable(const unsigned char * in, uint32_t * out, unsigned b)
 {
     // Special case: b=0 means all values are 0
     if (b == 0u)
@@ -164,70 +220,368 @@ const unsigned char * bitunpack256v32Scalar(const unsigned char * in, uint32_t *
         return in;
     }
 
-    // Special case: b=32 means no compression, copy with endian conversion
-    if (b == 32u)
+    // b=32 needs no special case: the refill fires every group and the full
+    // mask passes each word through unchanged.
+    return vunpack32Portable<V256_LANE_COUNT>(in, out, b);
+}
+
+// Fused unpack + delta1 decode: same bit extraction as the plain unpacker,
+// but the running prefix sum is applied before the deltas ever reach memory,
+// so the intermediate 1 KB of deltas is never written and re-read.
+//
+// Delta1 format: out[i] = sum(deltas[0..i]) + (i + 1) + start.
+static const unsigned char * bitunpackd1_256v32ScalarPortable(const unsigned char * in, uint32_t * out, uint32_t start, unsigned b)
+{
+    // Special case: b=0 means all deltas are 0
+    if (b == 0u)
     {
-        copyU32ArrayFromLe(out, in, V256_BLOCK_SIZE);
-        return in + V256_BLOCK_SIZE * sizeof(uint32_t);
+        for (unsigned i = 0; i < V256_BLOCK_SIZE; ++i)
+            out[i] = start + i + 1u;
+        return in;
     }
 
-    const uint32_t mask = (1u << b) - 1u;
+    // b=32 needs no special case (see bitunpack256v32ScalarPortable)
+    return vunpackd1_32Portable<V256_LANE_COUNT>(in, out, start, b);
+}
 
-    // Input value for 8 lanes
-    uint32_t iv[V256_LANE_COUNT] = {0};
-    unsigned shift = 0;
+// Pack nblocks consecutive 256-element blocks with one call
+//
+// The output is the plain concatenation of the per-block streams (each block
+// is a whole number of bytes), so this is byte-identical to calling the
+// single-block packer in a loop; the point is amortization: one dispatch and
+// one width-constant setup cover the whole run. The P4 encoders cannot use
+// it — they choose b per block — but fixed-width multi-block callers can.
+static unsigned char * bitpack256v32ScalarPortableN(const uint32_t * in, unsigned char * out, unsigned b, unsigned nblocks)
+{
+    if (b == 0u)
+        return out;
 
-    // Track position in input stream
-    const unsigned char * inp = in;
+    // vpack32Portable inlines here, so the mask setup is loop-invariant and
+    // hoisted out of the block loop.
+    for (unsigned k = 0; k < nblocks; ++k)
+    {
+        out = vpack32Portable<V256_LANE_COUNT>(in, out, b);
+        in += V256_BLOCK_SIZE;
+    }
+    return out;
+}
+
+#ifdef TURBOPFOR_BITPACK256V32_AVX2
+
+/// AVX2 packer body for b in [1, 32): the eight lanes of a group are exactly
+/// one __m256i, so the per-lane mask/shift/or loops collapse to single vector
+/// ops. The group-uniform shift count rides in the low qword of an XMM
+/// register (_mm256_sll_epi32 / _mm256_srl_epi32 take a variable count that
+/// way).
+///
+/// Aligned selects _mm256_store_si256 when the caller's buffer happens to be
+/// 32-byte aligned: every store advances by a full line, so alignment is a
+/// loop invariant, and on microarchitectures where the compiler splits
+/// unaligned 256-bit stores into halves (-mavx256-split-unaligned-store
+/// tuning) the aligned body keeps the full store width. A hard alignment
+/// contract is not possible here — the P4 header is 1-2 bytes, so payload
+/// output is almost never 32-byte aligned — hence the runtime pick.
+///
+/// Stream (implies Aligned) swaps in non-temporal stores for runs whose
+/// output exceeds the cache: compressed output is written once and read back
+/// much later, so letting it displace the input working set from L2 only
+/// hurts. Every store here fills a whole 32-byte line, the write-combining
+/// sweet spot. The caller fences once after the run, not per block.
+template <bool Aligned, bool Stream = false>
+__attribute__((target("avx2"))) static unsigned char * bitpack256v32Avx2Body(const uint32_t * __restrict in, unsigned char * __restrict out, unsigned b)
+{
+    const __m256i mask_vec = _mm256_set1_epi32(static_cast<int>(maskBits(b)));
+
+    if constexpr (Aligned)
+        out = static_cast<unsigned char *>(__builtin_assume_aligned(out, 32));
+
+    __m256i ov = _mm256_setzero_si256();
+    unsigned shift = 0;
 
-    // Process 32 groups, each group produces 8 output values
     for (unsigned g = 0; g < V256_GROUP_COUNT; ++g)
     {
-        // If shift is 0, we need to load new input
-        if (shift == 0u)
+        const __m256i iv = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + g * V256_LANE_COUNT)), mask_vec);
+
+        // No shift == 0 branch: the accumulator is all zeroes whenever shift
+        // is 0 (initially, and after a flush the carry srl by b clears the
+        // masked b-bit values), so the unconditional or-with-shift is exact.
+        ov = _mm256_or_si256(ov, _mm256_sll_epi32(iv, _mm_cvtsi32_si128(static_cast<int>(shift))));
+
+        shift += b;
+
+        if (shift >= 32u)
         {
-            for (unsigned lane = 0; lane < V256_LANE_COUNT; ++lane)
-            {
-                iv[lane] = loadU32Fast(inp);
-                inp += sizeof(uint32_t);
-            }
+            // 256 * b bits is always a whole number of 32-byte lines, so the
+            // full-width store never writes past the packed stream.
+            if constexpr (Stream)
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(out), ov);
+            else if constexpr (Aligned)
+                _mm256_store_si256(reinterpret_cast<__m256i *>(out), ov);
+            else
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), ov);
+            out += sizeof(__m256i);
+            shift -= 32u;
+            // When shift reaches 0 this shifts the b-bit values right by b,
+            // zeroing every lane, so no separate reset branch is needed.
+            ov = _mm256_srl_epi32(iv, _mm_cvtsi32_si128(static_cast<int>(b - shift)));
         }
+    }
+
+    // 32 groups x b bits is a whole number of 32-bit words per lane, so the
+    // final crossing above always drains the accumulator; no tail flush.
+    return out;
+}
+
+__attribute__((target("avx2"))) static unsigned char * bitpack256v32Avx2(const uint32_t * __restrict in, unsigned char * __restrict out, unsigned b)
+{
+    if ((reinterpret_cast<uintptr_t>(out) & 31u) == 0u)
+        return bitpack256v32Avx2Body<true>(in, out, b);
+    return bitpack256v32Avx2Body<false>(in, out, b);
+}
+
+/// AVX2 unpacker for b in [1, 32): one 32-byte load per filled input line,
+/// then a group-uniform right shift + mask per group. All lanes share one
+/// shift count, so the cheap _mm256_srl_epi32 suffices (no vpsrlvd needed).
+///
+/// The loop is skewed by one input line: the block is exactly b 32-byte
+/// lines, iv holds the line being extracted and nv the following one, so
+/// every line's load issues several groups before its first use and the L1
+/// load-use latency overlaps the previous line's shift/mask chain instead of
+/// heading each group's dependency chain.
+__attribute__((target("avx2"))) static const unsigned char * bitunpack256v32Avx2(const unsigned char * __restrict in, uint32_t * __restrict out, unsigned b)
+{
+    const __m256i mask_vec = _mm256_set1_epi32(static_cast<int>(maskBits(b)));
+
+    __m256i iv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+    __m256i nv = _mm256_setzero_si256();
+    unsigned next = 1;
+    if (next < b)
+        nv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + next * sizeof(__m256i)));
+
+    unsigned shift = 0;
+
+    for (unsigned g = 0; g < V256_GROUP_COUNT; ++g)
+    {
+        __m256i ov = _mm256_and_si256(_mm256_srl_epi32(iv, _mm_cvtsi32_si128(static_cast<int>(shift))), mask_vec);
+
+        shift += b;
 
-        // Extract b bits for each lane
-        uint32_t ov[V256_LANE_COUNT];
-        for (unsigned lane = 0; lane < V256_LANE_COUNT; ++lane)
+        if (shift >= 32u)
         {
-            ov[lane] = (iv[lane] >> shift) & mask;
+            shift -= 32u;
+            // Advance to the preloaded line and start its successor's load;
+            // the final advance leaves nv untouched (next == b) and hands out
+            // a dead iv that no group reads.
+            iv = nv;
+            ++next;
+            if (next < b)
+                nv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + next * sizeof(__m256i)));
+            if (shift > 0u)
+                ov = _mm256_or_si256(ov, _mm256_and_si256(_mm256_sll_epi32(iv, _mm_cvtsi32_si128(static_cast<int>(b - shift))), mask_vec));
         }
 
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + g * V256_LANE_COUNT), ov);
+    }
+
+    return in + (V256_BLOCK_SIZE * b) / 8u;
+}
+
+/// Fused AVX2 unpack + delta1 for b in [1, 32): extraction as in the plain
+/// AVX2 unpacker, then the serial add chain is replaced by the in-register
+/// shift-add tree (slli 4 / slli 8 / broadcast of lane 3 into the high half)
+/// before the single store per group — the deltas never touch memory.
+__attribute__((target("avx2"))) static const unsigned char *
+bitunpackd1_256v32Avx2(const unsigned char * __restrict in, uint32_t * __restrict out, uint32_t start, unsigned b)
+{
+    const __m256i mask_vec = _mm256_set1_epi32(static_cast<int>(maskBits(b)));
+    const __m256i idx_vec = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8);
+    const __m256i bcast3 = _mm256_setr_epi32(3, 3, 3, 3, 3, 3, 3, 3);
+
+    // Skewed by one input line like the plain unpacker above; the prefix-sum
+    // tree below gives each line's load even more work to hide behind.
+    __m256i iv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+    __m256i nv = _mm256_setzero_si256();
+    unsigned next = 1;
+    if (next < b)
+        nv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + next * sizeof(__m256i)));
+
+    unsigned shift = 0;
+
+    // Running value folding the +index term, matching the scalar convention
+    // where the continuation start absorbs the element count so far.
+    uint32_t sv = start;
+
+    for (unsigned g = 0; g < V256_GROUP_COUNT; ++g)
+    {
+        __m256i ov = _mm256_and_si256(_mm256_srl_epi32(iv, _mm_cvtsi32_si128(static_cast<int>(shift))), mask_vec);
+
         shift += b;
 
-        // Check if we need more bits from next input word
         if (shift >= 32u)
         {
             shift -= 32u;
-
+            iv = nv;
+            ++next;
+            if (next < b)
+                nv = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + next * sizeof(__m256i)));
             if (shift > 0u)
+                ov = _mm256_or_si256(ov, _mm256_and_si256(_mm256_sll_epi32(iv, _mm_cvtsi32_si128(static_cast<int>(b - shift))), mask_vec));
+        }
+
+        // Hillis-Steele prefix sum within halves, then bridge the halves by
+        // adding the low half's total into every high lane.
+        ov = _mm256_add_epi32(ov, _mm256_slli_si256(ov, 4));
+        ov = _mm256_add_epi32(ov, _mm256_slli_si256(ov, 8));
+        const __m256i low_total = _mm256_permutevar8x32_epi32(ov, bcast3);
+        ov = _mm256_add_epi32(ov, _mm256_blend_epi32(_mm256_setzero_si256(), low_total, 0xF0));
+
+        const __m256i res = _mm256_add_epi32(_mm256_add_epi32(ov, _mm256_set1_epi32(static_cast<int>(sv))), idx_vec);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + g * V256_LANE_COUNT), res);
+
+        sv = static_cast<uint32_t>(_mm256_extract_epi32(res, 7));
+    }
+
+    return in + (V256_BLOCK_SIZE * b) / 8u;
+}
+
+/// Batched AVX2 packer: one mask broadcast and one alignment check for the
+/// whole run. Every block is a whole number of 32-byte lines, so the
+/// alignment of out is invariant across blocks and the aligned-store body
+/// can be picked once up front.
+__attribute__((target("avx2"))) static unsigned char * bitpack256v32Avx2N(const uint32_t * in, unsigned char * out, unsigned b, unsigned nblocks)
+{
+    // Past this much output the stream cannot stay resident anyway; switch
+    // the aligned body to non-temporal stores so the once-written compressed
+    // bytes stop evicting the input working set (roughly an L2's worth).
+    constexpr size_t NT_STORE_MIN_BYTES = 1u << 20;
+
+    if ((reinterpret_cast<uintptr_t>(out) & 31u) == 0u)
+    {
+        if (static_cast<size_t>(nblocks) * V256_BLOCK_SIZE * b / 8u >= NT_STORE_MIN_BYTES)
+        {
+            for (unsigned k = 0; k < nblocks; ++k)
             {
-                // Load next input words and get remaining high bits
-                for (unsigned lane = 0; lane < V256_LANE_COUNT; ++lane)
-                {
-                    iv[lane] = loadU32Fast(inp);
-                    inp += sizeof(uint32_t);
-                    // OR in high bits from new word
-                    ov[lane] |= (iv[lane] << (b - shift)) & mask;
-                }
+                out = bitpack256v32Avx2Body<true, true>(in, out, b);
+                in += V256_BLOCK_SIZE;
             }
+            // One fence for the whole run: make the WC buffers globally
+            // visible before the caller hands the stream to another thread.
+            _mm_sfence();
+            return out;
         }
-
-        // Store 8 output values
-        for (unsigned lane = 0; lane < V256_LANE_COUNT; ++lane)
+        for (unsigned k = 0; k < nblocks; ++k)
+        {
+            out = bitpack256v32Avx2Body<true>(in, out, b);
+            in += V256_BLOCK_SIZE;
+        }
+    }
+    else
+    {
+        for (unsigned k = 0; k < nblocks; ++k)
         {
-            out[g * V256_LANE_COUNT + lane] = ov[lane];
+            out = bitpack256v32Avx2Body<false>(in, out, b);
+            in += V256_BLOCK_SIZE;
         }
     }
+    return out;
+}
+
+#endif
+
+#if defined(TURBOPFOR_BITPACK256V32_AVX2) && defined(__ELF__)
+
+static unsigned char * bitpack256v32ScalarAvx2Entry(const uint32_t * in, unsigned char * out, unsigned b)
+{
+    if (b >= 1u && b < 32u)
+        return bitpack256v32Avx2(in, out, b);
+    return bitpack256v32ScalarPortable(in, out, b);
+}
+
+static const unsigned char * bitunpack256v32ScalarAvx2Entry(const unsigned char * in, uint32_t * out, unsigned b)
+{
+    if (b >= 1u && b < 32u)
+        return bitunpack256v32Avx2(in, out, b);
+    return bitunpack256v32ScalarPortable(in, out, b);
+}
+
+static const unsigned char * bitunpackd1_256v32ScalarAvx2Entry(const unsigned char * in, uint32_t * out, uint32_t start, unsigned b)
+{
+    if (b >= 1u && b < 32u)
+        return bitunpackd1_256v32Avx2(in, out, start, b);
+    return bitunpackd1_256v32ScalarPortable(in, out, start, b);
+}
+
+static unsigned char * bitpack256v32ScalarNAvx2Entry(const uint32_t * in, unsigned char * out, unsigned b, unsigned nblocks)
+{
+    if (b >= 1u && b < 32u)
+        return bitpack256v32Avx2N(in, out, b, nblocks);
+    return bitpack256v32ScalarPortableN(in, out, b, nblocks);
+}
+
+// IFUNC resolvers: the loader picks the variant once at startup, so the
+// per-call CPUID check and branch disappear from the entry points entirely.
+extern "C" void * turbopforResolveBitpack256v32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&bitpack256v32ScalarAvx2Entry);
+    return reinterpret_cast<void *>(&bitpack256v32ScalarPortable);
+}
+
+extern "C" void * turbopforResolveBitunpack256v32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&bitunpack256v32ScalarAvx2Entry);
+    return reinterpret_cast<void *>(&bitunpack256v32ScalarPortable);
+}
+
+extern "C" void * turbopforResolveBitunpackd1_256v32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&bitunpackd1_256v32ScalarAvx2Entry);
+    return reinterpret_cast<void *>(&bitunpackd1_256v32ScalarPortable);
+}
 
-    return in + (V256_BLOCK_SIZE * b + 7u) / 8u;
+extern "C" void * turbopforResolveBitpack256v32N()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&bitpack256v32ScalarNAvx2Entry);
+    return reinterpret_cast<void *>(&bitpack256v32ScalarPortableN);
 }
 
+unsigned char * bitpack256v32Scalar(const uint32_t * in, unsigned char * out, unsigned b) __attribute__((ifunc("turbopforResolveBitpack256v32")));
+const unsigned char * bitunpack256v32Scalar(const unsigned char * in, uint32_t * out, unsigned b)
+    __attribute__((ifunc("turbopforResolveBitunpack256v32")));
+const unsigned char * bitunpackd1_256v32Scalar(const unsigned char * in, uint32_t * out, uint32_t start, unsigned b)
+    __attribute__((ifunc("turbopforResolveBitunpackd1_256v32")));
+unsigned char * bitpack256v32ScalarN(const uint32_t * in, unsigned char * out, unsigned b, unsigned nblocks)
+    __attribute__((ifunc("turbopforResolveBitpack256v32N")));
+
+#else
+
+unsigned char * bitpack256v32Scalar(const uint32_t * in, unsigned char * out, unsigned b)
+{
+    return bitpack256v32ScalarPortable(in, out, b);
+}
+
+const unsigned char * bitunpack256v32Scalar(const unsigned char * in, uint32_t * out, unsigned b)
+{
+    return bitunpack256v32ScalarPortable(in, out, b);
+}
+
+const unsigned char * bitunpackd1_256v32Scalar(const unsigned char * in, uint32_t * out, uint32_t start, unsigned b)
+{
+    return bitunpackd1_256v32ScalarPortable(in, out, start, b);
+}
+
+unsigned char * bitpack256v32ScalarN(const uint32_t * in, unsigned char * out, unsigned b, unsigned nblocks)
+{
+    return bitpack256v32ScalarPortableN(in, out, b, nblocks);
+}
+
+#endif
+
 } // namespace turbopfor::scalar::detail
@@ -10,6 +10,25 @@ unsigned char * p4D1Enc32(uint32_t * in, unsigned n, unsigned char * out, uint32
 const unsigned char * p4Dec32(const unsigned char * in, unsigned n, uint32_t * out);
 const unsigned char * p4D1Dec32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start);
 
+// Fixed-length variants: the block length is a template parameter, so the
+// per-element loops compile with constant trip counts. Instantiated for the
+// block sizes callers typically pin (16, 32, 64, 128, 256).
+template <unsigned N>
+unsigned char * p4Enc32Fixed(uint32_t * in, unsigned char * out);
+template <unsigned N>
+const unsigned char * p4D1Dec32Fixed(const unsigned char * in, uint32_t * out, uint32_t start);
+
+extern template unsigned char * p4Enc32Fixed<16u>(uint32_t *, unsigned char *);
+extern template unsigned char * p4Enc32Fixed<32u>(uint32_t *, unsigned char *);
+extern template unsigned char * p4Enc32Fixed<64u>(uint32_t *, unsigned char *);
+extern template unsigned char * p4Enc32Fixed<128u>(uint32_t *, unsigned char *);
+extern template unsigned char * p4Enc32Fixed<256u>(uint32_t *, unsigned char *);
+extern template const unsigned char * p4D1Dec32Fixed<16u>(const unsigned char *, uint32_t *, uint32_t);
+extern template const unsigned char * p4D1Dec32Fixed<32u>(const unsigned char *, uint32_t *, uint32_t);
+extern template const unsigned char * p4D1Dec32Fixed<64u>(const unsigned char *, uint32_t *, uint32_t);
+extern template const unsigned char * p4D1Dec32Fixed<128u>(const unsigned char *, uint32_t *, uint32_t);
+extern template const unsigned char * p4D1Dec32Fixed<256u>(const unsigned char *, uint32_t *, uint32_t);
+
 unsigned char * p4Enc128v32(uint32_t * in, unsigned n, unsigned char * out);
 unsigned char * p4D1Enc128v32(uint32_t * in, unsigned n, unsigned char * out, uint32_t start);
 const unsigned char * p4Dec128v32(const unsigned char * in, unsigned n, uint32_t * out);
@@ -20,6 +39,11 @@ unsigned char * p4D1Enc256v32(uint32_t * in, unsigned n, unsigned char * out, ui
 const unsigned char * p4Dec256v32(const unsigned char * in, unsigned n, uint32_t * out);
 const unsigned char * p4D1Dec256v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start);
 
+// Stream-VByte codec (control bytes separated from data bytes); see
+// streamvbyte32.cpp for the wire format. Not related to the P4 stream.
+unsigned char * streamVByteEnc32(const uint32_t * in, unsigned n, unsigned char * out);
+const unsigned char * streamVByteDec32(const unsigned char * in, unsigned n, uint32_t * out);
+
 unsigned char * p4Enc64(uint64_t * in, unsigned n, unsigned char * out);
 unsigned char * p4D1Enc64(uint64_t * in, unsigned n, unsigned char * out, uint64_t start);
 const unsigned char * p4Dec64(const unsigned char * in, unsigned n, uint64_t * out);
@@ -1,11 +1,115 @@
 #include "p4_scalar_bitpack_impl.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    include <immintrin.h>
+#    define TURBOPFOR_BITPACK32_AVX2 1
+#endif
+
 namespace turbopfor::scalar::detail
 {
 
-unsigned char * bitpack32Scalar(const uint32_t * in, unsigned n, unsigned char * out, unsigned b)
+#ifdef TURBOPFOR_BITPACK32_AVX2
+
+/// AVX2 packer for b < 16: consumes 8 uint32 lanes per iteration.
+/// 8 values of b bits always occupy exactly b bytes, so every group starts on a
+/// byte boundary and the output stays bit-identical to the scalar packer.
+///
+/// The merge runs as a log-tree inside YMM registers:
+///   pairs:  p[i] = v[2i] | v[2i+1] << b      (64-bit lanes, 2b <= 30 bits)
+///   quads:  q[i] = p[2i] | p[2i+1] << 2b     (per 128-bit half, 4b <= 60 bits)
+///   octet:  q[0] | q[1] << 4b                (scalar 128-bit merge)
+/// Requires values to fit in b bits (same contract as the scalar packer).
+__attribute__((target("avx2"))) static unsigned char *
+bitpack32Avx2(const uint32_t * __restrict in, unsigned n, unsigned char * __restrict out, unsigned b)
+{
+    const __m256i lo32_mask = _mm256_set1_epi64x(0xFFFFFFFFll);
+    const __m256i quad_shift = _mm256_set_epi64x(2 * b, 0, 2 * b, 0);
+
+    unsigned char * op = out;
+    unsigned groups = n / 8u;
+    // The wide stores write junk bytes past the group; that is only safe
+    // while enough output remains for later stores to cover them, so the
+    // guards below track the bytes still to be written (tail included).
+    size_t room = (static_cast<size_t>(n) * b + 7u) / 8u;
+    while (groups--)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in));
+        // v[2i] sits in the low half of each 64-bit lane, v[2i+1] in the high half.
+        // Shifting the whole lane right by (32 - b) lands v[2i+1] at bit b.
+        const __m256i pair = _mm256_or_si256(_mm256_and_si256(v, lo32_mask), _mm256_srli_epi64(v, 32 - b));
+        const __m256i shifted = _mm256_sllv_epi64(pair, quad_shift);
+        const __m256i quad = _mm256_or_si256(shifted, _mm256_bsrli_epi128(shifted, 8));
+
+        const uint64_t q0 = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm256_castsi256_si128(quad)));
+        const uint64_t q1 = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm256_extracti128_si256(quad, 1)));
+
+        if (b <= 8u)
+        {
+            const uint64_t octet = q0 | (q1 << (4u * b));
+            if (room >= 8u)
+                storeU64Fast(op, octet); // junk tail bytes, covered by the next stores
+            else
+                memcpy(op, &octet, b); // exact store: no bytes past the stream end
+        }
+        else
+        {
+            const uint64_t lo = q0 | (q1 << (4u * b));
+            const uint64_t hi = q1 >> (64u - 4u * b);
+            storeU64Fast(op, lo); // b >= 9 bytes remain, always in bounds
+            if (room >= 16u)
+                storeU64Fast(op + 8u, hi);
+            else
+                memcpy(op + 8u, &hi, b - 8u);
+        }
+        op += b;
+        in += 8u;
+        room -= b;
+    }
+
+    n &= 7u;
+    if (n == 0u)
+        return op;
+    return Bitpack32ScalarImpl::hot_table[b - 1u](in, n, op); // b < 16 on this path
+}
+
+#endif
+
+static unsigned char * bitpack32ScalarPortable(const uint32_t * in, unsigned n, unsigned char * out, unsigned b)
 {
     return Bitpack32ScalarImpl::dispatch(in, n, out, b);
 }
 
+#if defined(TURBOPFOR_BITPACK32_AVX2) && defined(__ELF__)
+
+static unsigned char * bitpack32ScalarAvx2Entry(const uint32_t * in, unsigned n, unsigned char * out, unsigned b)
+{
+    // For b >= 16 the scalar SWAR packer already runs at store bandwidth,
+    // so the wide path is only worth it for narrow widths.
+    if (b >= 1u && b < 16u && n >= 8u)
+        return bitpack32Avx2(in, n, out, b);
+    return Bitpack32ScalarImpl::dispatch(in, n, out, b);
+}
+
+// IFUNC resolver: the loader picks the variant once at startup, so the
+// per-call CPUID check and branch disappear from the entry point entirely.
+extern "C" void * turbopforResolveBitpack32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&bitpack32ScalarAvx2Entry);
+    return reinterpret_cast<void *>(&bitpack32ScalarPortable);
+}
+
+unsigned char * bitpack32Scalar(const uint32_t * in, unsigned n, unsigned char * out, unsigned b)
+    __attribute__((ifunc("turbopforResolveBitpack32")));
+
+#else
+
+unsigned char * bitpack32Scalar(const uint32_t * in, unsigned n, unsigned char * out, unsigned b)
+{
+    return bitpack32ScalarPortable(in, n, out, b);
+}
+
+#endif
+
 } // namespace turbopfor::scalar::detail
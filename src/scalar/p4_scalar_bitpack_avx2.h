@@ -0,0 +1,76 @@
+#pragma once
+
+#include "p4_scalar_internal.h"
+
+#if defined(__x86_64__) && defined(__AVX2__)
+
+#    include <immintrin.h>
+
+#    define TURBOPFOR_SCALAR_PACK_AVX2 1
+
+#    include <cstring>
+
+namespace turbopfor::scalar::detail
+{
+
+/// Compile-time-B AVX2 packer for one 32-element block (B < 16, B != 8).
+/// 8 values of B bits occupy exactly B bytes, so each of the four groups
+/// starts on a byte boundary and the output stays bit-identical to the SWAR
+/// word packer. The merge is the same log-tree the runtime AVX2 kernel runs,
+/// but with B folded into immediates:
+///   pairs:  p[i] = v[2i] | v[2i+1] << B      (64-bit lanes, 2B <= 30 bits)
+///   quads:  q[i] = p[2i] | p[2i+1] << 2B     (per 128-bit half, 4B <= 60 bits)
+///   octet:  q[0] | q[1] << 4B                (scalar 128-bit merge)
+/// Requires values to fit in B bits (same contract as the scalar packer).
+///
+/// `room` is the number of output bytes the whole stream still has to write
+/// from `out`, tail included: the wide group stores spill junk bytes past the
+/// group and are only used while enough later stores remain to cover them.
+template <unsigned B>
+static TURBOPFOR_ALWAYS_INLINE unsigned char * pack32Avx2(const uint32_t * __restrict in, unsigned char * __restrict out, size_t room)
+{
+    static_assert(B >= 1u && B < 16u && B != 8u);
+
+    const __m256i lo32_mask = _mm256_set1_epi64x(0xFFFFFFFFll);
+    const __m256i quad_shift = _mm256_set_epi64x(2 * B, 0, 2 * B, 0);
+
+    for (unsigned g = 0; g < 4u; ++g)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + g * 8u));
+        // v[2i] sits in the low half of each 64-bit lane, v[2i+1] in the high half.
+        // Shifting the whole lane right by (32 - B) lands v[2i+1] at bit B.
+        const __m256i pair = _mm256_or_si256(_mm256_and_si256(v, lo32_mask), _mm256_srli_epi64(v, 32 - B));
+        const __m256i shifted = _mm256_sllv_epi64(pair, quad_shift);
+        const __m256i quad = _mm256_or_si256(shifted, _mm256_bsrli_epi128(shifted, 8));
+
+        const uint64_t q0 = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm256_castsi256_si128(quad)));
+        const uint64_t q1 = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm256_extracti128_si256(quad, 1)));
+
+        if constexpr (B < 8u)
+        {
+            const uint64_t octet = q0 | (q1 << (4u * B));
+            if (room >= 8u)
+                storeU64Fast(out, octet); // junk tail bytes, covered by the next stores
+            else
+                std::memcpy(out, &octet, B); // exact store: no bytes past the stream end
+        }
+        else
+        {
+            const uint64_t lo = q0 | (q1 << (4u * B));
+            const uint64_t hi = q1 >> (64u - 4u * B);
+            storeU64Fast(out, lo); // B >= 9 bytes remain, always in bounds
+            if (room >= 16u)
+                storeU64Fast(out + 8u, hi);
+            else
+                std::memcpy(out + 8u, &hi, B - 8u);
+        }
+        out += B;
+        room -= B;
+    }
+
+    return out;
+}
+
+} // namespace turbopfor::scalar::detail
+
+#endif
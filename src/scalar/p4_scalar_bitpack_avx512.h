@@ -0,0 +1,44 @@
+#pragma once
+
+#include "p4_scalar_internal.h"
+
+// VPCOMPRESSB is VBMI2, but the 64-bit byte masks need BW as well
+#if defined(__x86_64__) && defined(__AVX512VBMI2__) && defined(__AVX512BW__)
+
+#    include <immintrin.h>
+
+#    define TURBOPFOR_SCALAR_PACK_AVX512VBMI2 1
+
+namespace turbopfor::scalar::detail
+{
+
+/// AVX-512 VBMI2 packer for one 32-element block at byte-multiple widths
+/// (B in {8, 16, 24}). At these widths a field is exactly the low B/8 bytes
+/// of its little-endian dword, so VPCOMPRESSB with a per-dword byte mask
+/// packs a whole ZMM register (16 values) contiguously in one instruction —
+/// the entire shift/OR chain of the word packer collapses into two
+/// compress stores per block. The store is masked, so it writes exactly
+/// 16 * B/8 bytes and never touches memory past the stream end.
+template <unsigned B>
+static TURBOPFOR_ALWAYS_INLINE unsigned char * pack32Avx512Vbmi2(const uint32_t * __restrict in, unsigned char * __restrict out)
+{
+    static_assert(B == 8u || B == 16u || B == 24u);
+
+    constexpr unsigned bytes_per_field = B / 8u;
+    // Replicate the per-dword byte selection across all 16 dword lanes:
+    // 0x1111... for B=8, 0x3333... for B=16, 0x7777... for B=24.
+    constexpr uint64_t compress_mask = (~0ull / 15ull) * ((1ull << bytes_per_field) - 1ull);
+
+    for (unsigned half = 0; half < 2u; ++half)
+    {
+        const __m512i v = _mm512_loadu_si512(reinterpret_cast<const void *>(in + half * 16u));
+        _mm512_mask_compressstoreu_epi8(out, static_cast<__mmask64>(compress_mask), v);
+        out += 16u * bytes_per_field;
+    }
+
+    return out;
+}
+
+} // namespace turbopfor::scalar::detail
+
+#endif
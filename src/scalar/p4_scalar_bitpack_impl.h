@@ -1,9 +1,16 @@
 #pragma once
 
+#include "p4_scalar_bitpack_avx2.h"
+#include "p4_scalar_bitpack_avx512.h"
 #include "p4_scalar_internal.h"
 
 #include <utility>
 
+#if defined(__x86_64__) && defined(__BMI2__) && defined(__SSE4_1__)
+#    include <immintrin.h>
+#    define TURBOPFOR_SCALAR_BMI2 1
+#endif
+
 namespace turbopfor::scalar::detail
 {
 
@@ -36,6 +43,7 @@ static TURBOPFOR_ALWAYS_INLINE unsigned char * pack_block(const uint32_t * __res
     constexpr unsigned total_bytes = (total_bits + 7u) / 8u;
     constexpr unsigned word_count = (total_bits + 63u) / 64u;
     constexpr unsigned last_bytes = total_bytes - (word_count - 1u) * 8u;
+    static_assert(last_bytes >= 1u && last_bytes <= 8u);
 
     uint64_t w[word_count] = {};
     pack_all<B, Base>(in, w, std::make_index_sequence<K>{});
@@ -79,21 +87,36 @@ static TURBOPFOR_ALWAYS_INLINE unsigned char * pack_blocks(const uint32_t * __re
     }
 }
 
-// Pack N elements with bit width B (N is compile-time constant)
+// Per-(B, N) packer selected by partial specialization rather than an
+// if constexpr ladder inside one body: each instantiation is exactly its own
+// code with nothing discarded, which keeps the generated (and debug-info)
+// shape of every specialization minimal. The byte-aligned widths keep their
+// dedicated store loops.
 template <unsigned B, unsigned N>
-static TURBOPFOR_ALWAYS_INLINE unsigned char * pack_n_b(const uint32_t * __restrict in, unsigned char * __restrict out)
+struct PackNB
 {
-    static_assert(B >= 1 && B <= 32);
-    static_assert(N >= 1 && N <= 32);
+    static TURBOPFOR_ALWAYS_INLINE unsigned char * run(const uint32_t * __restrict in, unsigned char * __restrict out)
+    {
+        return pack_blocks<B, N, 0u>(in, out);
+    }
+};
 
-    // Special case: b=32 - copy with endian conversion
-    if constexpr (B == 32)
+// B=32: copy with endian conversion
+template <unsigned N>
+struct PackNB<32u, N>
+{
+    static TURBOPFOR_ALWAYS_INLINE unsigned char * run(const uint32_t * __restrict in, unsigned char * __restrict out)
     {
         copyU32ArrayToLe(out, in, N);
         return out + N * 4u;
     }
-    // Special case: b=16 - simple 16-bit stores
-    else if constexpr (B == 16)
+};
+
+// B=16: simple 16-bit stores
+template <unsigned N>
+struct PackNB<16u, N>
+{
+    static TURBOPFOR_ALWAYS_INLINE unsigned char * run(const uint32_t * __restrict in, unsigned char * __restrict out)
     {
         unsigned char * op = out;
         for (unsigned i = 0; i < N; ++i)
@@ -103,91 +126,66 @@ static TURBOPFOR_ALWAYS_INLINE unsigned char * pack_n_b(const uint32_t * __restr
         }
         return op;
     }
-    // Special case: b=8 - byte stores
-    else if constexpr (B == 8)
+};
+
+// B=8: byte stores
+template <unsigned N>
+struct PackNB<8u, N>
+{
+    static TURBOPFOR_ALWAYS_INLINE unsigned char * run(const uint32_t * __restrict in, unsigned char * __restrict out)
     {
         unsigned char * op = out;
         for (unsigned i = 0; i < N; ++i)
             *op++ = static_cast<unsigned char>(in[i]);
         return op;
     }
-    else
-    {
-        return pack_blocks<B, N, 0u>(in, out);
-    }
+};
+
+// Pack N elements with bit width B (N is compile-time constant)
+template <unsigned B, unsigned N>
+static TURBOPFOR_ALWAYS_INLINE unsigned char * pack_n_b(const uint32_t * __restrict in, unsigned char * __restrict out)
+{
+    static_assert(B >= 1 && B <= 32);
+    static_assert(N >= 1 && N <= 32);
+
+    return PackNB<B, N>::run(in, out);
 }
 
-// Dispatch on runtime n (1-31) to compile-time N
+// Pack a short tail of n (1-31) values with one runtime-n body.
+//
+// This used to dispatch n to 31 fully inlined pack_n_b instantiations, which
+// cost roughly 31 function-sized bodies per bit width in icache for a path
+// that runs once per stream end. The single 64-bit accumulator loop below
+// emits byte-identical output: choose_block_size only ever splits at
+// byte-aligned element boundaries, so the tail layout is a plain continuous
+// little-endian bitstream with zeroed padding bits in the final byte.
 template <unsigned B>
 static TURBOPFOR_ALWAYS_INLINE unsigned char * pack_dispatch_n(const uint32_t * in, unsigned n, unsigned char * out)
 {
-    switch (n)
+    uint64_t acc = 0;
+    unsigned bits = 0;
+    for (unsigned i = 0; i < n; ++i)
+    {
+        const uint64_t v = in[i];
+        acc |= v << bits;
+        bits += B;
+        if (bits >= 64u)
+        {
+            storeU64Fast(out, acc);
+            out += sizeof(uint64_t);
+            bits -= 64u;
+            acc = (bits != 0u) ? (v >> (B - bits)) : 0u;
+        }
+    }
+
+    // At most 7 trailing bytes; emitted one at a time, which stays
+    // endian-correct and exact (no bytes past the stream end).
+    for (unsigned rem = (bits + 7u) / 8u; rem != 0u; --rem)
     {
-        case 1u:
-            return pack_n_b<B, 1>(in, out);
-        case 2u:
-            return pack_n_b<B, 2>(in, out);
-        case 3u:
-            return pack_n_b<B, 3>(in, out);
-        case 4u:
-            return pack_n_b<B, 4>(in, out);
-        case 5u:
-            return pack_n_b<B, 5>(in, out);
-        case 6u:
-            return pack_n_b<B, 6>(in, out);
-        case 7u:
-            return pack_n_b<B, 7>(in, out);
-        case 8u:
-            return pack_n_b<B, 8>(in, out);
-        case 9u:
-            return pack_n_b<B, 9>(in, out);
-        case 10u:
-            return pack_n_b<B, 10>(in, out);
-        case 11u:
-            return pack_n_b<B, 11>(in, out);
-        case 12u:
-            return pack_n_b<B, 12>(in, out);
-        case 13u:
-            return pack_n_b<B, 13>(in, out);
-        case 14u:
-            return pack_n_b<B, 14>(in, out);
-        case 15u:
-            return pack_n_b<B, 15>(in, out);
-        case 16u:
-            return pack_n_b<B, 16>(in, out);
-        case 17u:
-            return pack_n_b<B, 17>(in, out);
-        case 18u:
-            return pack_n_b<B, 18>(in, out);
-        case 19u:
-            return pack_n_b<B, 19>(in, out);
-        case 20u:
-            return pack_n_b<B, 20>(in, out);
-        case 21u:
-            return pack_n_b<B, 21>(in, out);
-        case 22u:
-            return pack_n_b<B, 22>(in, out);
-        case 23u:
-            return pack_n_b<B, 23>(in, out);
-        case 24u:
-            return pack_n_b<B, 24>(in, out);
-        case 25u:
-            return pack_n_b<B, 25>(in, out);
-        case 26u:
-            return pack_n_b<B, 26>(in, out);
-        case 27u:
-            return pack_n_b<B, 27>(in, out);
-        case 28u:
-            return pack_n_b<B, 28>(in, out);
-        case 29u:
-            return pack_n_b<B, 29>(in, out);
-        case 30u:
-            return pack_n_b<B, 30>(in, out);
-        case 31u:
-            return pack_n_b<B, 31>(in, out);
-        default:
-            __builtin_unreachable();
+        *out++ = static_cast<unsigned char>(acc);
+        acc >>= 8u;
     }
+    return out;
 }
 
 // Main bitpack implementation struct with function table
@@ -198,6 +196,82 @@ struct Bitpack32ScalarImpl
     template <unsigned B>
     static TURBOPFOR_ALWAYS_INLINE unsigned char * bitpack_b(const uint32_t * in, unsigned n, unsigned char * out)
     {
+#ifdef TURBOPFOR_SCALAR_BMI2
+        // For B < 8 a group of 8 fields spans exactly B bytes, so one PEXT
+        // compresses a whole group: narrow the 8 values to one byte each
+        // (exact, the packer contract says they fit in B bits), then extract
+        // the low B bits of every byte into 8*B contiguous bits.
+        if constexpr (B < 8u)
+        {
+            constexpr uint64_t field_mask = (~0ull / 255ull) * ((1ull << B) - 1ull);
+            unsigned groups = n / 8u;
+            const unsigned tail = n & 7u;
+            // The wide store writes 8 - B junk bytes past the group; that is
+            // only safe while at least 8 output bytes remain to be written,
+            // so later stores are guaranteed to cover them. Near the stream
+            // end the groups fall back to exact B-byte stores.
+            size_t room = (static_cast<size_t>(n) * B + 7u) / 8u;
+            while (groups != 0u)
+            {
+                const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+                const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 4u));
+                const uint64_t bytes
+                    = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_packus_epi16(_mm_packus_epi32(lo, hi), _mm_setzero_si128())));
+                const uint64_t packed = _pext_u64(bytes, field_mask);
+                if (room >= 8u)
+                    storeU64Fast(out, packed); // junk tail bytes, covered by the next stores
+                else
+                    std::memcpy(out, &packed, B); // exact store: no bytes past the stream end
+                out += B;
+                in += 8u;
+                room -= B;
+                --groups;
+            }
+            if (tail == 0u)
+                return out;
+            return pack_dispatch_n<B>(in, tail, out);
+        }
+#endif
+#ifdef TURBOPFOR_SCALAR_PACK_AVX512VBMI2
+        // Byte-multiple widths: VPCOMPRESSB packs 16 values per instruction
+        // (the field is the low B/8 bytes of each little-endian dword), which
+        // beats even the dedicated byte/halfword store loops below. Sub-byte
+        // widths stay on the BMI2 PEXT path above, which already runs at
+        // store bandwidth; B=32 is a straight copy and needs no compress.
+        if constexpr (B == 8u || B == 16u || B == 24u)
+        {
+            while (n >= 32u)
+            {
+                out = pack32Avx512Vbmi2<B>(in, out);
+                in += 32u;
+                n -= 32u;
+            }
+            if (n == 0u)
+                return out;
+            return pack_dispatch_n<B>(in, n, out);
+        }
+#endif
+#ifdef TURBOPFOR_SCALAR_PACK_AVX2
+        // Per-B AVX2 block packer. B == 8 keeps its byte-store fast path and
+        // B >= 16 stays on the SWAR words, which already run at store
+        // bandwidth; when BMI2 is also enabled the PEXT path above has
+        // already taken B < 8.
+        if constexpr (B >= 1u && B < 16u && B != 8u)
+        {
+            size_t room = (static_cast<size_t>(n) * B + 7u) / 8u;
+            const uint32_t * avx_end = in + (n & ~31u);
+            while (in < avx_end)
+            {
+                out = pack32Avx2<B>(in, out, room);
+                in += 32u;
+                room -= 4u * B;
+            }
+            n &= 31u;
+            if (n == 0u)
+                return out;
+            return pack_dispatch_n<B>(in, n, out);
+        }
+#endif
         // Process 32-element blocks
         const uint32_t * end = in + (n & ~31u);
         while (in < end)
@@ -217,21 +291,76 @@ struct Bitpack32ScalarImpl
         if (b == 0u) [[unlikely]]
             return out;
 
-        if (b == 32u) [[unlikely]]
+        // b=32 needs no early-out: the cold tier's bitpack_b<32> is the same
+        // endian-converting copy.
+
+        // Two-tier dispatch. Postings-style data concentrates in a narrow
+        // band of widths (roughly 4-12 bits, plus the byte-aligned 16 and
+        // 20), so only those get direct cases: the compiler sees the callee,
+        // inlines the per-width specialization, and the indirect branch
+        // disappears for the common widths. The remaining 19 widths would
+        // quadruple the dispatcher's code size for inputs that rarely occur,
+        // so they stay behind one outlined table call in a cold section.
+        switch (b)
         {
-            copyU32ArrayToLe(out, in, n);
-            return out + n * 4u;
+            case 4u:
+                return bitpack_b<4>(in, n, out);
+            case 5u:
+                return bitpack_b<5>(in, n, out);
+            case 6u:
+                return bitpack_b<6>(in, n, out);
+            case 7u:
+                return bitpack_b<7>(in, n, out);
+            case 8u:
+                return bitpack_b<8>(in, n, out);
+            case 9u:
+                return bitpack_b<9>(in, n, out);
+            case 10u:
+                return bitpack_b<10>(in, n, out);
+            case 11u:
+                return bitpack_b<11>(in, n, out);
+            case 12u:
+                return bitpack_b<12>(in, n, out);
+            case 16u:
+                return bitpack_b<16>(in, n, out);
+            case 20u:
+                return bitpack_b<20>(in, n, out);
+            default:
+                return dispatch_cold(in, n, out, b);
         }
+    }
 
-        return table[b](in, n, out);
+    // Cold tier: widths outside the hot band go through the tables. Outlining
+    // this with the cold attribute moves the rare specializations (and the
+    // call sequence reaching them) out of the hot text section, so they stop
+    // competing with the common widths for icache.
+    [[gnu::cold]] [[gnu::noinline]] static unsigned char * dispatch_cold(const uint32_t * in, unsigned n, unsigned char * out, unsigned b)
+    {
+        return b <= 16u ? hot_table[b - 1u](in, n, out) : cold_table[b - 17u](in, n, out);
     }
 
-    static inline const Fn table[33] = {
-        nullptr,        &bitpack_b<1>,  &bitpack_b<2>,  &bitpack_b<3>,  &bitpack_b<4>,  &bitpack_b<5>,  &bitpack_b<6>,
-        &bitpack_b<7>,  &bitpack_b<8>,  &bitpack_b<9>,  &bitpack_b<10>, &bitpack_b<11>, &bitpack_b<12>, &bitpack_b<13>,
-        &bitpack_b<14>, &bitpack_b<15>, &bitpack_b<16>, &bitpack_b<17>, &bitpack_b<18>, &bitpack_b<19>, &bitpack_b<20>,
-        &bitpack_b<21>, &bitpack_b<22>, &bitpack_b<23>, &bitpack_b<24>, &bitpack_b<25>, &bitpack_b<26>, &bitpack_b<27>,
-        &bitpack_b<28>, &bitpack_b<29>, &bitpack_b<30>, &bitpack_b<31>, &bitpack_b<32>,
+    // Per-width entries are the ahead-of-time answer to runtime codegen:
+    // every bitpack_b<B> is already straight-line code with B folded into
+    // immediates, table lookup costs one load, and the ISA pick happens once
+    // at load time via IFUNC. A JIT (asmjit/libgccjit) would emit the same
+    // instruction sequence per (b, 32) at first use while adding a dependency
+    // and W^X pages, so it has nothing left to win here.
+    //
+    // Split into two halves so the widths that occur in practice share cache
+    // lines only with each other: hot_table covers b = 1..16 (indexed b-1,
+    // 128 bytes — two lines instead of the old 264-byte table[33], whose b=0
+    // slot was a never-read nullptr), cold_table covers b = 17..32 (indexed
+    // b-17).
+    static inline const Fn hot_table[16] = {
+        &bitpack_b<1>,  &bitpack_b<2>,  &bitpack_b<3>,  &bitpack_b<4>,  &bitpack_b<5>,  &bitpack_b<6>,  &bitpack_b<7>,
+        &bitpack_b<8>,  &bitpack_b<9>,  &bitpack_b<10>, &bitpack_b<11>, &bitpack_b<12>, &bitpack_b<13>, &bitpack_b<14>,
+        &bitpack_b<15>, &bitpack_b<16>,
+    };
+
+    static inline const Fn cold_table[16] = {
+        &bitpack_b<17>, &bitpack_b<18>, &bitpack_b<19>, &bitpack_b<20>, &bitpack_b<21>, &bitpack_b<22>, &bitpack_b<23>,
+        &bitpack_b<24>, &bitpack_b<25>, &bitpack_b<26>, &bitpack_b<27>, &bitpack_b<28>, &bitpack_b<29>, &bitpack_b<30>,
+        &bitpack_b<31>, &bitpack_b<32>,
     };
 };
 
@@ -1,11 +1,261 @@
 #include "p4_scalar_bitunpack_impl.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    include <immintrin.h>
+#    define TURBOPFOR_BITUNPACK32_AVX512 1
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#    include <arm_neon.h>
+#    define TURBOPFOR_BITUNPACK32_NEON 1
+#endif
+
 namespace turbopfor::scalar::detail
 {
 
-const unsigned char * bitunpack32Scalar(const unsigned char * in, unsigned n, uint32_t * out, unsigned b)
+#ifdef TURBOPFOR_BITUNPACK32_AVX512
+
+/// AVX-512 VBMI unpacker for b <= 16: emits 16 uint32 lanes per iteration.
+/// A group of 16 b-bit fields spans exactly 2b bytes, so each iteration starts
+/// on a byte boundary. For each output dword we route the 4 source bytes that
+/// cover its field into the lane with vpermb, then align with a per-lane
+/// variable right shift and mask. (vpermb + vpsrlvd plays the role of
+/// vpmultishiftqb here because the destinations are dword lanes, not bytes;
+/// shift + width never exceeds 7 + 16 = 23 bits, so 4 bytes always suffice.)
+__attribute__((target("avx512f,avx512bw,avx512vbmi"))) static const unsigned char *
+bitunpack32Avx512(const unsigned char * __restrict in, unsigned n, uint32_t * __restrict out, unsigned b)
+{
+    alignas(64) unsigned char perm[64];
+    alignas(64) uint32_t shifts[16];
+    for (unsigned i = 0; i < 16u; ++i)
+    {
+        const unsigned bitpos = i * b;
+        const unsigned char ofs = static_cast<unsigned char>(bitpos / 8u);
+        perm[4u * i + 0u] = ofs;
+        perm[4u * i + 1u] = static_cast<unsigned char>(ofs + 1u);
+        perm[4u * i + 2u] = static_cast<unsigned char>(ofs + 2u);
+        perm[4u * i + 3u] = static_cast<unsigned char>(ofs + 3u);
+        shifts[i] = bitpos % 8u;
+    }
+    const __m512i perm_vec = _mm512_load_si512(perm);
+    const __m512i shift_vec = _mm512_load_si512(shifts);
+    const __m512i mask_vec = _mm512_set1_epi32(static_cast<int>((1u << b) - 1u));
+
+    const unsigned group_bytes = 2u * b;
+    // The 64-byte load reads past the 2b consumed bytes; only run the wide
+    // loop while that much input is actually left in the stream.
+    size_t avail = (static_cast<size_t>(n) * b + 7u) / 8u;
+    while (n >= 16u && avail >= 64u)
+    {
+        const __m512i data = _mm512_loadu_si512(in);
+        __m512i v = _mm512_permutexvar_epi8(perm_vec, data);
+        v = _mm512_srlv_epi32(v, shift_vec);
+        v = _mm512_and_si512(v, mask_vec);
+        _mm512_storeu_si512(out, v);
+        in += group_bytes;
+        out += 16u;
+        n -= 16u;
+        avail -= group_bytes;
+    }
+
+    if (n == 0u)
+        return in;
+    return Bitunpack32ScalarImpl<false>::hot_table[b - 1u](in, n, out, 0u); // entries here are gated b <= 16
+}
+
+#endif
+
+#ifdef TURBOPFOR_BITUNPACK32_NEON
+
+/// NEON unpacker for b <= 16: 8 uint32 lanes per iteration. Mirrors the x86
+/// shuffle + variable-shift scheme; vqtbl1q_u8 routes the source bytes and
+/// vshlq_u32 on negated counts performs the per-lane right shift (NEON
+/// encodes right shifts as negative left shifts).
+static const unsigned char * bitunpack32Neon(const unsigned char * __restrict in, unsigned n, uint32_t * __restrict out, unsigned b)
+{
+    alignas(16) unsigned char shuf_bytes[32];
+    alignas(16) int32_t shift_counts[8];
+    const unsigned hi_base = (4u * b) / 8u;
+    for (unsigned j = 0; j < 4u; ++j)
+    {
+        const unsigned lo_bit = j * b;
+        const unsigned hi_bit = (4u + j) * b - 8u * hi_base;
+        for (unsigned k = 0; k < 4u; ++k)
+        {
+            shuf_bytes[4u * j + k] = static_cast<unsigned char>(lo_bit / 8u + k);
+            shuf_bytes[16u + 4u * j + k] = static_cast<unsigned char>(hi_bit / 8u + k);
+        }
+        shift_counts[j] = -static_cast<int32_t>(lo_bit % 8u);
+        shift_counts[4u + j] = -static_cast<int32_t>(hi_bit % 8u);
+    }
+    const uint8x16_t shuf_lo = vld1q_u8(shuf_bytes);
+    const uint8x16_t shuf_hi = vld1q_u8(shuf_bytes + 16u);
+    const int32x4_t shift_lo = vld1q_s32(shift_counts);
+    const int32x4_t shift_hi = vld1q_s32(shift_counts + 4u);
+    const uint32x4_t mask = vdupq_n_u32((1u << b) - 1u);
+
+    // Both 16-byte loads stay within the stream while at least 32 packed
+    // bytes remain (hi_base + 16 <= 24).
+    size_t avail = (static_cast<size_t>(n) * b + 7u) / 8u;
+    while (n >= 8u && avail >= 32u)
+    {
+        uint32x4_t lo = vreinterpretq_u32_u8(vqtbl1q_u8(vld1q_u8(in), shuf_lo));
+        uint32x4_t hi = vreinterpretq_u32_u8(vqtbl1q_u8(vld1q_u8(in + hi_base), shuf_hi));
+        lo = vandq_u32(vshlq_u32(lo, shift_lo), mask);
+        hi = vandq_u32(vshlq_u32(hi, shift_hi), mask);
+        vst1q_u32(out, lo);
+        vst1q_u32(out + 4u, hi);
+        in += b;
+        out += 8u;
+        n -= 8u;
+        avail -= b;
+    }
+
+    if (n == 0u)
+        return in;
+    return Bitunpack32ScalarImpl<false>::hot_table[b - 1u](in, n, out, 0u); // entries here are gated b <= 16
+}
+
+#endif
+
+#ifdef TURBOPFOR_BITUNPACK32_AVX512
+
+/// b = 8 in the horizontal layout is a plain byte stream, so unpacking is a
+/// zero-extension, not a bit extraction: PMOVZXBD widens 4 bytes to 4 dword
+/// lanes in one uop, no shifts or masks. (The vertical 128v/256v formats get
+/// no such path — there each group's bytes sit at stride 4 across the lanes.)
+static const unsigned char * bitunpack32Bytes(const unsigned char * in, unsigned n, uint32_t * out)
+{
+    unsigned i = 0;
+    for (; i + 8u <= n; i += 8u)
+    {
+        const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_cvtepu8_epi32(v));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 4u), _mm_cvtepu8_epi32(_mm_srli_si128(v, 4)));
+    }
+    for (; i < n; ++i)
+        out[i] = in[i];
+    return in + n;
+}
+
+/// b = 16: same idea with PMOVZXWD over the word stream.
+static const unsigned char * bitunpack32Words(const unsigned char * in, unsigned n, uint32_t * out)
+{
+    unsigned i = 0;
+    for (; i + 8u <= n; i += 8u)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 2u));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_cvtepu16_epi32(v));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 4u), _mm_cvtepu16_epi32(_mm_srli_si128(v, 8)));
+    }
+    for (; i < n; ++i)
+        out[i] = static_cast<uint32_t>(in[i * 2u]) | (static_cast<uint32_t>(in[i * 2u + 1u]) << 8u);
+    return in + n * 2u;
+}
+
+#endif
+
+static const unsigned char * bitunpack32ScalarPortable(const unsigned char * in, unsigned n, uint32_t * out, unsigned b)
 {
+#ifdef TURBOPFOR_BITUNPACK32_AVX512
+    if (b == 8u)
+        return bitunpack32Bytes(in, n, out);
+    if (b == 16u)
+        return bitunpack32Words(in, n, out);
+#endif
     return Bitunpack32ScalarImpl<false>::dispatch(in, n, out, 0u, b);
 }
 
+#if defined(TURBOPFOR_BITUNPACK32_AVX512) && defined(__ELF__)
+
+static const unsigned char * bitunpack32ScalarAvx512Entry(const unsigned char * in, unsigned n, uint32_t * out, unsigned b)
+{
+    // Byte-aligned widths beat the generic shuffle kernel too.
+    if (b == 8u)
+        return bitunpack32Bytes(in, n, out);
+    if (b == 16u)
+        return bitunpack32Words(in, n, out);
+    if (b >= 1u && b <= 16u && n >= 16u)
+        return bitunpack32Avx512(in, n, out, b);
+    return Bitunpack32ScalarImpl<false>::dispatch(in, n, out, 0u, b);
+}
+
+// IFUNC resolver: the loader picks the variant once at startup, so the
+// per-call CPUID check and branch disappear from the entry point entirely.
+extern "C" void * turbopforResolveBitunpack32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512vbmi") && __builtin_cpu_supports("avx512bw"))
+        return reinterpret_cast<void *>(&bitunpack32ScalarAvx512Entry);
+    return reinterpret_cast<void *>(&bitunpack32ScalarPortable);
+}
+
+const unsigned char * bitunpack32Scalar(const unsigned char * in, unsigned n, uint32_t * out, unsigned b)
+    __attribute__((ifunc("turbopforResolveBitunpack32")));
+
+#elif defined(TURBOPFOR_BITUNPACK32_NEON)
+
+const unsigned char * bitunpack32Scalar(const unsigned char * in, unsigned n, uint32_t * out, unsigned b)
+{
+    // NEON is baseline on aarch64: no runtime feature check needed.
+    if (b >= 1u && b <= 16u && n >= 8u)
+        return bitunpack32Neon(in, n, out, b);
+    return bitunpack32ScalarPortable(in, n, out, b);
+}
+
+#else
+
+const unsigned char * bitunpack32Scalar(const unsigned char * in, unsigned n, uint32_t * out, unsigned b)
+{
+    return bitunpack32ScalarPortable(in, n, out, b);
+}
+
+#endif
+
+/// Fixed-width entry: the width is folded at compile time, so callers that
+/// decode runs of equal b (postings streams cluster by width) skip both the
+/// width dispatch and, unlike the runtime entry, any per-call n switch. Note
+/// the trade: bitunpack32Scalar goes through the IFUNC-picked vector kernels,
+/// which these base-ISA instantiations do not — prefer them only where the
+/// width is statically known and the stream is short.
+template <unsigned B>
+const unsigned char * bitunpack32ScalarFixed(const unsigned char * in, unsigned n, uint32_t * out)
+{
+    static_assert(B >= 1u && B <= 32u);
+    return Bitunpack32ScalarImpl<false>::template bitunpack_b<B>(in, n, out, 0u);
+}
+
+template const unsigned char * bitunpack32ScalarFixed<1u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<2u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<3u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<4u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<5u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<6u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<7u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<8u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<9u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<10u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<11u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<12u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<13u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<14u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<15u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<16u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<17u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<18u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<19u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<20u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<21u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<22u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<23u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<24u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<25u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<26u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<27u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<28u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<29u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<30u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<31u>(const unsigned char *, unsigned, uint32_t *);
+template const unsigned char * bitunpack32ScalarFixed<32u>(const unsigned char *, unsigned, uint32_t *);
+
 } // namespace turbopfor::scalar::detail
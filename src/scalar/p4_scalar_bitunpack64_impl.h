@@ -68,8 +68,10 @@ unpack_emit_one64(const uint64_t * __restrict w, uint64_t * __restrict out, [[ma
 
     if constexpr (Delta1)
     {
-        acc += v;
-        out[idx] = acc + (idx + 1u);
+        // acc carries the emitted value: the +(idx+1) index term is folded in
+        // as a +1 per update, dropping one add per element from the chain.
+        acc += v + 1u;
+        out[idx] = acc;
     }
     else
     {
@@ -122,8 +124,8 @@ unpack_emit64(const uint64_t * __restrict w, uint64_t * __restrict out, uint64_t
             }                                                                  \
             if constexpr (Delta1)                                              \
             {                                                                  \
-                acc += v_;                                                     \
-                out[out_idx_] = acc + (out_idx_ + 1u);                         \
+                acc += v_ + 1u;                                                \
+                out[out_idx_] = acc;                                           \
             }                                                                  \
             else                                                               \
             {                                                                  \
@@ -202,7 +204,7 @@ unpack_block64(const unsigned char * __restrict in, uint64_t * __restrict out, [
 // Recursively unpack blocks of optimal size
 template <bool Delta1, unsigned B, unsigned N, unsigned Base>
 static TURBOPFOR_ALWAYS_INLINE const unsigned char *
-unpack_blocks64(const unsigned char * __restrict in, uint64_t * __restrict out, uint64_t acc)
+unpack_blocks64(const unsigned char * __restrict in, uint64_t * __restrict out, uint64_t & acc)
 {
     if constexpr (N == 0u)
     {
@@ -225,12 +227,12 @@ unpack_blocks64(const unsigned char * __restrict in, uint64_t * __restrict out,
 
 template <unsigned BytesPerElem, typename LoadFn>
 static TURBOPFOR_ALWAYS_INLINE const unsigned char *
-unpack_aligned_d1_32_u64(const unsigned char * in, uint64_t * out, uint64_t start, LoadFn load)
+unpack_aligned_d1_32_u64(const unsigned char * in, uint64_t * out, uint64_t & start, LoadFn load)
 {
     for (unsigned i = 0; i < 32; ++i)
     {
-        start += static_cast<uint64_t>(load(in + BytesPerElem * i));
-        out[i] = start + (i + 1u);
+        start += static_cast<uint64_t>(load(in + BytesPerElem * i)) + 1u;
+        out[i] = start;
     }
     return in + BytesPerElem * 32u;
 }
@@ -258,7 +260,7 @@ unpack64_n_b(const unsigned char * __restrict in, uint64_t * __restrict out, [[m
             uint64_t v = loadU64Fast(ip);
             ip += 8u;
             if constexpr (Delta1)
-                out[i] = (start += v) + (i + 1u);
+                out[i] = (start += v + 1u);
             else
                 out[i] = v;
         }
@@ -275,7 +277,7 @@ unpack64_n_b(const unsigned char * __restrict in, uint64_t * __restrict out, [[m
             uint64_t v = loadU32Fast(ip);
             ip += 4u;
             if constexpr (Delta1)
-                out[i] = (start += v) + (i + 1u);
+                out[i] = (start += v + 1u);
             else
                 out[i] = v;
         }
@@ -292,7 +294,7 @@ unpack64_n_b(const unsigned char * __restrict in, uint64_t * __restrict out, [[m
             uint64_t v = loadU16Fast(ip);
             ip += 2u;
             if constexpr (Delta1)
-                out[i] = (start += v) + (i + 1u);
+                out[i] = (start += v + 1u);
             else
                 out[i] = v;
         }
@@ -308,7 +310,7 @@ unpack64_n_b(const unsigned char * __restrict in, uint64_t * __restrict out, [[m
         {
             uint64_t v = *ip++;
             if constexpr (Delta1)
-                out[i] = (start += v) + (i + 1u);
+                out[i] = (start += v + 1u);
             else
                 out[i] = v;
         }
@@ -321,6 +323,31 @@ unpack64_n_b(const unsigned char * __restrict in, uint64_t * __restrict out, [[m
     }
 }
 
+// One 32-element Delta1 block that hands the prefix for the next block back
+// through start, keeping the chain in a register across blocks instead of the
+// caller reloading out[31] (a store-to-load forwarding stall per block).
+// The accumulator carries the emitted value (the index term is folded into
+// each +1 update), so the next block's start is acc itself.
+template <unsigned B>
+static TURBOPFOR_ALWAYS_INLINE const unsigned char *
+unpack64_d1_32(const unsigned char * __restrict in, uint64_t * __restrict out, uint64_t & start)
+{
+    uint64_t acc = start;
+    const unsigned char * ip;
+    if constexpr (B == 64)
+        ip = unpack_aligned_d1_32_u64<8>(in, out, acc, [](const unsigned char * p) { return loadU64Fast(p); });
+    else if constexpr (B == 32)
+        ip = unpack_aligned_d1_32_u64<4>(in, out, acc, [](const unsigned char * p) { return static_cast<uint64_t>(loadU32Fast(p)); });
+    else if constexpr (B == 16)
+        ip = unpack_aligned_d1_32_u64<2>(in, out, acc, [](const unsigned char * p) { return static_cast<uint64_t>(loadU16Fast(p)); });
+    else if constexpr (B == 8)
+        ip = unpack_aligned_d1_32_u64<1>(in, out, acc, [](const unsigned char * p) { return static_cast<uint64_t>(*p); });
+    else
+        ip = unpack_blocks64<true, B, 32, 0u>(in, out, acc);
+    start = acc;
+    return ip;
+}
+
 // -----------------------------------------------------------------------------
 // Tail dispatch: runtime n -> compile-time N
 // -----------------------------------------------------------------------------
@@ -398,8 +425,7 @@ struct Bitunpack64ScalarImpl
         {
             if constexpr (Delta1)
             {
-                in = unpack64_n_b<true, B, 32>(in, out, start);
-                start = out[31];
+                in = unpack64_d1_32<B>(in, out, start);
             }
             else
             {
@@ -408,9 +434,11 @@ struct Bitunpack64ScalarImpl
             out += 32;
         }
 
-        // Tail: remaining 1-31 elements
+        // Tail: remaining 1-31 elements. Callers overwhelmingly decode whole
+        // 32-element blocks (P4 posting blocks are 128/256 values), so the
+        // residual path is cold.
         n &= 31u;
-        if (n == 0u)
+        if (n == 0u) [[likely]]
             return ret;
 
         if constexpr (Delta1)
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "p4_scalar_internal.h"
+
+#if defined(__x86_64__) && defined(__AVX2__)
+
+#    include <immintrin.h>
+
+#    define TURBOPFOR_SCALAR_UNPACK_AVX2 1
+
+namespace turbopfor::scalar::detail
+{
+
+/// Byte index within a group's 16-byte chunk of byte j of lane k's field.
+/// A field of b < 16 bits starts at bit k*b, so with the in-byte shift of at
+/// most 7 it spans at most three bytes; the fourth gathered byte is never
+/// part of the field and is zeroed via the 0x80 shuffle index instead.
+static constexpr char unpackShuffleByte(unsigned b, unsigned k, unsigned j)
+{
+    return j >= 3u ? char(-1) : static_cast<char>((k * b) / 8u + j);
+}
+
+/// Per-width controls for the shared AVX2 unpack kernel: the vpshufb byte
+/// gather, the per-lane bit alignment and the field mask. One 72-byte entry
+/// per width instead of one kernel instantiation per width.
+struct UnpackAvx2Ctrl
+{
+    alignas(32) char shuffle[32];
+    alignas(32) int32_t shift[8];
+    uint32_t mask;
+};
+
+static constexpr UnpackAvx2Ctrl makeUnpackAvx2Ctrl(unsigned b)
+{
+    UnpackAvx2Ctrl c{};
+    for (unsigned k = 0; k < 8u; ++k)
+    {
+        for (unsigned j = 0; j < 4u; ++j)
+            c.shuffle[k * 4u + j] = unpackShuffleByte(b, k, j);
+        c.shift[k] = static_cast<int32_t>((k * b) % 8u);
+    }
+    c.mask = (1u << b) - 1u;
+    return c;
+}
+
+/// Entries 0 and 8 are never dispatched to (b = 0 is handled before any
+/// kernel runs and b = 8 has its own byte loop).
+static constexpr UnpackAvx2Ctrl unpackAvx2Ctrl[16] = {
+    makeUnpackAvx2Ctrl(0),
+    makeUnpackAvx2Ctrl(1),
+    makeUnpackAvx2Ctrl(2),
+    makeUnpackAvx2Ctrl(3),
+    makeUnpackAvx2Ctrl(4),
+    makeUnpackAvx2Ctrl(5),
+    makeUnpackAvx2Ctrl(6),
+    makeUnpackAvx2Ctrl(7),
+    makeUnpackAvx2Ctrl(8),
+    makeUnpackAvx2Ctrl(9),
+    makeUnpackAvx2Ctrl(10),
+    makeUnpackAvx2Ctrl(11),
+    makeUnpackAvx2Ctrl(12),
+    makeUnpackAvx2Ctrl(13),
+    makeUnpackAvx2Ctrl(14),
+    makeUnpackAvx2Ctrl(15),
+};
+
+/// Data-driven AVX2 unpacker for whole 32-element blocks (b < 16, b != 8).
+/// 8 values of b bits occupy exactly b bytes, so each of the four groups per
+/// block starts on a byte boundary. Per group: broadcast the group's 16
+/// leading bytes to both 128-bit halves, vpshufb the field's bytes into each
+/// dword lane, align with a per-lane vpsrlvd ((k*b) % 8), and mask. All
+/// controls come from unpackAvx2Ctrl, so every width shares this one loop —
+/// noinline keeps the compiler from cloning it back per constant b.
+///
+/// Each group load reads 16 bytes from the group's start; callers must
+/// ensure that much input remains for every block they request (the
+/// dispatch loop's avail guard).
+///
+/// With Stream the 32-byte group stores become non-temporal (vmovntdq):
+/// for decodes larger than L1 the output lines would be evicted before any
+/// reuse anyway, and bypassing the cache also skips the read-for-ownership
+/// traffic on each line. Requires a 32-byte-aligned out pointer; the caller
+/// gates on that and on the decode size.
+template <bool Stream>
+[[gnu::noinline]] static const unsigned char *
+unpack32Avx2Bulk(const unsigned char * __restrict in, uint32_t * __restrict out, size_t nblocks, unsigned b)
+{
+    const UnpackAvx2Ctrl & c = unpackAvx2Ctrl[b];
+    const __m256i shuf = _mm256_load_si256(reinterpret_cast<const __m256i *>(c.shuffle));
+    const __m256i shift_vec = _mm256_load_si256(reinterpret_cast<const __m256i *>(c.shift));
+    const __m256i mask_vec = _mm256_set1_epi32(static_cast<int>(c.mask));
+
+    while (nblocks-- != 0u)
+    {
+        for (unsigned g = 0; g < 4u; ++g)
+        {
+            const __m256i chunk = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in)));
+            const __m256i gathered = _mm256_shuffle_epi8(chunk, shuf);
+            const __m256i vals = _mm256_and_si256(_mm256_srlv_epi32(gathered, shift_vec), mask_vec);
+            if constexpr (Stream)
+                _mm256_stream_si256(reinterpret_cast<__m256i *>(out + g * 8u), vals);
+            else
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + g * 8u), vals);
+            in += b;
+        }
+        out += 32u;
+    }
+
+    if constexpr (Stream)
+        _mm_sfence(); // drain the write-combining buffers before anyone reads out[]
+
+    return in;
+}
+
+/// Output sizes at or above this many values (32 KB of u32) no longer fit in
+/// L1; non-temporal stores win from here on.
+constexpr unsigned UNPACK_STREAM_THRESHOLD = 8192u;
+
+} // namespace turbopfor::scalar::detail
+
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "p4_scalar_internal.h"
+
+// VPMULTISHIFTQB and VPERMB are VBMI; the 256-bit forms need VL
+#if defined(__x86_64__) && defined(__AVX512VBMI__) && defined(__AVX512VL__)
+
+#    include <immintrin.h>
+
+#    define TURBOPFOR_SCALAR_UNPACK_AVX512VBMI 1
+
+namespace turbopfor::scalar::detail
+{
+
+/// Byte index of byte j of group g's window (group g starts at byte g*B)
+template <unsigned B>
+static constexpr char groupByte(unsigned g, unsigned j)
+{
+    return static_cast<char>(g * B + j);
+}
+
+/// Bit offset of field k within its group's 64-bit lane
+template <unsigned B>
+static constexpr char fieldShift(unsigned k)
+{
+    return static_cast<char>(k * B);
+}
+
+/// AVX-512 VBMI unpacker for one 32-element block at B <= 8: a group of 8
+/// fields spans exactly B bytes, so VPERMB lines up each group's leading 8
+/// bytes in one 64-bit lane and one VPMULTISHIFTQB pulls all 32 fields into
+/// one byte each (the instruction reads 8 bits at an arbitrary bit offset
+/// per destination byte — purpose-built for this). A byte mask drops the
+/// neighbours' high bits and two zero-extensions widen to the output dwords.
+///
+/// The block load reads 32 bytes from the block's start while the block is
+/// only 4*B bytes; callers must ensure that much input remains.
+template <unsigned B>
+static TURBOPFOR_ALWAYS_INLINE const unsigned char * unpack32Avx512Vbmi(const unsigned char * __restrict in, uint32_t * __restrict out)
+{
+    static_assert(B >= 1u && B <= 8u);
+
+    // Lane g holds input bytes g*B .. g*B+7; byte k of lane g wants the
+    // field at bit k*B within that lane.
+    const __m256i byte_idx = _mm256_setr_epi8(
+        groupByte<B>(0, 0), groupByte<B>(0, 1), groupByte<B>(0, 2), groupByte<B>(0, 3), groupByte<B>(0, 4), groupByte<B>(0, 5), groupByte<B>(0, 6), groupByte<B>(0, 7), groupByte<B>(1, 0), groupByte<B>(1, 1), groupByte<B>(1, 2),
+        groupByte<B>(1, 3), groupByte<B>(1, 4), groupByte<B>(1, 5), groupByte<B>(1, 6), groupByte<B>(1, 7), groupByte<B>(2, 0), groupByte<B>(2, 1), groupByte<B>(2, 2), groupByte<B>(2, 3), groupByte<B>(2, 4), groupByte<B>(2, 5),
+        groupByte<B>(2, 6), groupByte<B>(2, 7), groupByte<B>(3, 0), groupByte<B>(3, 1), groupByte<B>(3, 2), groupByte<B>(3, 3), groupByte<B>(3, 4), groupByte<B>(3, 5), groupByte<B>(3, 6), groupByte<B>(3, 7));
+    const __m256i bit_ctrl = _mm256_setr_epi8(
+        fieldShift<B>(0), fieldShift<B>(1), fieldShift<B>(2), fieldShift<B>(3), fieldShift<B>(4), fieldShift<B>(5), fieldShift<B>(6), fieldShift<B>(7), fieldShift<B>(0), fieldShift<B>(1), fieldShift<B>(2), fieldShift<B>(3), fieldShift<B>(4), fieldShift<B>(5), fieldShift<B>(6), fieldShift<B>(7),
+        fieldShift<B>(0), fieldShift<B>(1), fieldShift<B>(2), fieldShift<B>(3), fieldShift<B>(4), fieldShift<B>(5), fieldShift<B>(6), fieldShift<B>(7), fieldShift<B>(0), fieldShift<B>(1), fieldShift<B>(2), fieldShift<B>(3), fieldShift<B>(4), fieldShift<B>(5), fieldShift<B>(6), fieldShift<B>(7));
+
+    const __m256i gathered = _mm256_permutexvar_epi8(byte_idx, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in)));
+    const __m256i fields = _mm256_multishift_epi64_epi8(bit_ctrl, gathered);
+    const __m256i masked = _mm256_and_si256(fields, _mm256_set1_epi8(static_cast<char>((1u << B) - 1u)));
+
+    _mm512_storeu_si512(out, _mm512_cvtepu8_epi32(_mm256_castsi256_si128(masked)));
+    _mm512_storeu_si512(out + 16u, _mm512_cvtepu8_epi32(_mm256_extracti128_si256(masked, 1)));
+
+    return in + 4u * B;
+}
+
+} // namespace turbopfor::scalar::detail
+
+#endif
@@ -1,59 +1,60 @@
 #pragma once
 
+#include "p4_scalar_bitunpack_avx2.h"
+#include "p4_scalar_bitunpack_avx512.h"
 #include "p4_scalar_internal.h"
 
 #include <algorithm>
 #include <utility>
 
-namespace turbopfor::scalar::detail
-{
+#if defined(__x86_64__)
+#    include <immintrin.h>
+#    if defined(__BMI2__) && defined(__SSE4_1__)
+#        define TURBOPFOR_SCALAR_BMI2 1
+#    endif
+#endif
 
-// Helper to prevent SLP vectorization for specific bit widths.
-// SLP vectorizer merges consecutive 4-byte stores (out[0], out[1], out[2], out[3])
-// into vector stores using pinsrd/movdqu, which is slower for some bit widths.
-// Using volatile prevents the compiler from merging these stores.
-template <bool PreventSlp>
-static TURBOPFOR_ALWAYS_INLINE void store_u32(uint32_t * out, unsigned idx, uint32_t val)
+namespace turbopfor::scalar::detail
 {
-    if constexpr (PreventSlp)
-    {
-        // Use volatile to prevent SLP vectorizer from merging stores
-        volatile uint32_t * vout = out;
-        vout[idx] = val;
-    }
-    else
-    {
-        out[idx] = val;
-    }
-}
 
-// Bit widths that suffer from SLP vectorization overhead
-// SLP vectorizer merges consecutive stores into vector ops (pinsrd/movdqu),
-// which is slower for certain bit widths.
-// Delta1=false and Delta1=true have different optimal sets.
-// Determined by benchmarking across n=32,63,64,96,127 with --bitunpack and --bitunpackd1
-template <bool Delta1, unsigned B>
-constexpr bool needs_slp_prevention()
+/// Copy a staged block to the caller's output buffer.
+///
+/// unpack_block emits into a stack buffer instead of `out` so the extracted
+/// values never meet the SLP vectorizer as individual output stores: merging
+/// shift/mask results with pinsrd chains used to be slow enough at some
+/// widths that the old code defeated it with volatile stores. The explicit
+/// vector copies here are opaque to that pass, and the staging buffer stays
+/// in L1, so both the volatile penalty and the pinsrd chains are gone.
+template <unsigned K>
+static TURBOPFOR_ALWAYS_INLINE void copy_staged(const uint32_t * __restrict tmp, uint32_t * __restrict out)
 {
-    if constexpr (Delta1)
-    {
-        // Delta decoding has data dependencies that mostly prevent harmful SLP,
-        // and enabling SLP prevention hurts performance across almost all bit widths.
-        return false;
-    }
-    else
-    {
-        // Non-delta bitunpack: B=17 shows consistent large improvement (+17.7% avg)
-        // across most n values when SLP is prevented.
-        return B == 17;
-    }
+#if defined(__x86_64__)
+    constexpr unsigned vec = K & ~3u;
+    for (unsigned i = 0; i < vec; i += 4u)
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_load_si128(reinterpret_cast<const __m128i *>(tmp + i)));
+    for (unsigned i = vec; i < K; ++i)
+        out[i] = tmp[i];
+#else
+    memcpy(out, tmp, K * sizeof(uint32_t));
+#endif
 }
 
-template <bool Delta1, unsigned B, unsigned Base, size_t I, bool PreventSlp = needs_slp_prevention<Delta1, B>()>
+/// Extract element I of a block from the little-endian word window w.
+/// The sh + B > 64 test is constexpr — the cross-word OR is emitted only for
+/// the elements whose field actually straddles a word, which for B bits is
+/// at most B-1 of every 64/gcd(64,B) elements. Byte-swapping the window to
+/// big-endian to make the shift arithmetic uniform would not remove any of
+/// those ORs (the field still spans two words); it would only add a bswap
+/// to every word load. Byte-granular windows (palignr over an xmm pair, or
+/// an unaligned 8-byte reload at bitpos/8) would drop the OR too, but they
+/// either re-read the freshly written w[] across store boundaries — a
+/// store-forwarding stall per crossing lane, worse than the OR — or reload
+/// the input stream past the exact bytes this tail path is allowed to touch.
+/// The wide kernels with avail guards are where that trick already lives.
+template <bool Delta1, unsigned B, unsigned Base, size_t I>
 static TURBOPFOR_ALWAYS_INLINE void
 unpack_emit_one(const uint64_t * __restrict w, uint32_t * __restrict out, [[maybe_unused]] uint32_t & acc)
 {
-    constexpr unsigned idx = Base + static_cast<unsigned>(I);
     constexpr unsigned bitpos = static_cast<unsigned>(I) * B;
     constexpr unsigned wi = bitpos / 64u;
     constexpr unsigned sh = bitpos % 64u;
@@ -65,12 +66,15 @@ unpack_emit_one(const uint64_t * __restrict w, uint32_t * __restrict out, [[mayb
 
     if constexpr (Delta1)
     {
-        acc += static_cast<uint32_t>(v) & mask;
-        store_u32<PreventSlp>(out, idx, acc + (idx + 1u));
+        // acc carries the emitted value, not the raw delta sum: the index
+        // term of out[i] = sum + (i + 1) is folded in as a +1 per update, so
+        // the extra add per element disappears from the emit.
+        acc += (static_cast<uint32_t>(v) & mask) + 1u;
+        out[I] = acc;
     }
     else
     {
-        store_u32<PreventSlp>(out, idx, static_cast<uint32_t>(v) & mask);
+        out[I] = static_cast<uint32_t>(v) & mask;
     }
 }
 
@@ -107,12 +111,14 @@ unpack_block(const unsigned char * __restrict in, uint32_t * __restrict out, [[m
         w[word_count - 1u] = load_partial<last_bytes>(ip);
     }
 
-    unpack_emit<Delta1, B, Base>(w, out, acc, std::make_index_sequence<K>{});
+    alignas(32) uint32_t tmp[K];
+    unpack_emit<Delta1, B, Base>(w, tmp, acc, std::make_index_sequence<K>{});
+    copy_staged<K>(tmp, out + Base);
     return ip;
 }
 
 template <bool Delta1, unsigned B, unsigned N, unsigned Base>
-static TURBOPFOR_ALWAYS_INLINE const unsigned char * unpack_blocks(const unsigned char * __restrict in, uint32_t * __restrict out, uint32_t acc)
+static TURBOPFOR_ALWAYS_INLINE const unsigned char * unpack_blocks(const unsigned char * __restrict in, uint32_t * __restrict out, uint32_t & acc)
 {
     if constexpr (N == 0u)
     {
@@ -134,12 +140,11 @@ template <std::size_t... I>
 static TURBOPFOR_ALWAYS_INLINE void
 unpack_b32_d1_32_emit(const unsigned char * in, uint32_t * out, uint32_t & acc, std::index_sequence<I...>)
 {
-    ((acc += loadU32Fast(in + 4u * static_cast<unsigned>(I)), out[I] = acc + (static_cast<unsigned>(I) + 1u)), ...);
+    ((acc += loadU32Fast(in + 4u * static_cast<unsigned>(I)) + 1u, out[I] = acc), ...);
 }
 
-static TURBOPFOR_ALWAYS_INLINE const unsigned char * unpack_b32_d1_32(const unsigned char * in, uint32_t * out, uint32_t start)
+static TURBOPFOR_ALWAYS_INLINE const unsigned char * unpack_b32_d1_32(const unsigned char * in, uint32_t * out, uint32_t & acc)
 {
-    uint32_t acc = start;
     unpack_b32_d1_32_emit(in, out, acc, std::make_index_sequence<32>{});
     return in + 128u;
 }
@@ -148,12 +153,11 @@ template <std::size_t... I>
 static TURBOPFOR_ALWAYS_INLINE void
 unpack_b16_d1_32_emit(const unsigned char * in, uint32_t * out, uint32_t & acc, std::index_sequence<I...>)
 {
-    ((acc += loadU16Fast(in + 2u * static_cast<unsigned>(I)), out[I] = acc + (static_cast<unsigned>(I) + 1u)), ...);
+    ((acc += loadU16Fast(in + 2u * static_cast<unsigned>(I)) + 1u, out[I] = acc), ...);
 }
 
-static TURBOPFOR_ALWAYS_INLINE const unsigned char * unpack_b16_d1_32(const unsigned char * in, uint32_t * out, uint32_t start)
+static TURBOPFOR_ALWAYS_INLINE const unsigned char * unpack_b16_d1_32(const unsigned char * in, uint32_t * out, uint32_t & acc)
 {
-    uint32_t acc = start;
     unpack_b16_d1_32_emit(in, out, acc, std::make_index_sequence<32>{});
     return in + 64u;
 }
@@ -162,12 +166,11 @@ template <std::size_t... I>
 static TURBOPFOR_ALWAYS_INLINE void
 unpack_b8_d1_32_emit(const unsigned char * in, uint32_t * out, uint32_t & acc, std::index_sequence<I...>)
 {
-    ((acc += static_cast<uint32_t>(in[static_cast<unsigned>(I)]), out[I] = acc + (static_cast<unsigned>(I) + 1u)), ...);
+    ((acc += static_cast<uint32_t>(in[static_cast<unsigned>(I)]) + 1u, out[I] = acc), ...);
 }
 
-static TURBOPFOR_ALWAYS_INLINE const unsigned char * unpack_b8_d1_32(const unsigned char * in, uint32_t * out, uint32_t start)
+static TURBOPFOR_ALWAYS_INLINE const unsigned char * unpack_b8_d1_32(const unsigned char * in, uint32_t * out, uint32_t & acc)
 {
-    uint32_t acc = start;
     unpack_b8_d1_32_emit(in, out, acc, std::make_index_sequence<32>{});
     return in + 32u;
 }
@@ -186,15 +189,27 @@ unpack_n_b(const unsigned char * __restrict in, uint32_t * __restrict out, [[may
     if constexpr (Delta1 && B == 8 && N == 32)
         return unpack_b8_d1_32(in, out, start);
 
+    // Without the delta chain the byte-multiple widths are pure data movement:
+    // B = 32 is a memcpy and B = 16/8 are zero-extensions, one pmovzx per four
+    // lanes. Every load consumes exactly the bytes of the elements it widens
+    // (8 for four u16, 4 for four u8), so the exact-load contract holds with
+    // no tail guard beyond the scalar remainder.
     if constexpr (B == 32)
     {
         const unsigned char * ip = in;
+        if constexpr (!Delta1)
+        {
+#if !TURBOPFOR_BIG_ENDIAN
+            std::memcpy(out, ip, size_t{N} * 4u);
+            return ip + size_t{N} * 4u;
+#endif
+        }
         for (unsigned i = 0; i < N; ++i)
         {
             uint32_t v = loadU32Fast(ip);
             ip += 4u;
             if constexpr (Delta1)
-                out[i] = (start += v) + (i + 1u);
+                out[i] = (start += v + 1u);
             else
                 out[i] = v;
         }
@@ -203,12 +218,18 @@ unpack_n_b(const unsigned char * __restrict in, uint32_t * __restrict out, [[may
     else if constexpr (B == 16)
     {
         const unsigned char * ip = in;
-        for (unsigned i = 0; i < N; ++i)
+        unsigned i = 0;
+#if defined(__x86_64__) && defined(__SSE4_1__) && !TURBOPFOR_BIG_ENDIAN
+        if constexpr (!Delta1)
+            for (; i + 4u <= N; i += 4u, ip += 8u)
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(ip))));
+#endif
+        for (; i < N; ++i)
         {
             uint32_t v = loadU16Fast(ip);
             ip += 2u;
             if constexpr (Delta1)
-                out[i] = (start += v) + (i + 1u);
+                out[i] = (start += v + 1u);
             else
                 out[i] = v;
         }
@@ -217,11 +238,18 @@ unpack_n_b(const unsigned char * __restrict in, uint32_t * __restrict out, [[may
     else if constexpr (B == 8)
     {
         const unsigned char * ip = in;
-        for (unsigned i = 0; i < N; ++i)
+        unsigned i = 0;
+#if defined(__x86_64__) && defined(__SSE4_1__) && !TURBOPFOR_BIG_ENDIAN
+        if constexpr (!Delta1)
+            for (; i + 4u <= N; i += 4u, ip += 4u)
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i *>(out + i), _mm_cvtepu8_epi32(_mm_cvtsi32_si128(static_cast<int>(loadU32Fast(ip)))));
+#endif
+        for (; i < N; ++i)
         {
             uint32_t v = *ip++;
             if constexpr (Delta1)
-                out[i] = (start += v) + (i + 1u);
+                out[i] = (start += v + 1u);
             else
                 out[i] = v;
         }
@@ -233,76 +261,71 @@ unpack_n_b(const unsigned char * __restrict in, uint32_t * __restrict out, [[may
     }
 }
 
+/// One 32-element Delta1 block that hands the prefix for the next block back
+/// through start, keeping the chain in a register across blocks — the caller
+/// used to reload out[31], paying a store-to-load forwarding stall at the end
+/// of every block. The accumulator carries the emitted value (the index term
+/// is folded into each +1 update), so the next block's start is acc itself.
+template <unsigned B>
+static TURBOPFOR_ALWAYS_INLINE const unsigned char * unpack_d1_32(const unsigned char * __restrict in, uint32_t * __restrict out, uint32_t & start)
+{
+    uint32_t acc = start;
+    const unsigned char * ip;
+    if constexpr (B == 32u)
+        ip = unpack_b32_d1_32(in, out, acc);
+    else if constexpr (B == 16u)
+        ip = unpack_b16_d1_32(in, out, acc);
+    else if constexpr (B == 8u)
+        ip = unpack_b8_d1_32(in, out, acc);
+    else
+        ip = unpack_blocks<true, B, 32, 0u>(in, out, acc);
+    start = acc;
+    return ip;
+}
+
+/// Residual-element dispatch on n (callers guarantee 1 <= n < 32). A direct
+/// table load like Bitunpack32ScalarImpl::table: the switch this replaces
+/// compiled to the same jump table but kept a range check in front of it
+/// that the __builtin_unreachable default never managed to eliminate.
 template <bool Delta1, unsigned B>
 static TURBOPFOR_ALWAYS_INLINE const unsigned char * unpack(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
 {
-    switch (n)
-    {
-        case 1u:
-            return unpack_n_b<Delta1, B, 1>(in, out, start);
-        case 2u:
-            return unpack_n_b<Delta1, B, 2>(in, out, start);
-        case 3u:
-            return unpack_n_b<Delta1, B, 3>(in, out, start);
-        case 4u:
-            return unpack_n_b<Delta1, B, 4>(in, out, start);
-        case 5u:
-            return unpack_n_b<Delta1, B, 5>(in, out, start);
-        case 6u:
-            return unpack_n_b<Delta1, B, 6>(in, out, start);
-        case 7u:
-            return unpack_n_b<Delta1, B, 7>(in, out, start);
-        case 8u:
-            return unpack_n_b<Delta1, B, 8>(in, out, start);
-        case 9u:
-            return unpack_n_b<Delta1, B, 9>(in, out, start);
-        case 10u:
-            return unpack_n_b<Delta1, B, 10>(in, out, start);
-        case 11u:
-            return unpack_n_b<Delta1, B, 11>(in, out, start);
-        case 12u:
-            return unpack_n_b<Delta1, B, 12>(in, out, start);
-        case 13u:
-            return unpack_n_b<Delta1, B, 13>(in, out, start);
-        case 14u:
-            return unpack_n_b<Delta1, B, 14>(in, out, start);
-        case 15u:
-            return unpack_n_b<Delta1, B, 15>(in, out, start);
-        case 16u:
-            return unpack_n_b<Delta1, B, 16>(in, out, start);
-        case 17u:
-            return unpack_n_b<Delta1, B, 17>(in, out, start);
-        case 18u:
-            return unpack_n_b<Delta1, B, 18>(in, out, start);
-        case 19u:
-            return unpack_n_b<Delta1, B, 19>(in, out, start);
-        case 20u:
-            return unpack_n_b<Delta1, B, 20>(in, out, start);
-        case 21u:
-            return unpack_n_b<Delta1, B, 21>(in, out, start);
-        case 22u:
-            return unpack_n_b<Delta1, B, 22>(in, out, start);
-        case 23u:
-            return unpack_n_b<Delta1, B, 23>(in, out, start);
-        case 24u:
-            return unpack_n_b<Delta1, B, 24>(in, out, start);
-        case 25u:
-            return unpack_n_b<Delta1, B, 25>(in, out, start);
-        case 26u:
-            return unpack_n_b<Delta1, B, 26>(in, out, start);
-        case 27u:
-            return unpack_n_b<Delta1, B, 27>(in, out, start);
-        case 28u:
-            return unpack_n_b<Delta1, B, 28>(in, out, start);
-        case 29u:
-            return unpack_n_b<Delta1, B, 29>(in, out, start);
-        case 30u:
-            return unpack_n_b<Delta1, B, 30>(in, out, start);
-        case 31u:
-            return unpack_n_b<Delta1, B, 31>(in, out, start);
-        default:
-            __builtin_unreachable();
-    }
+    using Fn = const unsigned char * (*)(const unsigned char *, uint32_t *, uint32_t);
+    static constexpr Fn tail[32] = {
+        nullptr,
+        &unpack_n_b<Delta1, B, 1>,
+        &unpack_n_b<Delta1, B, 2>,
+        &unpack_n_b<Delta1, B, 3>,
+        &unpack_n_b<Delta1, B, 4>,
+        &unpack_n_b<Delta1, B, 5>,
+        &unpack_n_b<Delta1, B, 6>,
+        &unpack_n_b<Delta1, B, 7>,
+        &unpack_n_b<Delta1, B, 8>,
+        &unpack_n_b<Delta1, B, 9>,
+        &unpack_n_b<Delta1, B, 10>,
+        &unpack_n_b<Delta1, B, 11>,
+        &unpack_n_b<Delta1, B, 12>,
+        &unpack_n_b<Delta1, B, 13>,
+        &unpack_n_b<Delta1, B, 14>,
+        &unpack_n_b<Delta1, B, 15>,
+        &unpack_n_b<Delta1, B, 16>,
+        &unpack_n_b<Delta1, B, 17>,
+        &unpack_n_b<Delta1, B, 18>,
+        &unpack_n_b<Delta1, B, 19>,
+        &unpack_n_b<Delta1, B, 20>,
+        &unpack_n_b<Delta1, B, 21>,
+        &unpack_n_b<Delta1, B, 22>,
+        &unpack_n_b<Delta1, B, 23>,
+        &unpack_n_b<Delta1, B, 24>,
+        &unpack_n_b<Delta1, B, 25>,
+        &unpack_n_b<Delta1, B, 26>,
+        &unpack_n_b<Delta1, B, 27>,
+        &unpack_n_b<Delta1, B, 28>,
+        &unpack_n_b<Delta1, B, 29>,
+        &unpack_n_b<Delta1, B, 30>,
+        &unpack_n_b<Delta1, B, 31>,
+    };
+    return tail[n](in, out, start);
 }
 
 template <bool Delta1>
@@ -314,24 +337,190 @@ struct Bitunpack32ScalarImpl
     static TURBOPFOR_ALWAYS_INLINE const unsigned char *
     bitunpack_b(const unsigned char * in, unsigned n, uint32_t * out, [[maybe_unused]] uint32_t start)
     {
+#ifdef TURBOPFOR_SCALAR_UNPACK_AVX512VBMI
+        // One multishift per 32-element block for sub-byte widths. The block
+        // load reads 32 bytes while the block is only 4*B, so the wide loop
+        // stops when fewer than 32 packed bytes remain; the narrower kernels
+        // and the exact word path below mop up the rest.
+        if constexpr (!Delta1 && B <= 8u)
+        {
+            size_t avail = (static_cast<size_t>(n) * B + 7u) / 8u;
+            while (n >= 32u && avail >= 32u)
+            {
+                in = unpack32Avx512Vbmi<B>(in, out);
+                out += 32u;
+                n -= 32u;
+                avail -= 4u * B;
+            }
+            if (n == 0u)
+                return in;
+        }
+#endif
+#ifdef TURBOPFOR_SCALAR_BMI2
+        // Inverse of the PEXT pack path: for B < 8 one PDEP spreads a group's
+        // 8*B packed bits into the low B bits of 8 bytes, which two cvtepu8
+        // widenings turn into the output dwords. The 8-byte load reads past
+        // the group's B bytes, so the loop only runs while that much input
+        // actually remains; the generic path below mops up the rest.
+        if constexpr (!Delta1 && B < 8u)
+        {
+            constexpr uint64_t field_mask = (~0ull / 255ull) * ((1ull << B) - 1ull);
+            size_t avail = (static_cast<size_t>(n) * B + 7u) / 8u;
+            while (n >= 8u && avail >= 8u)
+            {
+                const uint64_t bytes = _pdep_u64(loadU64Fast(in), field_mask);
+                const __m128i b8 = _mm_cvtsi64_si128(static_cast<long long>(bytes));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_cvtepu8_epi32(b8));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 4u), _mm_cvtepu8_epi32(_mm_srli_si128(b8, 4)));
+                in += B;
+                out += 8u;
+                n -= 8u;
+                avail -= B;
+            }
+            while (n >= 32u)
+            {
+                in = unpack_n_b<false, B, 32>(in, out, 0u);
+                out += 32u;
+                n -= 32u;
+            }
+            if (n == 0u)
+                return in;
+            return unpack<false, B>(in, n, out, 0u);
+        }
+#endif
+#ifdef TURBOPFOR_SCALAR_UNPACK_AVX2
+        // Shared shuffle/srlv unpacker for narrow widths (when BMI2 is also
+        // enabled the PDEP path above has already taken B < 8). Each group
+        // load reads 16 bytes from the group's start — offset g*B within the
+        // block, furthest read 3B+16 bytes in — so a block may run wide only
+        // if 3B+16 bytes remain at its start; every block after the first
+        // consumes 4B, which bounds how many the bulk kernel may take. The
+        // word-based path finishes the rest exactly.
+        if constexpr (!Delta1 && B >= 1u && B < 16u && B != 8u)
+        {
+            const size_t avail = (static_cast<size_t>(n) * B + 7u) / 8u;
+            const size_t wide = std::min<size_t>(n / 32u, avail >= 3u * B + 16u ? (avail - (3u * B + 16u)) / (4u * B) + 1u : 0u);
+            if (wide != 0u)
+            {
+                // Streaming stores need a 32-byte-aligned destination; P4
+                // blocks (n <= 256) never reach the threshold, so exception
+                // patching always reads cached output.
+                if (n >= UNPACK_STREAM_THRESHOLD && (reinterpret_cast<uintptr_t>(out) & 31u) == 0u)
+                    in = unpack32Avx2Bulk<true>(in, out, wide, B);
+                else
+                    in = unpack32Avx2Bulk<false>(in, out, wide, B);
+                out += 32u * wide;
+                n -= static_cast<unsigned>(32u * wide);
+            }
+            while (n >= 32u)
+            {
+                in = unpack_n_b<false, B, 32>(in, out, 0u);
+                out += 32u;
+                n -= 32u;
+            }
+            if (n == 0u)
+                return in;
+            return unpack<false, B>(in, n, out, 0u);
+        }
+#endif
+#ifdef TURBOPFOR_SCALAR_BMI2
+        // PDEP field spreading for the mid widths. For B <= 15 one PDEP
+        // moves four fields into 16-bit slots (widened to dwords by
+        // cvtepu16); for B >= 17 into two 32-bit slots stored directly. This
+        // sits after the AVX2 shuffle kernel, which keeps B < 16 when it is
+        // compiled in, so here it typically serves 17..24. B = 16 stays on
+        // its dedicated halfword loop. The group loads read 8 bytes from a
+        // mid-group offset, so each loop runs only while the furthest read
+        // stays inside the packed stream; the word path finishes the tail.
+        if constexpr (!Delta1 && B >= 9u && B <= 24u && B != 16u)
+        {
+            size_t avail = (static_cast<size_t>(n) * B + 7u) / 8u;
+            if constexpr (B <= 15u)
+            {
+                constexpr uint64_t field_mask = ((1ull << B) - 1ull) * 0x0001000100010001ull;
+                // Fields 4..7 of a group start at bit 4B: byte off, bit sh
+                constexpr unsigned off = (4u * B) / 8u;
+                constexpr unsigned sh = (4u * B) % 8u;
+                while (n >= 8u && avail >= off + 8u)
+                {
+                    const uint64_t lo4 = _pdep_u64(loadU64Fast(in), field_mask);
+                    const uint64_t hi4 = _pdep_u64(loadU64Fast(in + off) >> sh, field_mask);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_cvtepu16_epi32(_mm_cvtsi64_si128(static_cast<long long>(lo4))));
+                    _mm_storeu_si128(
+                        reinterpret_cast<__m128i *>(out + 4u), _mm_cvtepu16_epi32(_mm_cvtsi64_si128(static_cast<long long>(hi4))));
+                    in += B;
+                    out += 8u;
+                    n -= 8u;
+                    avail -= B;
+                }
+            }
+            else
+            {
+                constexpr uint64_t field_mask = ((1ull << B) - 1ull) * 0x0000000100000001ull;
+                // Pair k of a group starts at bit 2kB: byte offK, bit shK
+                constexpr unsigned off1 = (2u * B) / 8u, sh1 = (2u * B) % 8u;
+                constexpr unsigned off2 = (4u * B) / 8u, sh2 = (4u * B) % 8u;
+                constexpr unsigned off3 = (6u * B) / 8u, sh3 = (6u * B) % 8u;
+                while (n >= 8u && avail >= off3 + 8u)
+                {
+                    unsigned char * op = reinterpret_cast<unsigned char *>(out);
+                    storeU64Fast(op, _pdep_u64(loadU64Fast(in), field_mask));
+                    storeU64Fast(op + 8u, _pdep_u64(loadU64Fast(in + off1) >> sh1, field_mask));
+                    storeU64Fast(op + 16u, _pdep_u64(loadU64Fast(in + off2) >> sh2, field_mask));
+                    storeU64Fast(op + 24u, _pdep_u64(loadU64Fast(in + off3) >> sh3, field_mask));
+                    in += B;
+                    out += 8u;
+                    n -= 8u;
+                    avail -= B;
+                }
+            }
+            while (n >= 32u)
+            {
+                in = unpack_n_b<false, B, 32>(in, out, 0u);
+                out += 32u;
+                n -= 32u;
+            }
+            if (n == 0u)
+                return in;
+            return unpack<false, B>(in, n, out, 0u);
+        }
+#endif
         // Process 32-element blocks
         uint32_t * end = out + (n & ~31);
-        while (out < end)
+        if constexpr (Delta1)
         {
-            if constexpr (Delta1)
+            while (out < end)
             {
-                in = unpack_n_b<true, B, 32>(in, out, start);
-                start = out[31];
+                in = unpack_d1_32<B>(in, out, start);
+                out += 32;
             }
-            else
+        }
+        else
+        {
+            // Unroll-and-jam: a 32-element block is exactly 4B bytes, so the
+            // second block's loads can start from in + block_bytes without
+            // waiting for the first block's pointer chain — twice the loads
+            // in flight, which matters most for the B >= 17 multi-word
+            // windows. (Not applicable to Delta1: its accumulator serializes
+            // the blocks anyway.)
+            constexpr unsigned block_bytes = 4u * B;
+            while (end - out >= 64)
+            {
+                unpack_n_b<false, B, 32>(in, out, 0u);
+                in = unpack_n_b<false, B, 32>(in + block_bytes, out + 32u, 0u);
+                out += 64;
+            }
+            while (out < end)
             {
                 in = unpack_n_b<false, B, 32>(in, out, 0u);
+                out += 32;
             }
-            out += 32;
         }
 
+        // Callers overwhelmingly decode whole 32-element blocks (P4 posting
+        // blocks are 128/256 values), so the residual path is cold.
         n &= 31;
-        if (n == 0u)
+        if (n == 0u) [[likely]]
             return in;
         if constexpr (Delta1)
             return unpack<true, B>(in, n, out, start);
@@ -355,15 +544,66 @@ struct Bitunpack32ScalarImpl
             return in;
         }
 
-        return table[b](in, n, out, start);
+        // Two-tier dispatch, mirroring Bitpack32ScalarImpl. Postings-style
+        // data concentrates in a narrow band of widths (roughly 4-12 bits,
+        // plus the byte-aligned 16 and 20), so only those get direct cases:
+        // the compiler sees the callee, inlines the per-width specialization,
+        // and the indirect branch disappears for the common widths. The rest
+        // stay behind one outlined table call in a cold section. The
+        // [[likely]] cases mark the peak of the width histogram so that with
+        // -fprofile-use absent the compiler still orders them first.
+        switch (b)
+        {
+            case 4u:
+                [[likely]] return bitunpack_b<4>(in, n, out, start);
+            case 5u:
+                [[likely]] return bitunpack_b<5>(in, n, out, start);
+            case 6u:
+                [[likely]] return bitunpack_b<6>(in, n, out, start);
+            case 7u:
+                [[likely]] return bitunpack_b<7>(in, n, out, start);
+            case 8u:
+                [[likely]] return bitunpack_b<8>(in, n, out, start);
+            case 9u:
+                return bitunpack_b<9>(in, n, out, start);
+            case 10u:
+                return bitunpack_b<10>(in, n, out, start);
+            case 11u:
+                return bitunpack_b<11>(in, n, out, start);
+            case 12u:
+                return bitunpack_b<12>(in, n, out, start);
+            case 16u:
+                return bitunpack_b<16>(in, n, out, start);
+            case 20u:
+                return bitunpack_b<20>(in, n, out, start);
+            default:
+                return dispatch_cold(in, n, out, start, b);
+        }
     }
 
-    static inline const Fn table[33] = {
-        nullptr,          &bitunpack_b<1>,  &bitunpack_b<2>,  &bitunpack_b<3>,  &bitunpack_b<4>,  &bitunpack_b<5>,  &bitunpack_b<6>,
-        &bitunpack_b<7>,  &bitunpack_b<8>,  &bitunpack_b<9>,  &bitunpack_b<10>, &bitunpack_b<11>, &bitunpack_b<12>, &bitunpack_b<13>,
-        &bitunpack_b<14>, &bitunpack_b<15>, &bitunpack_b<16>, &bitunpack_b<17>, &bitunpack_b<18>, &bitunpack_b<19>, &bitunpack_b<20>,
-        &bitunpack_b<21>, &bitunpack_b<22>, &bitunpack_b<23>, &bitunpack_b<24>, &bitunpack_b<25>, &bitunpack_b<26>, &bitunpack_b<27>,
-        &bitunpack_b<28>, &bitunpack_b<29>, &bitunpack_b<30>, &bitunpack_b<31>, &bitunpack_b<32>,
+    // Cold tier: widths outside the hot band go through the tables, outlined
+    // into a cold section so the rare specializations stop competing with the
+    // common widths for icache.
+    [[gnu::cold]] [[gnu::noinline]] static const unsigned char *
+    dispatch_cold(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start, unsigned b)
+    {
+        return b <= 16u ? hot_table[b - 1u](in, n, out, start) : cold_table[b - 17u](in, n, out, start);
+    }
+
+    // Split into two halves so the widths that occur in practice share cache
+    // lines only with each other: hot_table covers b = 1..16 (indexed b-1),
+    // cold_table covers b = 17..32 (indexed b-17). The ISA entry points also
+    // index these directly for their residual tails.
+    static inline const Fn hot_table[16] = {
+        &bitunpack_b<1>,  &bitunpack_b<2>,  &bitunpack_b<3>,  &bitunpack_b<4>,  &bitunpack_b<5>,  &bitunpack_b<6>,  &bitunpack_b<7>,
+        &bitunpack_b<8>,  &bitunpack_b<9>,  &bitunpack_b<10>, &bitunpack_b<11>, &bitunpack_b<12>, &bitunpack_b<13>, &bitunpack_b<14>,
+        &bitunpack_b<15>, &bitunpack_b<16>,
+    };
+
+    static inline const Fn cold_table[16] = {
+        &bitunpack_b<17>, &bitunpack_b<18>, &bitunpack_b<19>, &bitunpack_b<20>, &bitunpack_b<21>, &bitunpack_b<22>, &bitunpack_b<23>,
+        &bitunpack_b<24>, &bitunpack_b<25>, &bitunpack_b<26>, &bitunpack_b<27>, &bitunpack_b<28>, &bitunpack_b<29>, &bitunpack_b<30>,
+        &bitunpack_b<31>, &bitunpack_b<32>,
     };
 };
 
@@ -1,6 +1,19 @@
 #include "p4_scalar_internal.h"
 
 #include <algorithm>
+#include <array>
+
+#if defined(__x86_64__)
+#    include <immintrin.h>
+#    if defined(__SSSE3__)
+#        define TURBOPFOR_VBDEC32_SSSE3 1
+#    endif
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#    include <arm_neon.h>
+#    define TURBOPFOR_SCAN_NEON 1
+#endif
 
 namespace turbopfor::scalar::detail
 {
@@ -43,102 +56,76 @@ namespace
 // - Large values use direct storage with minimal overhead
 // - Self-describing: First byte indicates format (no separate length field needed)
 //
-// Note: Takes output pointer by reference; automatically advances 'out' to next position
-void vbPut32(unsigned char *& out, uint32_t x)
+// Note: Takes the output pointer by value and returns the advanced position:
+// a by-reference pointer forces the compiler to keep it addressable, which
+// spills op to the stack between iterations of the vbEnc32 loop. With the
+// value-in/value-out shape (and the forced inline), op lives in a register
+// across the whole encode loop.
+//
+// The encoder is branchless: the four nested magnitude tests used to cost a
+// chain of unpredictable branches per value on mixed exception data. Instead,
+// the size class is the sum of three threshold compares plus the 24-bit raw
+// split, small tables turn the class into a subtrahend / marker / shift /
+// mask, and every class stores the same way: marker-plus-high-bits in byte 0,
+// the masked low bits of delta in the bytes after it. One unconditional
+// 8-byte store covers all five layouts and advances by the class length —
+// the same transient overhang past the current position that vbPut64's raw
+// path already writes; later stream bytes overwrite it.
+TURBOPFOR_ALWAYS_INLINE unsigned char * vbPut32(unsigned char * out, uint32_t x)
 {
-    if (x < VBYTE_THRESHOLD_2BYTE) // x < 156
-    {
-        // 1-byte encoding: store value directly
-        *out++ = static_cast<uint8_t>(x);
-    }
-    else if (x < VBYTE_THRESHOLD_3BYTE) // x < 16540
-    {
-        // 2-byte encoding: marker (0x9C-0xDB) + 1 data byte
-        // Encode delta from threshold to maximize value range per byte
-        const unsigned delta = x - VBYTE_THRESHOLD_2BYTE;
-        *out++ = static_cast<uint8_t>(VBYTE_MARKER_2BYTE + (delta >> 8)); // High 6 bits in marker
-        *out++ = static_cast<uint8_t>(delta & 0xFFu); // Low 8 bits in data
-    }
-    else if (x < VBYTE_THRESHOLD_4PLUS) // x < 2113692
-    {
-        // 3-byte encoding: marker (0xDC-0xFB) + 2 data bytes (little-endian)
-        const unsigned delta = x - VBYTE_THRESHOLD_3BYTE;
-        *out++ = static_cast<uint8_t>(VBYTE_MARKER_3BYTE + (delta >> 16)); // High 5 bits in marker
-        *out++ = static_cast<uint8_t>(delta & 0xFFu); // Low byte
-        *out++ = static_cast<uint8_t>((delta >> 8) & 0xFFu); // Middle byte
-    }
-    else
-    {
-        // 4+ byte encoding: values [2113692, 2^32-1]
-        // For uint32_t, only 3-byte (marker 0xFC) or 4-byte (marker 0xFD) encodings are used
-        // Threshold: 24-bit max = 0xFFFFFF = 16777215
-        if (x <= 0xFFFFFFu) // 3-byte: values [2113692, 16777215]
-        {
-            *out++ = static_cast<uint8_t>(VBYTE_MARKER_4PLUS); // 0xFC
-            *out++ = static_cast<uint8_t>(x);
-            *out++ = static_cast<uint8_t>(x >> 8);
-            *out++ = static_cast<uint8_t>(x >> 16);
-        }
-        else // 4-byte: values [16777216, 2^32-1]
-        {
-            *out++ = static_cast<uint8_t>(VBYTE_MARKER_4PLUS + 1u); // 0xFD
-            storeU32Fast(out, x);
-            out += 4;
-        }
-    }
+    // Class 0: x           (1 byte,  [0x00..0x9B])
+    // Class 1: x - 156     (2 bytes, marker 0x9C + delta>>8, delta low byte)
+    // Class 2: x - 16540   (3 bytes, marker 0xDC + delta>>16, delta low 16 LE)
+    // Class 3: x raw 24    (4 bytes, marker 0xFC; x>>24 is 0 here)
+    // Class 4: x raw 32    (5 bytes, marker 0xFD; x>>32 is 0)
+    const unsigned c
+        = (x >= VBYTE_THRESHOLD_2BYTE) + (x >= VBYTE_THRESHOLD_3BYTE) + (x >= VBYTE_THRESHOLD_4PLUS) + (x > 0xFFFFFFu);
+    static constexpr uint32_t sub[5] = {0u, VBYTE_THRESHOLD_2BYTE, VBYTE_THRESHOLD_3BYTE, 0u, 0u};
+    static constexpr uint8_t marker[5] = {0u, VBYTE_MARKER_2BYTE, VBYTE_MARKER_3BYTE, VBYTE_MARKER_4PLUS, VBYTE_MARKER_4PLUS + 1u};
+    static constexpr unsigned hi_shift[5] = {0u, 8u, 16u, 24u, 32u};
+    static constexpr uint64_t lo_mask[5] = {0u, 0xFFu, 0xFFFFu, 0xFFFFFFu, 0xFFFFFFFFu};
+
+    const uint64_t delta = x - sub[c];
+    const uint64_t packed = (marker[c] + (delta >> hi_shift[c])) | ((delta & lo_mask[c]) << 8);
+    storeU64Fast(out, packed);
+    return out + c + 1u;
 }
 
-// Decode a single variable-byte encoded uint32_t value.
-//
-// Decoding logic (inverse of vbPut32):
-// - Read first byte (marker) to determine format
-// - Extract encoded value based on marker range
-// - Return pointer to next unread byte
-//
-// Marker ranges (matching vbPut32 encoding):
-// - [0x00..0x9B]: 1-byte encoding (value = marker)
-// - [0x9C..0xDB]: 2-byte encoding (value = 156 + decode(marker, data_byte))
-// - [0xDC..0xFB]: 3-byte encoding (value = 16540 + decode(marker, data_bytes))
-// - [0xFC..0xFD]: 4+ byte encoding (read raw bytes)
-//
-// Returns: Pointer to next byte after the decoded value
-const unsigned char * vbGet32(const unsigned char * in, uint32_t & x)
+// Exact encoded size of n values under vbPut32's class scheme: each value
+// costs 1 byte plus one per crossed threshold, which is the same compare sum
+// the encoder uses for its size class. Vectorized as four unsigned compares
+// (sign-flipped pcmpgtd) accumulated by lane, so vbEnc32 can decide up front
+// whether the stream will hit the uncompressed fallback.
+size_t vbSize32(const uint32_t * in, unsigned n)
 {
-    const unsigned marker = *in++;
-
-    if (marker < VBYTE_MARKER_2BYTE) // marker < 0x9C
-    {
-        // 1-byte encoding: value stored directly in marker
-        x = marker;
-        return in;
-    }
-
-    if (marker < VBYTE_MARKER_3BYTE) // marker < 0xDC
-    {
-        // 2-byte encoding: reconstruct value from marker + 1 data byte
-        // Inverse of: marker = 0x9C + (delta >> 8), data = delta & 0xFF
-        const unsigned data_byte = *in++;
-        const uint32_t delta = ((marker - VBYTE_MARKER_2BYTE) << 8) + data_byte;
-        x = delta + VBYTE_THRESHOLD_2BYTE;
-        return in;
-    }
-
-    if (marker < VBYTE_MARKER_4PLUS) // marker < 0xFC
+    size_t total = n; // one byte minimum per value
+    unsigned i = 0;
+
+#if defined(__x86_64__)
+    const __m128i sign = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i t1 = _mm_set1_epi32(static_cast<int>((VBYTE_THRESHOLD_2BYTE - 1u) ^ 0x80000000u));
+    const __m128i t2 = _mm_set1_epi32(static_cast<int>((VBYTE_THRESHOLD_3BYTE - 1u) ^ 0x80000000u));
+    const __m128i t3 = _mm_set1_epi32(static_cast<int>((VBYTE_THRESHOLD_4PLUS - 1u) ^ 0x80000000u));
+    const __m128i t4 = _mm_set1_epi32(static_cast<int>(0xFFFFFFu ^ 0x80000000u));
+    __m128i acc = _mm_setzero_si128();
+    for (; i + 4u <= n; i += 4u)
     {
-        const unsigned low16 = loadU16Fast(in);
-        x = low16 + ((marker - VBYTE_MARKER_3BYTE) << 16) + VBYTE_THRESHOLD_3BYTE;
-        return in + 2;
+        const __m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), sign);
+        // each pcmpgtd lane is 0 or -1; subtracting counts the crossings
+        acc = _mm_sub_epi32(acc, _mm_add_epi32(_mm_add_epi32(_mm_cmpgt_epi32(v, t1), _mm_cmpgt_epi32(v, t2)),
+                                               _mm_add_epi32(_mm_cmpgt_epi32(v, t3), _mm_cmpgt_epi32(v, t4))));
     }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    total += static_cast<unsigned>(_mm_cvtsi128_si32(acc));
+#endif
 
-    // 4+ byte encoding: 0xFC = 3 bytes, 0xFD = 4 bytes
-    if (marker == VBYTE_MARKER_4PLUS)
+    for (; i < n; ++i)
     {
-        x = loadU32Fast(in) & 0xFFFFFFu;
-        return in + 3;
+        const uint32_t x = in[i];
+        total += (x >= VBYTE_THRESHOLD_2BYTE) + (x >= VBYTE_THRESHOLD_3BYTE) + (x >= VBYTE_THRESHOLD_4PLUS) + (x > 0xFFFFFFu);
     }
-
-    x = loadU32Fast(in);
-    return in + 4;
+    return total;
 }
 
 } // namespace
@@ -162,27 +149,13 @@ const unsigned char * vbGet32(const unsigned char * in, uint32_t & x)
 // Returns: Pointer to end of encoded data
 unsigned char * vbEnc32(const uint32_t * in, unsigned n, unsigned char * out)
 {
-    // Encode all values using variable-byte encoding
-    // Note: vbPut32 takes 'unsigned char * &', so op advances automatically
-    unsigned char * op = out;
-    for (unsigned i = 0; i < n; ++i)
-        vbPut32(op, in[i]);
-
-    // Adaptive compression decision: Check if encoding provides significant space savings
-    //
-    // Condition breakdown:
-    //   op             = pointer to end of encoded data (advanced by vbPut32 calls)
-    //   op - out       = actual compressed size in bytes
-    //   op + 32        = compressed size + 32-byte threshold
-    //   out + n * 4    = pointer to end position if stored uncompressed
-    //
-    // If (op + 32 > out + n * 4), then:
-    //   (op - out) + 32 > n * 4
-    //   compressed_size + 32 > original_size
-    //   compressed_size > original_size - 32
-    //
-    // This means compression saves less than 32 bytes, so use uncompressed format instead
-    if (op + 32 > out + n * sizeof(uint32_t))
+    // Adaptive compression decision, taken up front: vbSize32 computes the
+    // exact encoded size from the same threshold compares the encoder uses,
+    // so poorly-compressible data goes straight to the memcpy fallback
+    // instead of being encoded first and thrown away. Compression must save
+    // at least 32 bytes over raw storage to be worth the decode overhead.
+    const size_t predicted_size = vbSize32(in, n);
+    if (predicted_size + 32u > size_t{n} * sizeof(uint32_t))
     {
         // Compression ineffective: Store uncompressed data with escape marker
         // Format: [0xFF][uint32_t values...]
@@ -192,10 +165,152 @@ unsigned char * vbEnc32(const uint32_t * in, unsigned n, unsigned char * out)
         return out + 1 + n * sizeof(uint32_t);
     }
 
-    // Compression effective: Return pointer to end of variable-byte encoded data
+    unsigned char * op = out;
+
+#if defined(__x86_64__) && defined(__SSE4_1__)
+    // Dense small-value blocks where every value sits below the 2-byte
+    // threshold encode as one raw byte each — exactly the case where the
+    // predicted size equals n. Narrow 16 lanes per step with two saturating
+    // packs instead of running vbPut32's class logic per value; the
+    // saturation never triggers since all values are < 156.
+    if (predicted_size == size_t{n})
+    {
+        unsigned i = 0;
+        for (; i + 16u <= n; i += 16u)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 4u));
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 8u));
+            const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 12u));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(op), _mm_packus_epi16(_mm_packus_epi32(a, b), _mm_packus_epi32(c, d)));
+            op += 16u;
+        }
+        for (; i < n; ++i)
+            *op++ = static_cast<unsigned char>(in[i]);
+        return op;
+    }
+#endif
+
+    // Encode all values using variable-byte encoding
+    for (unsigned i = 0; i < n; ++i)
+        op = vbPut32(op, in[i]);
     return op;
 }
 
+#ifdef TURBOPFOR_VBDEC32_SSSE3
+
+namespace
+{
+
+// Length of a vbyte-encoded value from its leading byte. The 5-byte class
+// (marker 0xFD) gets a 16 sentinel so one compare rejects a whole group.
+constexpr std::array<uint8_t, 256> makeVbLen32()
+{
+    std::array<uint8_t, 256> t{};
+    for (unsigned f = 0; f < 256u; ++f)
+    {
+        if (f < VBYTE_MARKER_2BYTE)
+            t[f] = 1u;
+        else if (f < VBYTE_MARKER_3BYTE)
+            t[f] = 2u;
+        else if (f < VBYTE_MARKER_4PLUS)
+            t[f] = 3u;
+        else if (f == VBYTE_MARKER_4PLUS)
+            t[f] = 4u;
+        else
+            t[f] = 16u;
+    }
+    return t;
+}
+
+constexpr std::array<uint8_t, 256> vb_len32 = makeVbLen32();
+
+// Per-key controls for the 4-at-a-time shuffle decode. The key packs the
+// four lane lengths (1..4 bytes) into 2 bits each. shuf routes every lane's
+// data bytes into the low positions of its dword with the marker byte above
+// them (dropped entirely for the 4-byte raw class); adj then removes the
+// marker and adds back the class base in one subtract:
+//   2-byte: lane = data | marker<<8,            v = lane - (0x9C<<8  - 156)
+//   3-byte: lane = lo16 | marker<<16,           v = lane - (0xDC<<16 - 16540)
+//   1-/4-byte lanes need no adjustment.
+struct VbShuffleCtrl
+{
+    alignas(16) char shuf[16];
+    alignas(16) uint32_t adj[4];
+};
+
+constexpr VbShuffleCtrl makeVbShuffleCtrl(unsigned key)
+{
+    VbShuffleCtrl c{};
+    unsigned off = 0;
+    for (unsigned lane = 0; lane < 4u; ++lane)
+    {
+        const unsigned len = ((key >> (2u * lane)) & 3u) + 1u;
+        char * sh = c.shuf + 4u * lane;
+        sh[0] = sh[1] = sh[2] = sh[3] = char(-1);
+        switch (len)
+        {
+            case 1u:
+                sh[0] = static_cast<char>(off);
+                c.adj[lane] = 0u;
+                break;
+            case 2u:
+                sh[0] = static_cast<char>(off + 1u);
+                sh[1] = static_cast<char>(off);
+                c.adj[lane] = (uint32_t{VBYTE_MARKER_2BYTE} << 8) - VBYTE_THRESHOLD_2BYTE;
+                break;
+            case 3u:
+                sh[0] = static_cast<char>(off + 1u);
+                sh[1] = static_cast<char>(off + 2u);
+                sh[2] = static_cast<char>(off);
+                c.adj[lane] = (uint32_t{VBYTE_MARKER_3BYTE} << 16) - VBYTE_THRESHOLD_3BYTE;
+                break;
+            default:
+                sh[0] = static_cast<char>(off + 1u);
+                sh[1] = static_cast<char>(off + 2u);
+                sh[2] = static_cast<char>(off + 3u);
+                c.adj[lane] = 0u;
+                break;
+        }
+        off += len;
+    }
+    return c;
+}
+
+constexpr std::array<VbShuffleCtrl, 256> makeVbShuffleCtrlTable()
+{
+    std::array<VbShuffleCtrl, 256> t{};
+    for (unsigned key = 0; key < 256u; ++key)
+        t[key] = makeVbShuffleCtrl(key);
+    return t;
+}
+
+constexpr std::array<VbShuffleCtrl, 256> vbShuffleCtrl = makeVbShuffleCtrlTable();
+
+// Byte-validity mask per key for masked-permute decoders: bit j set when
+// shuf[j] carries a real source byte (pshufb zeroes the -1 slots itself, a
+// masked vpermb needs the mask spelled out).
+constexpr std::array<uint16_t, 256> makeVbShuffleValidTable()
+{
+    std::array<uint16_t, 256> t{};
+    for (unsigned key = 0; key < 256u; ++key)
+    {
+        const VbShuffleCtrl c = makeVbShuffleCtrl(key);
+        uint16_t mask = 0;
+        for (unsigned j = 0; j < 16u; ++j)
+            if (c.shuf[j] >= 0)
+                mask |= static_cast<uint16_t>(1u << j);
+        t[key] = mask;
+    }
+    return t;
+}
+
+constexpr std::array<uint16_t, 256> vbShuffleValid = makeVbShuffleValidTable();
+
+} // namespace
+
+#endif
+
 // Decode array of n uint32_t values from adaptive variable-byte encoding.
 //
 // Handles two formats produced by vbEnc32:
@@ -212,7 +327,76 @@ unsigned char * vbEnc32(const uint32_t * in, unsigned n, unsigned char * out)
 // - The 32-byte threshold in vbEnc32 ensures we only use compression when worthwhile
 //
 // Returns: Pointer to end of consumed input data
-const unsigned char * vbDec32(const unsigned char * in, unsigned n, uint32_t * out)
+//
+// The compressed-path body below is shared by the portable entry and the
+// AVX-512 octet decoder, which hands over whatever it leaves unfinished.
+static const unsigned char * vbDec32Compressed(const unsigned char * ip, unsigned n, uint32_t * out, unsigned i)
+{
+#ifdef TURBOPFOR_VBDEC32_SSSE3
+    // 4-at-a-time shuffle decode. Lengths come from the leading byte of each
+    // value, so the four dependent table loads are the only serial part; the
+    // packed-length key then selects a pshufb mask and adjustment vector that
+    // turn 16 input bytes into four dword lanes at once. The 16-byte load is
+    // exact while at least 16 stream bytes remain, which holds whenever 20+
+    // values are still to be decoded (this group spans >= 4 bytes and every
+    // later value at least one). Groups with a 5-byte value fall through to
+    // the scalar loop via the length sentinel.
+    while (n - i >= 20u)
+    {
+        const unsigned l0 = vb_len32[ip[0]];
+        const unsigned l1 = vb_len32[ip[l0]];
+        const unsigned l2 = vb_len32[ip[l0 + l1]];
+        const unsigned l3 = vb_len32[ip[l0 + l1 + l2]];
+        const unsigned total = l0 + l1 + l2 + l3;
+        if (total > 16u)
+            break;
+        const unsigned key = (l0 - 1u) | ((l1 - 1u) << 2) | ((l2 - 1u) << 4) | ((l3 - 1u) << 6);
+        const VbShuffleCtrl & c = vbShuffleCtrl[key];
+        const __m128i lanes
+            = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(ip)), _mm_load_si128(reinterpret_cast<const __m128i *>(c.shuf)));
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(out + i), _mm_sub_epi32(lanes, _mm_load_si128(reinterpret_cast<const __m128i *>(c.adj))));
+        ip += total;
+        i += 4u;
+    }
+#endif
+
+    // Branchless scalar decode (also catches 5-byte groups the shuffle loop
+    // rejects). Its unconditional 4-byte payload load stays inside the
+    // stream while at least 4 more values follow the current one.
+    for (; i + 5u <= n; ++i)
+    {
+        ip = vbGet32Branchless(ip, out[i]);
+    }
+
+    // Last few values: the stream no longer guarantees the 4 payload bytes
+    // the branchless decoder reads past each marker, and the wire format is
+    // fixed so the encoder cannot promise tail slack. Bounce the exact
+    // remaining bytes into a zero-padded stack buffer instead — lengths come
+    // from the marker LUT, so the source reads stay inside the stream — and
+    // keep using the same branchless decoder there rather than falling back
+    // to the branchy exact-load one.
+    if (i < n)
+    {
+        unsigned char tail[4u * 5u + 4u] = {}; // <= 4 values of <= 5 bytes, plus decoder slack
+        unsigned tail_len = 0;
+        for (unsigned k = i; k < n; ++k)
+        {
+            const unsigned len = vbMarkerInfo[ip[0]].len;
+            for (unsigned j = 0; j < len; ++j)
+                tail[tail_len + j] = ip[j];
+            tail_len += len;
+            ip += len;
+        }
+        const unsigned char * tp = tail;
+        for (; i < n; ++i)
+            tp = vbGet32Branchless(tp, out[i]);
+    }
+
+    return ip;
+}
+
+static const unsigned char * vbDec32Portable(const unsigned char * in, unsigned n, uint32_t * out)
 {
     // Check format by examining first byte
     if (*in == VBYTE_ESCAPE_UNCOMPRESSED)
@@ -224,18 +408,712 @@ const unsigned char * vbDec32(const unsigned char * in, unsigned n, uint32_t * o
         return in + 1 + n * sizeof(uint32_t);
     }
 
-    // Compressed format: Variable-byte encoded values
-    // Decode each value sequentially using vbGet32Inline
-    // Note: vbGet32Inline returns updated input pointer after consuming variable bytes
+    return vbDec32Compressed(in, n, out, 0u);
+}
+
+#if defined(TURBOPFOR_VBDEC32_SSSE3) && defined(__ELF__)
+
+/// 8-at-a-time decode for CPUs with AVX-512 VBMI: one 32-byte load and one
+/// masked vpermb replace two pshufb groups. The permute index concatenates
+/// the two quads' shuffle controls (the high quad's offset by the low quad's
+/// byte total) and the validity masks supply the zeroing pshufb got from its
+/// -1 slots. The serial part is still the eight dependent length lookups.
+__attribute__((target("avx512f,avx512bw,avx512vl,avx512vbmi"))) static const unsigned char *
+vbDec32Avx512(const unsigned char * in, unsigned n, uint32_t * out)
+{
+    if (*in == VBYTE_ESCAPE_UNCOMPRESSED)
+    {
+        copyU32ArrayFromLe(out, in + 1, n);
+        return in + 1 + n * sizeof(uint32_t);
+    }
+
     const unsigned char * ip = in;
-    for (unsigned i = 0; i < n; ++i)
+    unsigned i = 0;
+
+    // The 32-byte load is exact while 32 stream bytes remain, guaranteed by
+    // 32+ values still to decode (one byte minimum each). A quad with a
+    // 5-byte value trips its 16-byte ceiling and falls through.
+    while (n - i >= 32u)
     {
-        ip = vbGet32Inline(ip, out[i]);
+        const unsigned l0 = vb_len32[ip[0]];
+        const unsigned l1 = vb_len32[ip[l0]];
+        const unsigned l2 = vb_len32[ip[l0 + l1]];
+        const unsigned l3 = vb_len32[ip[l0 + l1 + l2]];
+        const unsigned total_lo = l0 + l1 + l2 + l3;
+        const unsigned l4 = vb_len32[ip[total_lo]];
+        const unsigned l5 = vb_len32[ip[total_lo + l4]];
+        const unsigned l6 = vb_len32[ip[total_lo + l4 + l5]];
+        const unsigned l7 = vb_len32[ip[total_lo + l4 + l5 + l6]];
+        const unsigned total_hi = l4 + l5 + l6 + l7;
+        if (total_lo > 16u || total_hi > 16u)
+            break;
+        const unsigned key_lo = (l0 - 1u) | ((l1 - 1u) << 2) | ((l2 - 1u) << 4) | ((l3 - 1u) << 6);
+        const unsigned key_hi = (l4 - 1u) | ((l5 - 1u) << 2) | ((l6 - 1u) << 4) | ((l7 - 1u) << 6);
+        const VbShuffleCtrl & clo = vbShuffleCtrl[key_lo];
+        const VbShuffleCtrl & chi = vbShuffleCtrl[key_hi];
+        const __m128i idx_lo = _mm_load_si128(reinterpret_cast<const __m128i *>(clo.shuf));
+        // Stale -1 slots may turn into in-range indices after the offset;
+        // the validity mask zeroes those bytes regardless.
+        const __m128i idx_hi = _mm_add_epi8(
+            _mm_load_si128(reinterpret_cast<const __m128i *>(chi.shuf)), _mm_set1_epi8(static_cast<char>(total_lo)));
+        const __mmask32 valid = static_cast<__mmask32>(vbShuffleValid[key_lo]) | (static_cast<__mmask32>(vbShuffleValid[key_hi]) << 16);
+        const __m256i lanes = _mm256_maskz_permutexvar_epi8(
+            valid, _mm256_set_m128i(idx_hi, idx_lo), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ip)));
+        const __m256i adj = _mm256_set_m128i(
+            _mm_load_si128(reinterpret_cast<const __m128i *>(chi.adj)), _mm_load_si128(reinterpret_cast<const __m128i *>(clo.adj)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_sub_epi32(lanes, adj));
+        ip += total_lo + total_hi;
+        i += 8u;
     }
 
-    return ip;
+    return vbDec32Compressed(ip, n, out, i);
+}
+
+/// 8-at-a-time decode for AVX2 hosts (no VBMI byte permute): the two quads
+/// are shuffled with independent 128-bit pshufbs — the second load starts at
+/// the low quad's byte total, so no cross-lane routing is needed — and the
+/// halves merge into one 256-bit subtract and store. Same length-ladder
+/// serial part and 5-byte fall-through as the VBMI variant.
+__attribute__((target("avx2"))) static const unsigned char * vbDec32Avx2(const unsigned char * in, unsigned n, uint32_t * out)
+{
+    if (*in == VBYTE_ESCAPE_UNCOMPRESSED)
+    {
+        copyU32ArrayFromLe(out, in + 1, n);
+        return in + 1 + n * sizeof(uint32_t);
+    }
+
+    const unsigned char * ip = in;
+    unsigned i = 0;
+
+    // Both 16-byte loads stay inside the stream while 32 bytes remain,
+    // guaranteed by 32+ values still to decode (the high-quad load starts
+    // at total_lo <= 16 and spans 16 bytes). A quad with a 5-byte value
+    // trips its 16-byte ceiling and falls through.
+    while (n - i >= 32u)
+    {
+        const unsigned l0 = vb_len32[ip[0]];
+        const unsigned l1 = vb_len32[ip[l0]];
+        const unsigned l2 = vb_len32[ip[l0 + l1]];
+        const unsigned l3 = vb_len32[ip[l0 + l1 + l2]];
+        const unsigned total_lo = l0 + l1 + l2 + l3;
+        const unsigned l4 = vb_len32[ip[total_lo]];
+        const unsigned l5 = vb_len32[ip[total_lo + l4]];
+        const unsigned l6 = vb_len32[ip[total_lo + l4 + l5]];
+        const unsigned l7 = vb_len32[ip[total_lo + l4 + l5 + l6]];
+        const unsigned total_hi = l4 + l5 + l6 + l7;
+        if (total_lo > 16u || total_hi > 16u)
+            break;
+        const unsigned key_lo = (l0 - 1u) | ((l1 - 1u) << 2) | ((l2 - 1u) << 4) | ((l3 - 1u) << 6);
+        const unsigned key_hi = (l4 - 1u) | ((l5 - 1u) << 2) | ((l6 - 1u) << 4) | ((l7 - 1u) << 6);
+        const VbShuffleCtrl & clo = vbShuffleCtrl[key_lo];
+        const VbShuffleCtrl & chi = vbShuffleCtrl[key_hi];
+        const __m128i v_lo = _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(ip)), _mm_load_si128(reinterpret_cast<const __m128i *>(clo.shuf)));
+        const __m128i v_hi = _mm_shuffle_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(ip + total_lo)),
+            _mm_load_si128(reinterpret_cast<const __m128i *>(chi.shuf)));
+        const __m256i adj = _mm256_set_m128i(
+            _mm_load_si128(reinterpret_cast<const __m128i *>(chi.adj)), _mm_load_si128(reinterpret_cast<const __m128i *>(clo.adj)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_sub_epi32(_mm256_set_m128i(v_hi, v_lo), adj));
+        ip += total_lo + total_hi;
+        i += 8u;
+    }
+
+    return vbDec32Compressed(ip, n, out, i);
+}
+
+// IFUNC resolver: pick the octet decoder once at load time, same scheme as
+// the bitunpack32 entry.
+extern "C" void * turbopforResolveVbDec32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512vbmi") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl"))
+        return reinterpret_cast<void *>(&vbDec32Avx512);
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&vbDec32Avx2);
+    return reinterpret_cast<void *>(&vbDec32Portable);
+}
+
+const unsigned char * vbDec32(const unsigned char * in, unsigned n, uint32_t * out) __attribute__((ifunc("turbopforResolveVbDec32")));
+
+#else
+
+const unsigned char * vbDec32(const unsigned char * in, unsigned n, uint32_t * out)
+{
+    return vbDec32Portable(in, n, out);
+}
+
+#endif
+
+// Positions of the set bits of a byte, packed one per byte starting at the
+// low end (unused slots stay 0 and are never consumed). Adding the byte's
+// base bit offset to every lane at once turns one entry into up to eight
+// ready-to-use value indices.
+constexpr std::array<uint64_t, 256> makeBytePositions()
+{
+    std::array<uint64_t, 256> table{};
+    for (unsigned byte = 0; byte < 256u; ++byte)
+    {
+        uint64_t packed = 0;
+        unsigned slot = 0;
+        for (unsigned bit = 0; bit < 8u; ++bit)
+            if (byte & (1u << bit))
+                packed |= static_cast<uint64_t>(bit) << (8u * slot++);
+        table[byte] = packed;
+    }
+    return table;
+}
+
+constexpr std::array<uint64_t, 256> bytePositions = makeBytePositions();
+
+static void expandBitmapIndicesPortable(const uint64_t * bitmap, unsigned words, unsigned char * idx)
+{
+    unsigned k = 0;
+    for (unsigned i = 0; i < words; ++i)
+    {
+        const uint64_t word = bitmap[i];
+        for (unsigned j = 0; j < 8u; ++j)
+        {
+            const unsigned byte = static_cast<unsigned>(word >> (8u * j)) & 0xFFu;
+            const uint64_t base = static_cast<uint64_t>(i * 64u + j * 8u) * 0x0101010101010101ull;
+            storeU64Fast(idx + k, bytePositions[byte] + base);
+            k += popcount64(byte);
+        }
+    }
+}
+
+#if defined(__x86_64__) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+
+/// AVX512-VBMI2 tier: the bitmap word is already the write mask VPCOMPRESSB
+/// wants, so each 64-bit word becomes one compress-store of an iota vector —
+/// no per-byte table walk, and exactly popcount lanes are written (still
+/// within the 8 bytes of slack the portable expansion may touch).
+__attribute__((target("avx512f,avx512bw,avx512vbmi2"))) static void
+expandBitmapIndicesAvx512(const uint64_t * bitmap, unsigned words, unsigned char * idx)
+{
+    alignas(64) static constexpr uint8_t iota[64]
+        = {0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21,
+           22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43,
+           44, 45, 46, 47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62, 63};
+    const __m512i lane_id = _mm512_load_si512(iota);
+
+    unsigned k = 0;
+    for (unsigned i = 0; i < words; ++i)
+    {
+        const uint64_t word = bitmap[i];
+        const __m512i positions = _mm512_add_epi8(lane_id, _mm512_set1_epi8(static_cast<char>(i * 64u)));
+        _mm512_mask_compressstoreu_epi8(idx + k, _cvtu64_mask64(word), positions);
+        k += popcount64(word);
+    }
+}
+
+// IFUNC resolver: pick the expansion once at load time, same scheme as the
+// dense patch kernel below.
+extern "C" void * turbopforResolveExpandBitmapIndices()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512vbmi2") && __builtin_cpu_supports("avx512bw"))
+        return reinterpret_cast<void *>(&expandBitmapIndicesAvx512);
+    return reinterpret_cast<void *>(&expandBitmapIndicesPortable);
+}
+
+void expandBitmapIndices(const uint64_t * bitmap, unsigned words, unsigned char * idx)
+    __attribute__((ifunc("turbopforResolveExpandBitmapIndices")));
+
+#else
+
+void expandBitmapIndices(const uint64_t * bitmap, unsigned words, unsigned char * idx)
+{
+    expandBitmapIndicesPortable(bitmap, words, idx);
+}
+
+#endif
+
+// Two-pass dense patch: unpack the fields through the vector unpacker (its
+// setup amortizes at these counts), expand the bitmap once, then run the
+// patch loop where every iteration is independent — no ctz chain.
+static void
+bitunpackPatchDense32Portable(const unsigned char * in, unsigned count, uint32_t * out, unsigned b, unsigned bx, const uint64_t * bitmap, unsigned words)
+{
+    alignas(16) uint32_t ex[MAX_VALUES + 64];
+    bitunpack32Scalar(in, count, ex, bx);
+
+    unsigned char idx[MAX_VALUES + 8];
+    expandBitmapIndices(bitmap, words, idx);
+
+    for (unsigned k = 0; k < count; ++k)
+        out[idx[k]] |= ex[k] << b;
+}
+
+#if defined(__x86_64__) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+
+/// AVX-512F dense patch: walk the bitmap 16 lanes at a time, expand the
+/// next run of exception fields into their lanes (VPEXPANDD — the mirror of
+/// the encoder's compress-store), shift into position and OR into the
+/// masked-loaded destination. Expansion leaves zero in non-exception lanes,
+/// so the merge is a single logic uop per vector, and the masked load/store
+/// pair touches only exception lanes — no gather/scatter and no expanded
+/// index array. Dense blocks have at least one exception per eight lanes,
+/// so most 16-lane groups do real work.
+__attribute__((target("avx512f"))) static void
+bitunpackPatchDense32Avx512(const unsigned char * in, unsigned count, uint32_t * out, unsigned b, unsigned bx, const uint64_t * bitmap, unsigned words)
+{
+    alignas(64) uint32_t ex[MAX_VALUES + 64];
+    bitunpack32Scalar(in, count, ex, bx);
+
+    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(b));
+    unsigned k = 0;
+    for (unsigned w = 0; w < words; ++w)
+    {
+        const uint64_t word = bitmap[w];
+        for (unsigned g = 0; g < 4u; ++g)
+        {
+            const __mmask16 m = static_cast<__mmask16>(word >> (16u * g));
+            if (m == 0u)
+                continue;
+            uint32_t * const dst = out + w * 64u + g * 16u;
+            const __m512i fields = _mm512_sll_epi32(_mm512_maskz_expandloadu_epi32(m, ex + k), shift);
+            const __m512i cur = _mm512_maskz_loadu_epi32(m, dst);
+            _mm512_mask_storeu_epi32(dst, m, _mm512_or_si512(cur, fields));
+            k += static_cast<unsigned>(__builtin_popcount(static_cast<unsigned>(m)));
+        }
+    }
+}
+
+// IFUNC resolver: pick the dense patch kernel once at load time, same scheme
+// as the bitunpack32 and vbDec32 entries.
+extern "C" void * turbopforResolveBitunpackPatchDense32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return reinterpret_cast<void *>(&bitunpackPatchDense32Avx512);
+    return reinterpret_cast<void *>(&bitunpackPatchDense32Portable);
+}
+
+void bitunpackPatchDense32(const unsigned char * in, unsigned count, uint32_t * out, unsigned b, unsigned bx, const uint64_t * bitmap, unsigned words)
+    __attribute__((ifunc("turbopforResolveBitunpackPatchDense32")));
+
+#else
+
+void bitunpackPatchDense32(const unsigned char * in, unsigned count, uint32_t * out, unsigned b, unsigned bx, const uint64_t * bitmap, unsigned words)
+{
+    bitunpackPatchDense32Portable(in, count, out, b, bx, bitmap, words);
+}
+
+#endif
+
+// Position-list merge for vbyte-format exceptions, unrolled 8x to match the
+// bitmap-path dense loop. Every iteration is independent — the positions
+// are distinct — so the unroll just widens the store window.
+static void patchPositions32Portable(uint32_t * out, const unsigned char * pos, const uint32_t * ex, unsigned b, unsigned count)
+{
+    unsigned k = 0;
+    const unsigned count8 = count & ~7u;
+    for (; k < count8; k += 8u)
+    {
+        out[pos[k + 0u]] |= ex[k + 0u] << b;
+        out[pos[k + 1u]] |= ex[k + 1u] << b;
+        out[pos[k + 2u]] |= ex[k + 2u] << b;
+        out[pos[k + 3u]] |= ex[k + 3u] << b;
+        out[pos[k + 4u]] |= ex[k + 4u] << b;
+        out[pos[k + 5u]] |= ex[k + 5u] << b;
+        out[pos[k + 6u]] |= ex[k + 6u] << b;
+        out[pos[k + 7u]] |= ex[k + 7u] << b;
+    }
+    for (; k < count; ++k)
+        out[pos[k]] |= ex[k] << b;
+}
+
+#if defined(__x86_64__) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+
+/// AVX2 position merge: the gather parallelizes the dependent
+/// position-load / out-load pairs; the merged lanes come back through a
+/// register block and store back as eight independent scalar stores (AVX2
+/// has no scatter).
+__attribute__((target("avx2"))) static void patchPositions32Avx2(uint32_t * out, const unsigned char * pos, const uint32_t * ex, unsigned b, unsigned count)
+{
+    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(b));
+    unsigned k = 0;
+    for (; k + 8u <= count; k += 8u)
+    {
+        const __m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(pos + k)));
+        const __m256i fields = _mm256_sll_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(ex + k)), shift);
+        const __m256i cur = _mm256_i32gather_epi32(reinterpret_cast<const int *>(out), lanes, 4);
+        alignas(32) uint32_t merged[8];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(merged), _mm256_or_si256(cur, fields));
+        for (unsigned j = 0; j < 8u; ++j)
+            out[pos[k + j]] = merged[j];
+    }
+    for (; k < count; ++k)
+        out[pos[k]] |= ex[k] << b;
+}
+
+/// AVX-512F position merge: full gather / OR / scatter, 16 patches per
+/// iteration. Distinct positions mean no scatter lane conflicts.
+__attribute__((target("avx512f"))) static void patchPositions32Avx512(uint32_t * out, const unsigned char * pos, const uint32_t * ex, unsigned b, unsigned count)
+{
+    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(b));
+    unsigned k = 0;
+    for (; k + 16u <= count; k += 16u)
+    {
+        const __m512i lanes = _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(pos + k)));
+        const __m512i fields = _mm512_sll_epi32(_mm512_loadu_si512(ex + k), shift);
+        const __m512i cur = _mm512_i32gather_epi32(lanes, out, 4);
+        _mm512_i32scatter_epi32(out, lanes, _mm512_or_si512(cur, fields), 4);
+    }
+    for (; k < count; ++k)
+        out[pos[k]] |= ex[k] << b;
+}
+
+extern "C" void * turbopforResolvePatchPositions32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return reinterpret_cast<void *>(&patchPositions32Avx512);
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&patchPositions32Avx2);
+    return reinterpret_cast<void *>(&patchPositions32Portable);
+}
+
+void patchPositions32(uint32_t * out, const unsigned char * pos, const uint32_t * ex, unsigned b, unsigned count)
+    __attribute__((ifunc("turbopforResolvePatchPositions32")));
+
+#else
+
+void patchPositions32(uint32_t * out, const unsigned char * pos, const uint32_t * ex, unsigned b, unsigned count)
+{
+    patchPositions32Portable(out, pos, ex, b, count);
+}
+
+#endif
+
+// Portable block split: SSE2 movemask scan builds base[] and the bitmap,
+// then the exception values are gathered through the expanded position list.
+static unsigned
+scanExceptions32Portable(const uint32_t * in, unsigned n, uint32_t base_mask, unsigned b, uint32_t * base, uint64_t * bitmap, uint32_t * exceptions)
+{
+    unsigned i = 0;
+#if defined(__SSE2__)
+    const __m128i msk_vec = _mm_set1_epi32(static_cast<int>(base_mask));
+    for (; i + 4u <= n; i += 4u)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(base + i), _mm_and_si128(v, msk_vec));
+
+        // v > base_mask iff bits above the mask are set; cmpeq against zero
+        // sidesteps the signed-compare problem of pcmpgtd entirely
+        const __m128i none = _mm_cmpeq_epi32(_mm_andnot_si128(msk_vec, v), _mm_setzero_si128());
+        const unsigned bits = ~static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(none))) & 0xFu;
+        bitmap[i >> 6] |= static_cast<uint64_t>(bits) << (i & 0x3Fu);
+    }
+#elif defined(TURBOPFOR_SCAN_NEON)
+    // 16 lanes per iteration: four unsigned compares narrow into one
+    // uint8x16_t, and vshrn on the u16 view folds that 128-bit mask into a
+    // 64-bit nibble mask — the shrn movemask idiom, one scalar-from-vector
+    // transfer per 16 lanes instead of one per compare.
+    const uint32x4_t msk_vec = vdupq_n_u32(base_mask);
+    for (; i + 16u <= n; i += 16u)
+    {
+        const uint32x4_t v0 = vld1q_u32(in + i);
+        const uint32x4_t v1 = vld1q_u32(in + i + 4u);
+        const uint32x4_t v2 = vld1q_u32(in + i + 8u);
+        const uint32x4_t v3 = vld1q_u32(in + i + 12u);
+        vst1q_u32(base + i, vandq_u32(v0, msk_vec));
+        vst1q_u32(base + i + 4u, vandq_u32(v1, msk_vec));
+        vst1q_u32(base + i + 8u, vandq_u32(v2, msk_vec));
+        vst1q_u32(base + i + 12u, vandq_u32(v3, msk_vec));
+
+        const uint16x8_t c01 = vcombine_u16(vmovn_u32(vcgtq_u32(v0, msk_vec)), vmovn_u32(vcgtq_u32(v1, msk_vec)));
+        const uint16x8_t c23 = vcombine_u16(vmovn_u32(vcgtq_u32(v2, msk_vec)), vmovn_u32(vcgtq_u32(v3, msk_vec)));
+        const uint8x16_t c = vcombine_u8(vmovn_u16(c01), vmovn_u16(c23));
+
+        // One 0xF nibble per lane, lane 0 in the low nibble
+        uint64_t nib = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(c), 4)), 0);
+        nib &= 0x1111111111111111ull;
+        // Compact one bit per nibble down to 16 contiguous bits: the OR
+        // shifts slide each group of four lane bits into its group's low
+        // nibble, and the masked extraction drops the stray copies (set
+        // bits only ever sit at multiples of four before the shifts, so no
+        // stray lands on a selected position).
+        nib |= nib >> 3;
+        nib |= nib >> 6;
+        const uint64_t bits = (nib & 0xFull) | ((nib >> 12) & 0xF0ull) | ((nib >> 24) & 0xF00ull) | ((nib >> 36) & 0xF000ull);
+        bitmap[i >> 6] |= bits << (i & 0x3Fu);
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        base[i] = in[i] & base_mask;
+        bitmap[i >> 6] |= static_cast<uint64_t>(in[i] > base_mask) << (i & 0x3Fu);
+    }
+
+    const unsigned words = (n + 63u) / 64u;
+    const unsigned count = popcountBitmap(bitmap, words);
+
+    unsigned char idx[MAX_VALUES + 8];
+    expandBitmapIndices(bitmap, words, idx);
+    for (i = 0; i < count; ++i)
+        exceptions[i] = in[idx[i]] >> b;
+
+    return count;
+}
+
+#if defined(__x86_64__) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+
+/// AVX-512F block split: per 16 lanes, one masked unsigned compare yields
+/// both the bitmap word slice and the compress mask, and VPCOMPRESSD writes
+/// the shifted high bits densely at the running count — the position list
+/// and the whole gather pass disappear.
+__attribute__((target("avx512f"))) static unsigned
+scanExceptions32Avx512(const uint32_t * in, unsigned n, uint32_t base_mask, unsigned b, uint32_t * base, uint64_t * bitmap, uint32_t * exceptions)
+{
+    const __m512i msk_vec = _mm512_set1_epi32(static_cast<int>(base_mask));
+    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(b));
+    unsigned count = 0;
+    unsigned i = 0;
+    for (; i + 16u <= n; i += 16u)
+    {
+        const __m512i v = _mm512_loadu_si512(in + i);
+        _mm512_storeu_si512(base + i, _mm512_and_si512(v, msk_vec));
+
+        const __mmask16 m = _mm512_cmp_epu32_mask(v, msk_vec, _MM_CMPINT_NLE);
+        _mm512_mask_compressstoreu_epi32(exceptions + count, m, _mm512_srl_epi32(v, shift));
+        bitmap[i >> 6] |= static_cast<uint64_t>(static_cast<unsigned>(m)) << (i & 0x3Fu);
+        count += static_cast<unsigned>(__builtin_popcount(static_cast<unsigned>(m)));
+    }
+    for (; i < n; ++i)
+    {
+        const unsigned is_exception = in[i] > base_mask;
+        base[i] = in[i] & base_mask;
+        bitmap[i >> 6] |= static_cast<uint64_t>(is_exception) << (i & 0x3Fu);
+        if (is_exception)
+            exceptions[count++] = in[i] >> b;
+    }
+    return count;
+}
+
+/// Shuffle control per 8-bit compare mask: lane j of entry m holds the index
+/// of the j-th set bit, so VPERMD packs the flagged lanes to the front
+/// (the Masked-VByte compaction layout, widened from bytes to dwords).
+consteval std::array<std::array<uint32_t, 8>, 256> makeCompactLut32()
+{
+    std::array<std::array<uint32_t, 8>, 256> lut{};
+    for (unsigned m = 0; m < 256u; ++m)
+    {
+        unsigned k = 0;
+        for (unsigned j = 0; j < 8u; ++j)
+            if ((m >> j) & 1u)
+                lut[m][k++] = j;
+    }
+    return lut;
+}
+
+alignas(32) static constexpr auto compact_lut32 = makeCompactLut32();
+
+/// AVX2 block split: per 8 lanes, the same andnot-against-zero compare as the
+/// SSE2 scan yields the bitmap slice, and a LUT-driven VPERMD compacts the
+/// shifted high bits densely at the running count — no position list and no
+/// second gather pass, mirroring the AVX-512 tier without VPCOMPRESSD. The
+/// full-width store past count stays inside exceptions[] because count never
+/// exceeds the lanes already processed.
+__attribute__((target("avx2"))) static unsigned
+scanExceptions32Avx2(const uint32_t * in, unsigned n, uint32_t base_mask, unsigned b, uint32_t * base, uint64_t * bitmap, uint32_t * exceptions)
+{
+    const __m256i msk_vec = _mm256_set1_epi32(static_cast<int>(base_mask));
+    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(b));
+    unsigned count = 0;
+    unsigned i = 0;
+    for (; i + 8u <= n; i += 8u)
+    {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(base + i), _mm256_and_si256(v, msk_vec));
+
+        const __m256i none = _mm256_cmpeq_epi32(_mm256_andnot_si256(msk_vec, v), _mm256_setzero_si256());
+        const unsigned m = ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(none))) & 0xFFu;
+
+        const __m256i shuf = _mm256_load_si256(reinterpret_cast<const __m256i *>(compact_lut32[m].data()));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(exceptions + count), _mm256_permutevar8x32_epi32(_mm256_srl_epi32(v, shift), shuf));
+        bitmap[i >> 6] |= static_cast<uint64_t>(m) << (i & 0x3Fu);
+        count += static_cast<unsigned>(__builtin_popcount(m));
+    }
+    for (; i < n; ++i)
+    {
+        const unsigned is_exception = in[i] > base_mask;
+        base[i] = in[i] & base_mask;
+        bitmap[i >> 6] |= static_cast<uint64_t>(is_exception) << (i & 0x3Fu);
+        if (is_exception)
+            exceptions[count++] = in[i] >> b;
+    }
+    return count;
+}
+
+extern "C" void * turbopforResolveScanExceptions32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return reinterpret_cast<void *>(&scanExceptions32Avx512);
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&scanExceptions32Avx2);
+    return reinterpret_cast<void *>(&scanExceptions32Portable);
+}
+
+unsigned scanExceptions32(const uint32_t * in, unsigned n, uint32_t base_mask, unsigned b, uint32_t * base, uint64_t * bitmap, uint32_t * exceptions)
+    __attribute__((ifunc("turbopforResolveScanExceptions32")));
+
+#else
+
+unsigned scanExceptions32(const uint32_t * in, unsigned n, uint32_t base_mask, unsigned b, uint32_t * base, uint64_t * bitmap, uint32_t * exceptions)
+{
+    return scanExceptions32Portable(in, n, base_mask, b, base, bitmap, exceptions);
+}
+
+#endif
+
+// Portable 64-bit block split: two lanes per vector (pcmpeqq needs SSE4.1),
+// then the exception values are gathered through the expanded position list.
+static unsigned
+scanExceptions64Portable(const uint64_t * in, unsigned n, uint64_t base_mask, unsigned b, uint64_t * base, uint64_t * bitmap, uint64_t * exceptions)
+{
+    unsigned i = 0;
+#if defined(__SSE4_1__)
+    const __m128i msk_vec = _mm_set1_epi64x(static_cast<long long>(base_mask));
+    for (; i + 2u <= n; i += 2u)
+    {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(base + i), _mm_and_si128(v, msk_vec));
+
+        // v > base_mask iff bits above the mask are set; cmpeq against zero
+        // avoids needing an unsigned 64-bit compare
+        const __m128i none = _mm_cmpeq_epi64(_mm_andnot_si128(msk_vec, v), _mm_setzero_si128());
+        const unsigned bits = ~static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(none))) & 0x3u;
+        bitmap[i >> 6] |= static_cast<uint64_t>(bits) << (i & 0x3Fu);
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        base[i] = in[i] & base_mask;
+        bitmap[i >> 6] |= static_cast<uint64_t>(in[i] > base_mask) << (i & 0x3Fu);
+    }
+
+    const unsigned words = (n + 63u) / 64u;
+    const unsigned count = popcountBitmap(bitmap, words);
+
+    unsigned char idx[MAX_VALUES + 8];
+    expandBitmapIndices(bitmap, words, idx);
+    for (i = 0; i < count; ++i)
+        exceptions[i] = in[idx[i]] >> b;
+
+    return count;
+}
+
+#if defined(__x86_64__) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+
+/// AVX-512F 64-bit block split: per 8 lanes, one masked unsigned compare
+/// yields both the bitmap slice and the compress mask, and VPCOMPRESSQ
+/// writes the shifted high bits densely at the running count.
+__attribute__((target("avx512f"))) static unsigned
+scanExceptions64Avx512(const uint64_t * in, unsigned n, uint64_t base_mask, unsigned b, uint64_t * base, uint64_t * bitmap, uint64_t * exceptions)
+{
+    const __m512i msk_vec = _mm512_set1_epi64(static_cast<long long>(base_mask));
+    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(b));
+    unsigned count = 0;
+    unsigned i = 0;
+    for (; i + 8u <= n; i += 8u)
+    {
+        const __m512i v = _mm512_loadu_si512(in + i);
+        _mm512_storeu_si512(base + i, _mm512_and_si512(v, msk_vec));
+
+        const __mmask8 m = _mm512_cmp_epu64_mask(v, msk_vec, _MM_CMPINT_NLE);
+        _mm512_mask_compressstoreu_epi64(exceptions + count, m, _mm512_srl_epi64(v, shift));
+        bitmap[i >> 6] |= static_cast<uint64_t>(static_cast<unsigned>(m)) << (i & 0x3Fu);
+        count += static_cast<unsigned>(__builtin_popcount(static_cast<unsigned>(m)));
+    }
+    for (; i < n; ++i)
+    {
+        const unsigned is_exception = in[i] > base_mask;
+        base[i] = in[i] & base_mask;
+        bitmap[i >> 6] |= static_cast<uint64_t>(is_exception) << (i & 0x3Fu);
+        if (is_exception)
+            exceptions[count++] = in[i] >> b;
+    }
+    return count;
+}
+
+extern "C" void * turbopforResolveScanExceptions64()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return reinterpret_cast<void *>(&scanExceptions64Avx512);
+    return reinterpret_cast<void *>(&scanExceptions64Portable);
+}
+
+unsigned scanExceptions64(const uint64_t * in, unsigned n, uint64_t base_mask, unsigned b, uint64_t * base, uint64_t * bitmap, uint64_t * exceptions)
+    __attribute__((ifunc("turbopforResolveScanExceptions64")));
+
+#else
+
+unsigned scanExceptions64(const uint64_t * in, unsigned n, uint64_t base_mask, unsigned b, uint64_t * base, uint64_t * bitmap, uint64_t * exceptions)
+{
+    return scanExceptions64Portable(in, n, base_mask, b, base, bitmap, exceptions);
+}
+
+#endif
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    define TURBOPFOR_BITWIDTHS_AVX512 1
+#endif
+
+#ifdef TURBOPFOR_BITWIDTHS_AVX512
+
+/// Vector phase for the p4Bits32 histogram: write each value's bit width to
+/// widths[]. VPLZCNTD handles 16 lanes per step (lzcnt(0) = 32, so width 0
+/// falls out of the subtraction like every other lane) and VPMOVDB narrows
+/// the result straight to bytes.
+__attribute__((target("avx512f,avx512cd"))) static void bitWidths32Avx512(const uint32_t * in, unsigned n, uint8_t * widths)
+{
+    const __m512i k32 = _mm512_set1_epi32(32);
+    unsigned i = 0;
+    for (; i + 16u <= n; i += 16u)
+    {
+        const __m512i bw = _mm512_sub_epi32(k32, _mm512_lzcnt_epi32(_mm512_loadu_si512(in + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(widths + i), _mm512_cvtepi32_epi8(bw));
+    }
+    for (; i < n; ++i)
+        widths[i] = static_cast<uint8_t>(bitWidth32(in[i]));
+}
+
+#endif
+
+static void bitWidths32Portable(const uint32_t * in, unsigned n, uint8_t * widths)
+{
+    for (unsigned i = 0; i < n; ++i)
+        widths[i] = static_cast<uint8_t>(bitWidth32(in[i]));
+}
+
+#if defined(TURBOPFOR_BITWIDTHS_AVX512) && defined(__ELF__)
+
+// IFUNC resolver, as in the pack/unpack tiers: one load-time selection, no
+// per-call CPUID check.
+extern "C" void * turbopforResolveBitWidths32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512cd"))
+        return reinterpret_cast<void *>(&bitWidths32Avx512);
+    return reinterpret_cast<void *>(&bitWidths32Portable);
+}
+
+static void bitWidths32(const uint32_t * in, unsigned n, uint8_t * widths) __attribute__((ifunc("turbopforResolveBitWidths32")));
+
+#else
+
+static void bitWidths32(const uint32_t * in, unsigned n, uint8_t * widths)
+{
+    bitWidths32Portable(in, n, widths);
 }
 
+#endif
+
 // P4 bit width selection - Determines optimal bit width and exception handling strategy.
 //
 // P4 (Patched Frame-of-Reference) encoding uses a base bit width 'b' to encode most values,
@@ -266,84 +1144,201 @@ const unsigned char * vbDec32(const unsigned char * in, unsigned n, uint32_t * o
 //
 // Returns: Optimal base bit width 'b' (0-32)
 //
-// Note: Uses negative array indexing trick for vbyte accumulators (vb array centered at offset)
-unsigned p4Bits32(const uint32_t * in, unsigned n, unsigned * out_exception_bits)
+// The block length is a template parameter following the p4Enc32Fixed
+// pattern: N == 0 compiles the runtime-length version, N == 128/256 pin the
+// common block sizes so the scan loops get constant trip counts and the
+// pad8(n * b) terms constant-fold.
+template <unsigned N>
+unsigned p4Bits32Impl(const uint32_t * in, unsigned n_rt, unsigned * out_exception_bits)
 {
-    // Phase 1: Fast scan for special cases (zeros, constant)
-    uint32_t bitwise_or = 0;
+    const unsigned n = (N != 0u) ? N : n_rt;
+
+    // Phase 1: a 16-element scalar probe decides whether the trivial-case
+    // scan is worth running at all. If any probed value differs from the
+    // first, the block can be neither all-zero nor constant, so the
+    // whole-array OR/XOR reduction is skipped and the histogram pass below
+    // becomes the only scan over the data (its per-width counts also give
+    // max_bits). Only blocks whose first 16 values are identical — the
+    // candidates for the early exits — pay for the full reduction.
     const uint32_t first_value = in[0];
-    unsigned equal_count = 0;
-
-    for (unsigned i = 0; i < n; ++i)
+    uint32_t bitwise_or = 0;
+    uint32_t difference_or = 0; // OR of in[i] ^ first_value; 0 means all equal
     {
-        bitwise_or |= in[i];
-        equal_count += (in[i] == first_value);
+        const unsigned probe_n = n < 16u ? n : 16u;
+        for (unsigned p = 0; p < probe_n; ++p)
+        {
+            bitwise_or |= in[p];
+            difference_or |= in[p] ^ first_value;
+        }
     }
 
-    // Special case: All zeros - early exit
-    if (bitwise_or == 0u)
+    unsigned max_bits = 0; // 0 = not yet known; derived from the histogram then
+
+    if (difference_or == 0u)
     {
-        *out_exception_bits = 0u;
-        return 0u;
-    }
+        unsigned i = 0;
+
+#if defined(__x86_64__)
+        // Data-parallel reduction: OR-accumulate the values and the XOR against
+        // the first value 8 lanes per iteration (two accumulator pairs hide the
+        // por latency), then fold horizontally. The constant check only needs
+        // "any lane differs", so an OR of XORs replaces the old per-lane match
+        // count — one op per 4 lanes instead of a compare plus subtract, and no
+        // horizontal add at the end. This TU builds with the baseline SSE flags,
+        // so SSE2 ops rather than AVX2.
+        if (n >= 8u)
+        {
+            const __m128i vfirst = _mm_set1_epi32(static_cast<int>(first_value));
+            __m128i vor0 = _mm_setzero_si128(), vor1 = _mm_setzero_si128();
+            __m128i vdiff0 = _mm_setzero_si128(), vdiff1 = _mm_setzero_si128();
+            for (; i + 8u <= n; i += 8u)
+            {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 4u));
+                vor0 = _mm_or_si128(vor0, a);
+                vor1 = _mm_or_si128(vor1, b);
+                vdiff0 = _mm_or_si128(vdiff0, _mm_xor_si128(a, vfirst));
+                vdiff1 = _mm_or_si128(vdiff1, _mm_xor_si128(b, vfirst));
+            }
+            __m128i vor = _mm_or_si128(vor0, vor1);
+            vor = _mm_or_si128(vor, _mm_shuffle_epi32(vor, _MM_SHUFFLE(1, 0, 3, 2)));
+            vor = _mm_or_si128(vor, _mm_shuffle_epi32(vor, _MM_SHUFFLE(2, 3, 0, 1)));
+            bitwise_or = static_cast<uint32_t>(_mm_cvtsi128_si32(vor));
+            __m128i vdiff = _mm_or_si128(vdiff0, vdiff1);
+            vdiff = _mm_or_si128(vdiff, _mm_shuffle_epi32(vdiff, _MM_SHUFFLE(1, 0, 3, 2)));
+            vdiff = _mm_or_si128(vdiff, _mm_shuffle_epi32(vdiff, _MM_SHUFFLE(2, 3, 0, 1)));
+            difference_or = static_cast<uint32_t>(_mm_cvtsi128_si32(vdiff));
+        }
+#endif
 
-    unsigned max_bits = bitWidth32(bitwise_or);
+        for (; i < n; ++i)
+        {
+            bitwise_or |= in[i];
+            difference_or |= in[i] ^ first_value;
+        }
 
-    // Special case: All values equal (constant block) - early exit
-    if (equal_count == n)
-    {
-        *out_exception_bits = MAX_BITS + 2u;
-        return max_bits;
+        // Special case: All zeros - early exit
+        if (bitwise_or == 0u)
+        {
+            *out_exception_bits = 0u;
+            return 0u;
+        }
+
+        max_bits = bitWidth32(bitwise_or);
+
+        // Special case: All values equal (constant block) - early exit
+        if (difference_or == 0u)
+        {
+            *out_exception_bits = MAX_BITS + 2u;
+            return max_bits;
+        }
     }
 
     // Phase 2: Build bit width histogram (only for non-trivial cases)
-    unsigned bit_width_count[MAX_BITS + 8u] = {0};
-
-    for (unsigned i = 0; i < n; ++i)
+    //
+    // Four sub-histograms: posting data clusters around one width, so a
+    // single counter array serializes on the same slot (store-to-load
+    // forward per increment). Striding the increments across four arrays
+    // lets the lzcnt chains and the counter updates overlap; the merge over
+    // 40 slots is negligible next to the per-element loop.
+    // The array reaches up to MAX_BITS + 25 because the candidate sweep below
+    // reads count[base_bits + {7,15,19,25}] directly; slots above max_bits
+    // stay zero.
+    alignas(64) unsigned bit_width_count[MAX_BITS + 26u];
     {
-        ++bit_width_count[bitWidth32(in[i])];
+        // The sub-histograms only span real widths 0..MAX_BITS; the slots
+        // above MAX_BITS the candidate sweep reads exist only in the merged
+        // array, where the merge loop writes them as zero. Zeroing this much
+        // stack per call shows up on short blocks, so spell it as unrolled
+        // 16-byte stores rather than leaving the compiler a rep-stos idiom.
+        alignas(64) unsigned h[4][MAX_BITS + 1u];
+#if defined(__x86_64__)
+        static_assert(sizeof(h) % 16u == 0u);
+        for (size_t off = 0; off < sizeof(h); off += 16u)
+            _mm_store_si128(reinterpret_cast<__m128i *>(reinterpret_cast<char *>(h) + off), _mm_setzero_si128());
+#else
+        memset(h, 0, sizeof(h));
+#endif
+        // Widths first, counts second: the width pass is a leaf the IFUNC can
+        // upgrade to 16-lane VPLZCNTD, and the byte buffer it fills stays in
+        // one or two L1 lines while the striped increments drain it.
+        alignas(64) uint8_t widths[MAX_VALUES];
+        bitWidths32(in, n, widths);
+        const unsigned n4 = n & ~3u;
+        for (unsigned j = 0; j < n4; j += 4u)
+        {
+            ++h[0][widths[j]];
+            ++h[1][widths[j + 1u]];
+            ++h[2][widths[j + 2u]];
+            ++h[3][widths[j + 3u]];
+        }
+        for (unsigned j = n4; j < n; ++j)
+            ++h[0][widths[j]];
+        // Element-wise merge of the four stripes, 4 slots per step; the odd
+        // 33rd slot finishes scalar.
+        unsigned w = 0;
+#if defined(__x86_64__)
+        for (; w + 4u <= MAX_BITS + 1u; w += 4u)
+        {
+            const __m128i sum01 = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(h[0] + w)),
+                                                _mm_loadu_si128(reinterpret_cast<const __m128i *>(h[1] + w)));
+            const __m128i sum23 = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(h[2] + w)),
+                                                _mm_loadu_si128(reinterpret_cast<const __m128i *>(h[3] + w)));
+            _mm_store_si128(reinterpret_cast<__m128i *>(bit_width_count + w), _mm_add_epi32(sum01, sum23));
+        }
+#endif
+        for (; w <= MAX_BITS; ++w)
+            bit_width_count[w] = h[0][w] + h[1][w] + h[2][w] + h[3][w];
+        for (w = MAX_BITS + 1u; w < MAX_BITS + 26u; ++w)
+            bit_width_count[w] = 0u;
     }
 
-    // Variable-byte size accumulators
-    unsigned vbyte_accumulator_storage[MAX_BITS * 2u + 64u + 16u] = {0};
-    unsigned * vbyte_accumulator = vbyte_accumulator_storage + MAX_BITS + 16u;
+    // Probe proved the block non-trivial, so the OR reduction never ran;
+    // the widest populated histogram slot is max_bits (nonzero, since the
+    // probe saw two distinct values).
+    if (max_bits == 0u)
+        for (unsigned w = MAX_BITS; w > 0u; --w)
+            if (bit_width_count[w] != 0u)
+            {
+                max_bits = w;
+                break;
+            }
 
     // Phase 2: Find optimal base bit width by evaluating all candidates
+    //
+    // One suffix sum over the histogram feeds every candidate: at base bits
+    // k, the exception count is suffix[k + 1] and the vbyte byte total is
+    // suffix[k + 1] + suffix[k + 8] + 2 * suffix[k + 16] + 3 * suffix[k + 20]
+    // + 4 * suffix[k + 26] (one extra byte per crossed vbyte threshold,
+    // weighted 1/2/3/4 — the closed form of the running accumulator the
+    // sweep used to carry). With the carried state gone each candidate is
+    // independent, so the up-to-32 iterations issue out of order instead of
+    // forming a serial add chain.
+    // Cache-aligned so each candidate's five strided reads (k+1 .. k+26) hit
+    // at most two lines, with the line boundary in the same place for every k.
+    alignas(64) unsigned suffix[MAX_BITS + 27u];
+    suffix[MAX_BITS + 26u] = 0u;
+    for (unsigned w = MAX_BITS + 26u; w-- > 0u;)
+        suffix[w] = suffix[w + 1u] + bit_width_count[w];
 
     unsigned optimal_base_bits = max_bits;
-    unsigned exception_count = bit_width_count[max_bits]; // Values needing > base_bits
     unsigned min_size = pad8(n * max_bits) + 1u; // Start with simple encoding
 
-    // Lambda: Update variable-byte size accumulators
-    // For a given bit width difference, accumulate vbyte encoding sizes
-    // The magic numbers (7, 15, 19, 25) correspond to vbyte encoding breakpoints:
-    // - Difference <= 7 bits: 1 byte vbyte
-    // - Difference <= 15 bits: 2 bytes vbyte
-    // - Difference <= 19 bits: 3 bytes vbyte
-    // - Difference <= 25 bits: 4 bytes vbyte
-    auto update_vbyte_accumulator = [&vbyte_accumulator](unsigned count, unsigned bits)
-    {
-        vbyte_accumulator[static_cast<int>(bits) - 7] += count; // 1 byte vbyte threshold
-        vbyte_accumulator[static_cast<int>(bits) - 15] += count * 2u; // 2 byte vbyte threshold
-        vbyte_accumulator[static_cast<int>(bits) - 19] += count * 3u; // 3 byte vbyte threshold
-        vbyte_accumulator[static_cast<int>(bits) - 25] += count * 4u; // 4 byte vbyte threshold
-    };
-
-    unsigned vbyte_size_accumulator = exception_count;
-    update_vbyte_accumulator(exception_count, max_bits);
-
     unsigned use_vbyte_exceptions = 0; // Flag: 0 = bitwise patching, 1 = vbyte exceptions
     const unsigned bitmap_bytes = pad8(n); // Bytes needed for exception bitmap
 
-    // Try each candidate base bit width from (max_bits-1) down to 0
-    // Use unsigned directly and check underflow via explicit break
-    unsigned base_bits = max_bits - 1u;
-    while (true)
+    // Candidates run from (max_bits - 1) down to 0; the strict comparisons
+    // make the first-seen (widest) candidate win ties, so the direction is
+    // part of the contract.
+    for (unsigned base_bits = max_bits; base_bits-- > 0u;)
     {
         const unsigned patch_bits = max_bits - base_bits; // Extra bits needed for exceptions
+        const unsigned exception_count = suffix[base_bits + 1u]; // Values needing > base_bits
+        const unsigned vbyte_bytes = suffix[base_bits + 1u] + suffix[base_bits + 8u] + 2u * suffix[base_bits + 16u]
+            + 3u * suffix[base_bits + 20u] + 4u * suffix[base_bits + 26u];
 
         // Strategy 1: Variable-byte exception encoding
-        const unsigned vbyte_size = pad8(n * base_bits) + 2u + exception_count + vbyte_size_accumulator;
+        const unsigned vbyte_size = pad8(n * base_bits) + 2u + exception_count + vbyte_bytes;
 
         // Strategy 2: Bitwise patching
         const unsigned patching_size = pad8(n * base_bits) + 2u + bitmap_bytes + pad8(exception_count * patch_bits);
@@ -361,17 +1356,6 @@ unsigned p4Bits32(const uint32_t * in, unsigned n, unsigned * out_exception_bits
             optimal_base_bits = base_bits;
             use_vbyte_exceptions = 1;
         }
-
-        // Check if this is the last iteration (base_bits == 0)
-        if (base_bits == 0)
-            break;
-
-        // Update state for next iteration
-        exception_count += bit_width_count[base_bits];
-        vbyte_size_accumulator += bit_width_count[base_bits] + vbyte_accumulator[static_cast<int>(base_bits)];
-        update_vbyte_accumulator(bit_width_count[base_bits], base_bits);
-
-        --base_bits;
     }
 
     // Return results
@@ -386,6 +1370,17 @@ unsigned p4Bits32(const uint32_t * in, unsigned n, unsigned * out_exception_bits
     return optimal_base_bits;
 }
 
+unsigned p4Bits32(const uint32_t * in, unsigned n, unsigned * out_exception_bits)
+{
+    // Whole blocks dominate every encode loop; route them to the pinned
+    // instantiations and keep the runtime-length version for tails.
+    if (n == 256u)
+        return p4Bits32Impl<256u>(in, n, out_exception_bits);
+    if (n == 128u)
+        return p4Bits32Impl<128u>(in, n, out_exception_bits);
+    return p4Bits32Impl<0u>(in, n, out_exception_bits);
+}
+
 // Write P4 encoding header based on bit width (b) and exception handling strategy (bx)
 //
 // Header encoding format:
@@ -408,24 +1403,35 @@ unsigned p4Bits32(const uint32_t * in, unsigned n, unsigned * out_exception_bits
 // - 32+2 (34): All values equal (constant block)
 void writeHeader(unsigned char *& out, unsigned b, unsigned bx)
 {
-    if (bx == 0u)
+    // Branchless emit: two tiny LUTs map bx to the flag byte and the header
+    // length (2 only for bitwise patching, which carries bx in a second
+    // byte). The second byte is stored unconditionally — for 1-byte headers
+    // it lands in slack that the payload (or the caller's spare output
+    // space) overwrites, the same transient-overhang license the encoders'
+    // wide stores already use — and out advances by the real length.
+    static constexpr auto flag_lut = []
     {
-        // Simple bitpacking: just write the bit width
-        *out++ = static_cast<unsigned char>(b);
-    }
-    else if (bx <= MAX_BITS)
+        std::array<uint8_t, MAX_BITS + 3u> lut{};
+        for (unsigned bx_i = 1u; bx_i <= MAX_BITS; ++bx_i)
+            lut[bx_i] = 0x80u; // bitwise patching
+        lut[MAX_BITS + 1u] = 0x40u; // variable-byte exceptions
+        lut[MAX_BITS + 2u] = 0xC0u; // constant block
+        return lut;
+    }();
+    static constexpr auto len_lut = []
     {
-        // Bitwise patching: 0x80 flag + base_bits, then exception_bits
-        *out++ = static_cast<unsigned char>(0x80u | b);
-        *out++ = static_cast<unsigned char>(bx);
-    }
-    else
-    {
-        // Variable-byte exceptions (bx=33): 0x40 flag
-        // Constant block (bx=34): 0xC0 flag
-        const unsigned flag = (bx == MAX_BITS + 1u) ? 0x40u : 0xC0u;
-        *out++ = static_cast<unsigned char>(flag | b);
-    }
+        std::array<uint8_t, MAX_BITS + 3u> lut{};
+        lut[0] = 1u;
+        for (unsigned bx_i = 1u; bx_i <= MAX_BITS; ++bx_i)
+            lut[bx_i] = 2u;
+        lut[MAX_BITS + 1u] = 1u;
+        lut[MAX_BITS + 2u] = 1u;
+        return lut;
+    }();
+
+    out[0] = static_cast<unsigned char>(flag_lut[bx] | b);
+    out[1] = static_cast<unsigned char>(bx);
+    out += len_lut[bx];
 }
 
 // ===================== 64-bit variable-byte encoding =====================
@@ -466,8 +1472,8 @@ void vbPut64(unsigned char *& out, uint64_t x)
     else
     {
         // Raw encoding: determine number of bytes needed
-        // bsr64(x) returns highest set bit + 1, so (bsr64(x) + 7) / 8 = ceil(bits/8)
-        const unsigned b = (bsr64(x) + 7u) / 8u;
+        // bitWidth64(x) returns highest set bit + 1, so (bitWidth64(x) + 7) / 8 = ceil(bits/8)
+        const unsigned b = (bitWidth64(x) + 7u) / 8u;
         *out++ = static_cast<uint8_t>(VBYTE64_MARKER_RAW + (b - 3u));
         // Store raw little-endian value (we write 8 bytes for simplicity, advance by b)
         storeU64Fast(out, x);
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <cstring>
+#include <type_traits>
+
+#if defined(__i386__) || defined(__x86_64__)
+#    include <immintrin.h>
+#endif
 
 namespace turbopfor::scalar::detail
 {
@@ -11,9 +17,14 @@ namespace turbopfor::scalar::detail
 #    define TURBOPFOR_NOINLINE __attribute__((noinline))
 #    define TURBOPFOR_LIKELY(x) __builtin_expect(!!(x), 1)
 #    define TURBOPFOR_UNLIKELY(x) __builtin_expect(!!(x), 0)
-using U64Alias = uint64_t __attribute__((__may_alias__));
-using U32Alias = uint32_t __attribute__((__may_alias__));
-using U16Alias = uint16_t __attribute__((__may_alias__));
+// aligned(1) makes a dereference a genuine unaligned access on every
+// architecture, so the "fast" load/store helpers need no x86-only carve-out:
+// the compiler emits the widest load the target supports (a plain mov on
+// x86, ldr on aarch64) and can combine and reorder them, which the memcpy
+// form does not always survive at low optimization levels.
+using U64Alias = uint64_t __attribute__((__may_alias__, __aligned__(1)));
+using U32Alias = uint32_t __attribute__((__may_alias__, __aligned__(1)));
+using U16Alias = uint16_t __attribute__((__may_alias__, __aligned__(1)));
 #else
 #    define TURBOPFOR_ALWAYS_INLINE inline
 #    define TURBOPFOR_NOINLINE
@@ -125,24 +136,27 @@ constexpr unsigned pad8(unsigned x)
     return (x + 7u) / 8u;
 }
 
-/// Bit scan reverse for 32-bit integer (returns highest set bit position + 1, or 0 if x is 0)
+/// Bit width of a 32-bit value: highest set bit position + 1, or 0 if x is 0
 /// Returns value in range [0, 32]
 ///
-/// Uses inline assembly on x86 for optimal codegen - the bsr instruction leaves the destination
-/// unchanged when the source is 0, so initializing b=-1 gives us b+1=0 for x=0 without branching.
+/// The intrinsic form (not inline asm) lets the compiler constant-fold, CSE
+/// across adjacent calls (e.g. the per-lane width chain in p4Bits) and
+/// schedule registers freely — an asm block is an opaque barrier with a "cc"
+/// clobber. The x=0 => 0 result is load-bearing: an all-zero block must
+/// encode with width 0 to stay byte-identical with the reference format.
 ///
-/// Returns unsigned (not uint8_t) to avoid zero-extension instructions (movzbl) when used as array index.
-inline unsigned bsr32(uint32_t x)
+/// constexpr so table builders can take widths at compile time; intrinsics
+/// cannot run during constant evaluation, so that case falls through to the
+/// builtin-clz form (which compiles to the same lzcnt under -mlzcnt anyway).
+constexpr unsigned bitWidth32(uint32_t x)
 {
-#if (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
-    int b = -1;
-    asm("bsrl %1,%0" : "+r"(b) : "rm"(x));
-    return static_cast<unsigned>(b + 1);
-#elif defined(__GNUC__) || defined(__clang__)
+#if defined(__LZCNT__)
+    if (!__builtin_is_constant_evaluated())
+        return 32u - _lzcnt_u32(x);
+#endif
+#if defined(__GNUC__) || defined(__clang__)
     return x ? (32u - static_cast<unsigned>(__builtin_clz(x))) : 0u;
 #else
-    if (!x)
-        return 0u;
     unsigned b = 0u;
     while (x)
     {
@@ -153,34 +167,17 @@ inline unsigned bsr32(uint32_t x)
 #endif
 }
 
-/// Bit width using lzcnt instruction (faster than bsr on modern CPUs)
-/// Returns highest set bit position + 1, or 0 if x is 0
-/// lzcnt is preferred when available because it handles x=0 natively (returns 32)
-inline unsigned bitWidth32(uint32_t x)
-{
-#if (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
-    unsigned lz;
-    // lzcnt returns 32 for x=0, so 32-32=0 which is correct
-    asm("lzcntl %1,%0" : "=r"(lz) : "rm"(x) : "cc");
-    return 32u - lz;
-#else
-    return x ? (32u - static_cast<unsigned>(__builtin_clz(x))) : 0u;
-#endif
-}
-
-/// Bit scan reverse for 64-bit integer (returns highest set bit position + 1, or 0 if x is 0)
+/// Bit width of a 64-bit value: highest set bit position + 1, or 0 if x is 0
 /// Returns value in range [0, 64]
-inline unsigned bsr64(uint64_t x)
+constexpr unsigned bitWidth64(uint64_t x)
 {
-#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
-    int64_t b = -1;
-    asm("bsrq %1,%0" : "+r"(b) : "rm"(x));
-    return static_cast<unsigned>(b + 1);
-#elif defined(__GNUC__) || defined(__clang__)
+#if defined(__LZCNT__) && defined(__x86_64__)
+    if (!__builtin_is_constant_evaluated())
+        return 64u - static_cast<unsigned>(_lzcnt_u64(x));
+#endif
+#if defined(__GNUC__) || defined(__clang__)
     return x ? (64u - static_cast<unsigned>(__builtin_clzll(x))) : 0u;
 #else
-    if (!x)
-        return 0u;
     unsigned b = 0u;
     while (x)
     {
@@ -191,28 +188,37 @@ inline unsigned bsr64(uint64_t x)
 #endif
 }
 
-/// Bit width using lzcnt instruction for 64-bit values
-/// Returns highest set bit position + 1, or 0 if x is 0
-inline unsigned bitWidth64(uint64_t x)
+/// Count set bits in a 64-bit word
+inline unsigned popcount64(uint64_t x)
 {
-#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
-    unsigned long long lz;
-    // lzcnt returns 64 for x=0, so 64-64=0 which is correct
-    asm("lzcntq %1,%0" : "=r"(lz) : "rm"(x) : "cc");
-    return 64u - static_cast<unsigned>(lz);
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcountll(x));
 #else
-    return x ? (64u - static_cast<unsigned>(__builtin_clzll(x))) : 0u;
+    unsigned count = 0;
+    while (x)
+    {
+        ++count;
+        x &= x - 1ull;
+    }
+    return count;
 #endif
 }
 
 /// Create a mask with b bits set (32-bit version)
 /// Parameter b: number of bits to set (0-32)
 /// Returns: bitmask with b lowest bits set
-inline uint32_t maskBits(unsigned b)
+///
+/// constexpr for the same reason as bitWidth32: the (b, bx) specializations
+/// fold their masks at compile time, while runtime calls keep the BZHI form.
+constexpr uint32_t maskBits(unsigned b)
 {
-    if (b >= 32u)
-        return 0xFFFFFFFFu;
-    return b == 0u ? 0u : ((1u << b) - 1u);
+#if defined(__x86_64__) && defined(__BMI2__)
+    // BZHI covers the whole 0-32 range branchlessly in one uop
+    if (!__builtin_is_constant_evaluated())
+        return _bzhi_u32(~0u, b);
+#endif
+    // The 64-bit shift is defined for b = 32, so no special case is needed
+    return static_cast<uint32_t>((1ull << b) - 1ull);
 }
 
 /// Create a mask with b bits set (64-bit version)
@@ -220,9 +226,13 @@ inline uint32_t maskBits(unsigned b)
 /// Returns: bitmask with b lowest bits set
 inline uint64_t maskBits64(unsigned b)
 {
+#if defined(__x86_64__) && defined(__BMI2__)
+    return _bzhi_u64(~0ull, b);
+#else
     if (b >= 64u)
         return 0xFFFFFFFFFFFFFFFFull;
     return b == 0u ? 0ull : ((1ull << b) - 1ull);
+#endif
 }
 
 /// Load unaligned 32-bit little-endian value and convert to native
@@ -271,13 +281,13 @@ inline void storeU64(unsigned char * out, uint64_t v)
 }
 
 /// Fast unaligned loads/stores with little-endian conversion
-/// On x86 (always little-endian), uses direct pointer access for speed.
-/// On other architectures, uses memcpy + byte swap if needed.
+/// With GNU-compatible compilers the may_alias + aligned(1) typedefs give a
+/// direct unaligned access on any architecture (the leToNative conversion is
+/// a no-op on little-endian targets); otherwise fall back to memcpy + swap.
 inline uint64_t loadU64Fast(const unsigned char * in)
 {
-#if defined(__i386__) || defined(__x86_64__)
-    // x86 is always little-endian, direct access is safe and fast
-    return *reinterpret_cast<const U64Alias *>(in);
+#if defined(__GNUC__) || defined(__clang__)
+    return leToNative64(*reinterpret_cast<const U64Alias *>(in));
 #else
     return loadU64(in);
 #endif
@@ -285,9 +295,8 @@ inline uint64_t loadU64Fast(const unsigned char * in)
 
 inline void storeU64Fast(unsigned char * out, uint64_t v)
 {
-#if defined(__i386__) || defined(__x86_64__)
-    // x86 is always little-endian, direct access is safe and fast
-    *reinterpret_cast<U64Alias *>(out) = v;
+#if defined(__GNUC__) || defined(__clang__)
+    *reinterpret_cast<U64Alias *>(out) = nativeToLe64(v);
 #else
     storeU64(out, v);
 #endif
@@ -295,9 +304,8 @@ inline void storeU64Fast(unsigned char * out, uint64_t v)
 
 inline uint32_t loadU32Fast(const unsigned char * in)
 {
-#if defined(__i386__) || defined(__x86_64__)
-    // x86 is always little-endian, direct access is safe and fast
-    return *reinterpret_cast<const U32Alias *>(in);
+#if defined(__GNUC__) || defined(__clang__)
+    return leToNative32(*reinterpret_cast<const U32Alias *>(in));
 #else
     return loadU32(in);
 #endif
@@ -305,9 +313,8 @@ inline uint32_t loadU32Fast(const unsigned char * in)
 
 inline void storeU32Fast(unsigned char * out, uint32_t v)
 {
-#if defined(__i386__) || defined(__x86_64__)
-    // x86 is always little-endian, direct access is safe and fast
-    *reinterpret_cast<U32Alias *>(out) = v;
+#if defined(__GNUC__) || defined(__clang__)
+    *reinterpret_cast<U32Alias *>(out) = nativeToLe32(v);
 #else
     storeU32(out, v);
 #endif
@@ -315,9 +322,8 @@ inline void storeU32Fast(unsigned char * out, uint32_t v)
 
 inline uint16_t loadU16Fast(const unsigned char * in)
 {
-#if defined(__i386__) || defined(__x86_64__)
-    // x86 is always little-endian, direct access is safe and fast
-    return *reinterpret_cast<const U16Alias *>(in);
+#if defined(__GNUC__) || defined(__clang__)
+    return leToNative16(*reinterpret_cast<const U16Alias *>(in));
 #else
     return loadU16(in);
 #endif
@@ -327,9 +333,9 @@ inline uint32_t loadU24(const unsigned char * in)
 {
     // Load 3 bytes as little-endian 24-bit value
     // Byte 0 is lowest, byte 2 is highest
-    // On x86, use 16-bit load for better performance (fewer load ops)
-#if defined(__i386__) || defined(__x86_64__)
-    return static_cast<uint32_t>(*reinterpret_cast<const U16Alias *>(in)) | (static_cast<uint32_t>(in[2]) << 16);
+    // A 16-bit load plus one byte load beats three byte loads where available
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(loadU16Fast(in)) | (static_cast<uint32_t>(in[2]) << 16);
 #else
     return static_cast<uint32_t>(in[0]) | (static_cast<uint32_t>(in[1]) << 8) | (static_cast<uint32_t>(in[2]) << 16);
 #endif
@@ -337,27 +343,341 @@ inline uint32_t loadU24(const unsigned char * in)
 
 inline void storeU16Fast(unsigned char * out, uint16_t v)
 {
-#if defined(__i386__) || defined(__x86_64__)
-    // x86 is always little-endian, direct access is safe and fast
-    *reinterpret_cast<U16Alias *>(out) = v;
+#if defined(__GNUC__) || defined(__clang__)
+    *reinterpret_cast<U16Alias *>(out) = nativeToLe16(v);
 #else
     storeU16(out, v);
 #endif
 }
 
+/// Popcount of an up-to-four-word exception bitmap. One accumulator per
+/// word instead of a single running sum lets the popcnt latencies (3 cycles
+/// against 1-cycle throughput) overlap rather than chain; the loop unrolls
+/// fully and the pairwise reduction adds in tree order. Words past the
+/// count contribute zero.
+TURBOPFOR_ALWAYS_INLINE unsigned popcountBitmap(const uint64_t * bitmap, unsigned words)
+{
+    unsigned counts[MAX_VALUES / 64] = {};
+
+    for (unsigned i = 0; i < words; ++i)
+        counts[i] = popcount64(bitmap[i]);
+
+    return (counts[0] + counts[1]) + (counts[2] + counts[3]);
+}
+
+/// Load the n-bit exception bitmap at in into bitmap[] and return the number
+/// of set bits. Unused tail bits of the last word are masked off, so the
+/// returned count and the caller's set-bit walk see exactly n bits.
+TURBOPFOR_ALWAYS_INLINE unsigned loadBitmap(const unsigned char * in, unsigned n, uint64_t * bitmap)
+{
+    const unsigned words = (n + 63u) / 64u;
+
+    for (unsigned i = 0; i < words; ++i)
+    {
+        uint64_t word = loadU64Fast(in + i * sizeof(uint64_t));
+
+        if (i == words - 1u && (n & 0x3Fu))
+            word &= (1ull << (n & 0x3Fu)) - 1ull;
+
+        bitmap[i] = word;
+    }
+
+    return popcountBitmap(bitmap, words);
+}
+
+/// Expand the set bits of bitmap[] into a byte-sized ascending index array.
+/// May write up to seven unused lanes past the last index, so idx needs
+/// 8 bytes of slack. Positions fit in a byte because blocks hold at most
+/// MAX_VALUES (256) values. IFUNC-resolved in p4_scalar_internal.cpp:
+/// AVX512-VBMI2 hosts compress an iota vector through the bitmap word as a
+/// write mask — one VPCOMPRESSB per 64-bit word; other hosts expand through
+/// a per-byte position table — one lookup and one 8-byte store per bitmap
+/// byte, no per-bit branches either way.
+void expandBitmapIndices(const uint64_t * bitmap, unsigned words, unsigned char * idx);
+
+/// Apply bitmap-addressed exception patches: OR exceptions[k] << b into
+/// out[] at the position of the k-th set bit of bitmap[].
+///
+/// The classic walk (ctz + clear-lowest-bit) carries the shrinking word
+/// through every iteration, so dense bitmaps pay the chain latency once per
+/// exception. When at least one bit in eight is set, it is cheaper to first
+/// expand the bitmap into an index array — one table lookup and one 8-byte
+/// store per bitmap byte, no per-bit branches — and then run the patch loop
+/// over the array, where every iteration is independent. Sparse bitmaps
+/// keep the walk: expansion would touch all bitmap bytes for a handful of
+/// patches. Positions fit in a byte because blocks hold at most MAX_VALUES
+/// (256) values.
+template <typename OutT, typename ExT>
+TURBOPFOR_ALWAYS_INLINE void
+patchExceptions(OutT * out, const uint64_t * bitmap, unsigned words, const ExT * exceptions, unsigned b, unsigned exception_count)
+{
+    if (exception_count * 8u >= words * 64u)
+    {
+        // Dense: expand set-bit positions, then patch over the array where
+        // every iteration is independent.
+        unsigned char idx[MAX_VALUES + 8];
+        expandBitmapIndices(bitmap, words, idx);
+
+        for (unsigned k = 0; k < exception_count; ++k)
+            out[idx[k]] |= static_cast<OutT>(exceptions[k]) << b;
+        return;
+    }
+
+    unsigned k = 0;
+    for (unsigned i = 0; i < words; ++i)
+    {
+        uint64_t word = bitmap[i];
+        while (word)
+        {
+            // With -mbmi this pair compiles to tzcnt (no bsf false
+            // dependency on the destination) and blsr (single-instruction
+            // clear-lowest-bit), shortening the loop-carried chain the
+            // sparse walk lives on.
+#if defined(__BMI__)
+            const unsigned bit = static_cast<unsigned>(_tzcnt_u64(word));
+#elif defined(__GNUC__) || defined(__clang__)
+            const unsigned bit = static_cast<unsigned>(__builtin_ctzll(word));
+#else
+            unsigned bit = 0;
+            while (((word >> bit) & 1ull) == 0ull)
+                ++bit;
+#endif
+            out[i * 64u + bit] |= static_cast<OutT>(exceptions[k++]) << b;
+            word &= word - 1ull; // Clear lowest set bit (blsr under -mbmi)
+        }
+    }
+}
+
+/// Delta1-decode a constant block: every stored delta is the same value, so
+/// the prefix sum collapses to the arithmetic progression
+/// out[i] = start + (value + 1) * (i + 1) — no fill pass, no loop-carried
+/// chain, just one vector add per store.
+TURBOPFOR_ALWAYS_INLINE void applyDelta1Constant(uint32_t * out, unsigned n, uint32_t start, uint32_t value)
+{
+    const uint32_t step = value + 1u;
+    unsigned i = 0;
+#if defined(__SSE2__)
+    // SSE2 lacks a 32-bit mullo, so the first vector is built with scalar
+    // multiplies (setup only); after that each iteration is a single add.
+    __m128i cur = _mm_add_epi32(
+        _mm_set1_epi32(static_cast<int>(start)),
+        _mm_set_epi32(
+            static_cast<int>(4u * step), static_cast<int>(3u * step), static_cast<int>(2u * step), static_cast<int>(step)));
+    const __m128i inc = _mm_set1_epi32(static_cast<int>(4u * step));
+    for (; i + 4u <= n; i += 4u)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), cur);
+        cur = _mm_add_epi32(cur, inc);
+    }
+#endif
+    uint32_t acc = start + step * i;
+    for (; i < n; ++i)
+        out[i] = (acc += step);
+}
+
+/// 64-bit variant of applyDelta1Constant: the same arithmetic progression,
+/// two lanes per vector.
+TURBOPFOR_ALWAYS_INLINE void applyDelta1Constant64(uint64_t * out, unsigned n, uint64_t start, uint64_t value)
+{
+    const uint64_t step = value + 1ull;
+    unsigned i = 0;
+#if defined(__SSE2__)
+    __m128i cur = _mm_add_epi64(
+        _mm_set1_epi64x(static_cast<long long>(start)), _mm_set_epi64x(static_cast<long long>(2ull * step), static_cast<long long>(step)));
+    const __m128i inc = _mm_set1_epi64x(static_cast<long long>(2ull * step));
+    for (; i + 2u <= n; i += 2u)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), cur);
+        cur = _mm_add_epi64(cur, inc);
+    }
+#endif
+    uint64_t acc = start + step * i;
+    for (; i < n; ++i)
+        out[i] = (acc += step);
+}
+
+/// Out-of-line dense-block variant of bitunpackPatch32 below, defined in
+/// p4_scalar_internal.cpp. IFUNC-resolved: hosts with AVX-512F unpack the
+/// fields into an array, expand the bitmap into an index array and run a
+/// 16-lane gather / OR / scatter loop (the indices are distinct bitmap
+/// positions, so the scatter has no lane conflicts); other hosts run the
+/// same two-pass scheme with a scalar patch loop, which already beats the
+/// fused ctz walk once enough bits are set (see patchExceptions).
+void bitunpackPatchDense32(const unsigned char * in, unsigned count, uint32_t * out, unsigned b, unsigned bx, const uint64_t * bitmap, unsigned words);
+
+/// One-pass block split for the P4 encoders: write base (value & base_mask)
+/// for every lane, set the exception bitmap bit for lanes above the mask and
+/// pack the high bits (value >> b) into exceptions[] in position order.
+/// bitmap[] must be zero on entry; base[] gets exactly n lanes, so full-block
+/// padding past n stays as the caller left it. Returns the exception count.
+/// IFUNC-resolved in p4_scalar_internal.cpp: AVX-512F hosts run a masked
+/// compare plus VPCOMPRESSD compress-store per 16 lanes, so the exception
+/// values land densely without a position list or a second pass; AVX2 hosts
+/// compact 8 lanes at a time through a shuffle-LUT VPERMD; other hosts keep
+/// the SSE2 movemask scan followed by a bitmap-expansion gather.
+unsigned scanExceptions32(const uint32_t * in, unsigned n, uint32_t base_mask, unsigned b, uint32_t * base, uint64_t * bitmap, uint32_t * exceptions);
+
+/// 64-bit variant of scanExceptions32, same contract. The AVX-512F tier runs
+/// eight lanes per vector with VPCOMPRESSQ; other hosts use the SSE4.1
+/// two-lane scan (pcmpeqq) followed by a bitmap-expansion gather.
+unsigned scanExceptions64(const uint64_t * in, unsigned n, uint64_t base_mask, unsigned b, uint64_t * base, uint64_t * bitmap, uint64_t * exceptions);
+
+/// Merge vbyte-format exceptions into out[] by explicit position list:
+/// out[pos[k]] |= ex[k] << b for k in [0, count). Positions are distinct
+/// block indices, one byte each. IFUNC-resolved in p4_scalar_internal.cpp:
+/// AVX-512F hosts gather / OR / scatter 16 patches at a time, AVX2 hosts
+/// gather and store back through a register block, others run the unrolled
+/// scalar loop. The position list usually sits at the very end of the
+/// stream, so the vector variants only issue whole loads that the
+/// remaining count covers.
+void patchPositions32(uint32_t * out, const unsigned char * pos, const uint32_t * ex, unsigned b, unsigned count);
+
+/// Unpack count bx-bit exception fields (bx <= 32) from in and OR each,
+/// shifted left by b, into out[] at the position of its set bit in bitmap[].
+/// Fusing the unpack with the patch phase sends each field straight to its
+/// destination instead of round-tripping through a block-sized stack buffer
+/// that is written once and read once. Exception counts are small by
+/// construction (the encoder picks the bitmap only when exceptions are few),
+/// so per-field extraction also skips the vector unpacker's setup cost.
+///
+/// Each field is extracted with one wide load; the last few fields read from
+/// a zero-padded copy of the region's final bytes so no load crosses the end
+/// of the exception region (it may be the last thing in the stream).
+template <typename OutT>
+TURBOPFOR_ALWAYS_INLINE void
+bitunpackPatch32(const unsigned char * in, unsigned count, OutT * out, unsigned b, unsigned bx, const uint64_t * bitmap, unsigned words)
+{
+    // Dense blocks (one exception per eight values or more, same threshold
+    // as patchExceptions): the per-field extraction below serializes on the
+    // ctz walk, so hand the block to the out-of-line two-pass kernel.
+    if constexpr (std::is_same_v<OutT, uint32_t>)
+    {
+        if (count * 8u >= words * 64u)
+        {
+            bitunpackPatchDense32(in, count, out, b, bx, bitmap, words);
+            return;
+        }
+    }
+
+    const unsigned ex_bytes = pad8(count * bx);
+    const uint64_t field_mask = maskBits(bx);
+
+    unsigned char tail[16] = {};
+    const unsigned tail_start = ex_bytes > 8u ? ex_bytes - 8u : 0u;
+    for (unsigned i = tail_start; i < ex_bytes; ++i)
+        tail[i - tail_start] = in[i];
+
+    unsigned k = 0;
+    for (unsigned i = 0; i < words; ++i)
+    {
+        uint64_t word = bitmap[i];
+        while (word)
+        {
+            // tzcnt/blsr under -mbmi, as in the patchExceptions walk above
+#if defined(__BMI__)
+            const unsigned bit = static_cast<unsigned>(_tzcnt_u64(word));
+#elif defined(__GNUC__) || defined(__clang__)
+            const unsigned bit = static_cast<unsigned>(__builtin_ctzll(word));
+#else
+            unsigned bit = 0;
+            while (((word >> bit) & 1ull) == 0ull)
+                ++bit;
+#endif
+            const unsigned bitpos = k * bx;
+            const unsigned ofs = bitpos >> 3u;
+            const uint64_t w = ofs + 8u <= ex_bytes ? loadU64Fast(in + ofs) : loadU64Fast(tail + (ofs - tail_start));
+            out[i * 64u + bit] |= static_cast<OutT>((w >> (bitpos & 7u)) & field_mask) << b;
+            ++k;
+            word &= word - 1ull; // Clear lowest set bit (blsr under -mbmi)
+        }
+    }
+}
+
+/// Inline byte copy for the small, 4-byte-granular buffers the uncompressed
+/// escape paths move (at most one P4 block, 1 KB). glibc's memcpy resolves a
+/// size ladder and an ifunc-selected implementation on every call; for these
+/// sizes a flat loop of unaligned 16-byte moves plus a word tail is cheaper
+/// and fully visible to the inliner. Sizes are always multiples of 4.
+TURBOPFOR_ALWAYS_INLINE void copyBytesInline(unsigned char * out, const unsigned char * in, size_t bytes)
+{
+#if defined(__x86_64__)
+#    if defined(__AVX2__)
+    // In the translation units built with -mavx2 (the 256v kernels) the bulk
+    // loop moves 32 bytes per instruction — a full 512-byte block copy is
+    // then 16 loads + 16 stores with no dispatch or loop-carried dependency.
+    while (bytes >= 64u)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 32), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 32)));
+        in += 64u;
+        out += 64u;
+        bytes -= 64u;
+    }
+    if (bytes >= 32u)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in)));
+        in += 32u;
+        out += 32u;
+        bytes -= 32u;
+    }
+#    else
+    while (bytes >= 64u)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_loadu_si128(reinterpret_cast<const __m128i *>(in)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16), _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 32), _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 32)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 48), _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 48)));
+        in += 64u;
+        out += 64u;
+        bytes -= 64u;
+    }
+#    endif
+    while (bytes >= 16u)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_loadu_si128(reinterpret_cast<const __m128i *>(in)));
+        in += 16u;
+        out += 16u;
+        bytes -= 16u;
+    }
+    if (bytes & 8u)
+    {
+        storeU64Fast(out, loadU64Fast(in));
+        in += 8u;
+        out += 8u;
+    }
+    if (bytes & 4u)
+        storeU32Fast(out, loadU32Fast(in));
+#else
+    memcpy(out, in, bytes);
+#endif
+}
+
 /// Copy n uint32_t values from native array to little-endian byte stream
 /// On little-endian platforms, this is equivalent to memcpy
 /// On big-endian platforms, each value is byte-swapped
 TURBOPFOR_ALWAYS_INLINE void copyU32ArrayToLe(unsigned char * out, const uint32_t * in, unsigned n)
 {
 #if TURBOPFOR_BIG_ENDIAN
-    for (unsigned i = 0; i < n; ++i)
+    // Pair the values into 64-bit words: storeU64 keeps the low half first in
+    // the stream, so the order is preserved, and the loop becomes one
+    // bswap64 + word store per pair — a shape compilers recognize and
+    // vectorize (there is no big-endian x86, so a hand-written SIMD swap
+    // would have no target to run on).
+    unsigned i = 0;
+    for (; i + 2u <= n; i += 2u)
     {
-        storeU32Fast(out, in[i]);
-        out += sizeof(uint32_t);
+        storeU64(out, static_cast<uint64_t>(in[i]) | (static_cast<uint64_t>(in[i + 1u]) << 32));
+        out += sizeof(uint64_t);
     }
+    if (i < n)
+        storeU32(out, in[i]);
 #else
-    memcpy(out, in, n * sizeof(uint32_t));
+    // On little-endian hosts the copy is a plain byte move; stay inline for
+    // block-sized buffers and leave the rest to memcpy's large-copy paths.
+    if (n <= MAX_VALUES)
+        copyBytesInline(out, reinterpret_cast<const unsigned char *>(in), size_t{n} * sizeof(uint32_t));
+    else
+        memcpy(out, in, n * sizeof(uint32_t));
 #endif
 }
 
@@ -367,13 +687,23 @@ TURBOPFOR_ALWAYS_INLINE void copyU32ArrayToLe(unsigned char * out, const uint32_
 TURBOPFOR_ALWAYS_INLINE void copyU32ArrayFromLe(uint32_t * out, const unsigned char * in, unsigned n)
 {
 #if TURBOPFOR_BIG_ENDIAN
-    for (unsigned i = 0; i < n; ++i)
+    // Inverse of the paired store in copyU32ArrayToLe: one word load +
+    // bswap64 per pair, split into halves in registers.
+    unsigned i = 0;
+    for (; i + 2u <= n; i += 2u)
     {
-        out[i] = loadU32Fast(in);
-        in += sizeof(uint32_t);
+        const uint64_t w = loadU64(in);
+        out[i] = static_cast<uint32_t>(w);
+        out[i + 1u] = static_cast<uint32_t>(w >> 32);
+        in += sizeof(uint64_t);
     }
+    if (i < n)
+        out[i] = loadU32(in);
 #else
-    memcpy(out, in, n * sizeof(uint32_t));
+    if (n <= MAX_VALUES)
+        copyBytesInline(reinterpret_cast<unsigned char *>(out), in, size_t{n} * sizeof(uint32_t));
+    else
+        memcpy(out, in, n * sizeof(uint32_t));
 #endif
 }
 
@@ -425,7 +755,7 @@ constexpr unsigned max_words_for_block()
     return 32u;
 }
 
-constexpr unsigned choose_block_size(unsigned b, unsigned n)
+constexpr unsigned compute_block_size(unsigned b, unsigned n)
 {
     if (n == 0u)
         return 0u;
@@ -450,87 +780,66 @@ constexpr unsigned choose_block_size(unsigned b, unsigned n)
     return n;
 }
 
+/// Every (b, n) block size, tabulated once instead of re-running the
+/// gcd/halving search above for each of the ~2000 unpack_blocks /
+/// pack_blocks instantiations (and for any call the compiler declines to
+/// fold). b spans the 64-bit widths, n the 32-element block.
+consteval std::array<std::array<uint8_t, 33>, 65> make_block_size_table()
+{
+    std::array<std::array<uint8_t, 33>, 65> table{};
+    for (unsigned b = 0; b <= 64u; ++b)
+        for (unsigned n = 0; n <= 32u; ++n)
+            table[b][n] = static_cast<uint8_t>(compute_block_size(b, n));
+    return table;
+}
+
+inline constexpr auto block_size_table = make_block_size_table();
+
+constexpr unsigned choose_block_size(unsigned b, unsigned n)
+{
+    return block_size_table[b][n];
+}
+
 /// Store partial bytes at the end of output (1-7 bytes from a 64-bit word)
 /// Used by bitpack templates when the last word doesn't fill a full 8 bytes
+///
+/// One constant-size memcpy: compilers lower it to a store of the widest
+/// fitting width plus one overlapping store for the odd sizes — at most two
+/// stores instead of the old u32+u16+u8 chain. Still exact: this can land at
+/// the very end of the stream, so a full 8-byte store is not an option.
 template <unsigned R>
 static TURBOPFOR_ALWAYS_INLINE void store_partial(unsigned char *& op, uint64_t v)
 {
     static_assert(R >= 1 && R <= 7);
-    if constexpr (R >= 4)
-    {
-        storeU32Fast(op, static_cast<uint32_t>(v));
-        op += 4u;
-        if constexpr (R >= 6)
-        {
-            storeU16Fast(op, static_cast<uint16_t>(v >> 32));
-            op += 2u;
-            if constexpr (R == 7)
-            {
-                *op++ = static_cast<unsigned char>(v >> 48);
-            }
-        }
-        else if constexpr (R == 5)
-        {
-            *op++ = static_cast<unsigned char>(v >> 32);
-        }
-    }
-    else if constexpr (R >= 2)
-    {
-        storeU16Fast(op, static_cast<uint16_t>(v));
-        op += 2u;
-        if constexpr (R == 3)
-        {
-            *op++ = static_cast<unsigned char>(v >> 16);
-        }
-    }
-    else
-    {
-        *op++ = static_cast<unsigned char>(v);
-    }
+    const uint64_t le = nativeToLe64(v);
+    memcpy(op, &le, R);
+    op += R;
 }
 
 /// Load partial bytes from input (1-7 bytes into a 64-bit word)
 /// Used by bitunpack templates when the last word doesn't fill a full 8 bytes
+///
+/// At most two independent loads: for the odd sizes the second load ends
+/// exactly at ip + R, and the overlapping middle bytes OR to themselves.
+/// A single 8-byte load with a mask would be shorter still, but this can be
+/// the very last word of the stream, where reading past ip + R is not an
+/// option (the exact-load contract the unpack paths are built on).
 template <unsigned R>
 static TURBOPFOR_ALWAYS_INLINE uint64_t load_partial(const unsigned char *& ip)
 {
     static_assert(R >= 1 && R <= 7);
-    uint64_t v = 0;
-    if constexpr (R >= 4)
-    {
-        v |= static_cast<uint64_t>(loadU32Fast(ip));
-        ip += 4u;
-        if constexpr (R >= 6)
-        {
-            v |= static_cast<uint64_t>(loadU16Fast(ip)) << 32;
-            ip += 2u;
-            if constexpr (R == 7)
-            {
-                v |= static_cast<uint64_t>(ip[0]) << 48;
-                ip += 1u;
-            }
-        }
-        else if constexpr (R == 5)
-        {
-            v |= static_cast<uint64_t>(ip[0]) << 32;
-            ip += 1u;
-        }
-    }
-    else if constexpr (R >= 2)
-    {
-        v |= static_cast<uint64_t>(loadU16Fast(ip));
-        ip += 2u;
-        if constexpr (R == 3)
-        {
-            v |= static_cast<uint64_t>(ip[0]) << 16;
-            ip += 1u;
-        }
-    }
+    uint64_t v;
+    if constexpr (R == 1)
+        v = ip[0];
+    else if constexpr (R == 2)
+        v = loadU16Fast(ip);
+    else if constexpr (R == 3)
+        v = static_cast<uint64_t>(loadU16Fast(ip)) | (static_cast<uint64_t>(loadU16Fast(ip + 1u)) << 8);
+    else if constexpr (R == 4)
+        v = loadU32Fast(ip);
     else
-    {
-        v |= static_cast<uint64_t>(ip[0]);
-        ip += 1u;
-    }
+        v = static_cast<uint64_t>(loadU32Fast(ip)) | (static_cast<uint64_t>(loadU32Fast(ip + (R - 4u))) << ((R - 4u) * 8u));
+    ip += R;
     return v;
 }
 
@@ -538,6 +847,46 @@ static TURBOPFOR_ALWAYS_INLINE uint64_t load_partial(const unsigned char *& ip)
 unsigned char * bitpack32Scalar(const uint32_t * in, unsigned n, unsigned char * out, unsigned b);
 const unsigned char * bitunpack32Scalar(const unsigned char * in, unsigned n, uint32_t * out, unsigned b);
 
+/// Fixed-width unpack for callers that know b at compile time (streams
+/// cluster by width): no width dispatch, no per-call n switch. Base-ISA
+/// code — the runtime entry above goes through the IFUNC-picked vector
+/// kernels, so prefer this only for statically-known widths on short runs.
+template <unsigned B>
+const unsigned char * bitunpack32ScalarFixed(const unsigned char * in, unsigned n, uint32_t * out);
+
+extern template const unsigned char * bitunpack32ScalarFixed<1u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<2u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<3u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<4u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<5u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<6u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<7u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<8u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<9u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<10u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<11u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<12u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<13u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<14u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<15u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<16u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<17u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<18u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<19u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<20u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<21u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<22u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<23u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<24u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<25u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<26u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<27u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<28u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<29u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<30u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<31u>(const unsigned char *, unsigned, uint32_t *);
+extern template const unsigned char * bitunpack32ScalarFixed<32u>(const unsigned char *, unsigned, uint32_t *);
+
 /// Fused unpack + delta1 decode (much faster than separate unpack + delta)
 const unsigned char * bitunpackd1_32Scalar(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start, unsigned b);
 
@@ -551,6 +900,16 @@ const unsigned char * bitunpack128v32Scalar(const unsigned char * in, uint32_t *
 unsigned char * bitpack256v32Scalar(const uint32_t * in, unsigned char * out, unsigned b);
 const unsigned char * bitunpack256v32Scalar(const unsigned char * in, uint32_t * out, unsigned b);
 
+/// Fused 256v32 unpack + delta1 decode: the deltas stay in registers through
+/// the prefix sum instead of being written and immediately re-read
+const unsigned char * bitunpackd1_256v32Scalar(const unsigned char * in, uint32_t * out, uint32_t start, unsigned b);
+
+/// Pack nblocks consecutive 256-element blocks with one call. Output is the
+/// plain concatenation of the per-block streams (byte-identical to looping
+/// over bitpack256v32Scalar); one dispatch and one width-constant setup cover
+/// the whole run.
+unsigned char * bitpack256v32ScalarN(const uint32_t * in, unsigned char * out, unsigned b, unsigned nblocks);
+
 // Variable-byte encoding constants (matching TurboPFor vlcbyte.h scheme)
 //
 // TurboPFor uses VB_MAX = 0xFD (not 0xFF), reserving:
@@ -584,44 +943,49 @@ constexpr unsigned VBYTE64_THRESHOLD_2BYTE = 152u; // _vbo1 = 0x98 = 152
 constexpr unsigned VBYTE64_THRESHOLD_3BYTE = 16536u; // _vbo2 = 152 + 16384 = 16536
 constexpr unsigned VBYTE64_THRESHOLD_RAW = 2113688u; // _vbo3 = 16536 + 2097152 = 2113688
 
-/// Inline single-value variable-byte decoder (matches TurboPFor _vbget32 macro)
-/// Uses likely() hints for optimal branch prediction since small values are most common.
-TURBOPFOR_ALWAYS_INLINE const unsigned char * vbGet32Inline(const unsigned char * in, uint32_t & x)
+/// Per-marker decode controls for the branchless single-value decoder. The
+/// marker byte alone determines the size class, the payload mask and the
+/// constant part of the value (marker high bits shifted into place plus the
+/// class base), so one 256-entry LUT replaces the four-way compare chain.
+struct VbMarkerInfo
 {
-    const unsigned marker = *in++;
-
-    if (TURBOPFOR_LIKELY(marker < VBYTE_MARKER_2BYTE)) // marker < 0x9C (most common)
-    {
-        // 1-byte encoding: value stored directly in marker
-        x = marker;
-        return in;
-    }
-
-    if (TURBOPFOR_LIKELY(marker < VBYTE_MARKER_3BYTE)) // marker < 0xDC
-    {
-        // 2-byte encoding: reconstruct value from marker + 1 data byte
-        const unsigned data_byte = *in++;
-        x = ((marker - VBYTE_MARKER_2BYTE) << 8) + data_byte + VBYTE_THRESHOLD_2BYTE;
-        return in;
-    }
+    uint32_t bias; // (marker - class marker base) << shift, plus the class value base
+    uint32_t lo_mask; // payload bytes contributed by the 4 bytes after the marker
+    uint8_t len; // total encoded length, marker included
+};
 
-    if (TURBOPFOR_LIKELY(marker < VBYTE_MARKER_4PLUS)) // marker < 0xFC
+constexpr std::array<VbMarkerInfo, 256> makeVbMarkerInfo()
+{
+    std::array<VbMarkerInfo, 256> table{};
+    for (unsigned marker = 0; marker < 256u; ++marker)
     {
-        // 3-byte encoding
-        const unsigned low16 = loadU16Fast(in);
-        x = low16 + ((marker - VBYTE_MARKER_3BYTE) << 16) + VBYTE_THRESHOLD_3BYTE;
-        return in + 2;
+        const unsigned c = (marker >= VBYTE_MARKER_2BYTE) + (marker >= VBYTE_MARKER_3BYTE) + (marker >= VBYTE_MARKER_4PLUS)
+            + (marker > VBYTE_MARKER_4PLUS);
+        constexpr uint8_t marker_sub[5] = {0u, VBYTE_MARKER_2BYTE, VBYTE_MARKER_3BYTE, VBYTE_MARKER_4PLUS, VBYTE_MARKER_4PLUS + 1u};
+        constexpr unsigned hi_shift[5] = {0u, 8u, 16u, 24u, 0u}; // class 3's marker delta is 0, class 4 has no marker bits
+        constexpr uint32_t lo_mask[5] = {0u, 0xFFu, 0xFFFFu, 0xFFFFFFu, 0xFFFFFFFFu};
+        constexpr uint32_t base[5] = {0u, VBYTE_THRESHOLD_2BYTE, VBYTE_THRESHOLD_3BYTE, 0u, 0u};
+        table[marker].bias = (static_cast<uint32_t>(marker - marker_sub[c]) << hi_shift[c]) + base[c];
+        table[marker].lo_mask = lo_mask[c];
+        table[marker].len = static_cast<uint8_t>(c + 1u);
     }
+    return table;
+}
 
-    // 4+ byte encoding: 0xFC = 3 bytes, 0xFD = 4 bytes (rare)
-    if (marker == VBYTE_MARKER_4PLUS)
-    {
-        x = loadU32Fast(in) & 0xFFFFFFu;
-        return in + 3;
-    }
+constexpr std::array<VbMarkerInfo, 256> vbMarkerInfo = makeVbMarkerInfo();
 
-    x = loadU32Fast(in);
-    return in + 4;
+/// Branchless single-value variable-byte decoder: a table load, a payload
+/// load, a mask and an add — no marker compares, so high-entropy streams pay
+/// no mispredictions.
+///
+/// Reads 4 bytes past the marker unconditionally; callers must guarantee
+/// that much input remains after it (vbDec32 bounces the stream tail through
+/// a zero-padded buffer to keep this safe for the last few values).
+TURBOPFOR_ALWAYS_INLINE const unsigned char * vbGet32Branchless(const unsigned char * in, uint32_t & x)
+{
+    const VbMarkerInfo & info = vbMarkerInfo[in[0]];
+    x = info.bias + (loadU32Fast(in + 1) & info.lo_mask);
+    return in + info.len;
 }
 
 /// Variable-byte encoding/decoding (32-bit)
@@ -635,6 +999,28 @@ const unsigned char * vbDec32(const unsigned char * in, unsigned n, uint32_t * o
 /// - [0x98..0xD7]: 2-byte encoding, value = 152 + decode(marker, data_byte)
 /// - [0xD8..0xF7]: 3-byte encoding, value = 16536 + decode(marker, data16)
 /// - [0xF8..0xFD]: raw encoding, (marker - 0xF8 + 3) raw bytes follow
+/// Out-of-line continuation of vbGet64Inline for markers >= 0xD8 (values
+/// needing 3+ bytes). Exception values that large are rare in delta streams,
+/// so the code sits in a cold section instead of being replicated into every
+/// unrolled call site of the inline fast path.
+[[gnu::cold]] [[gnu::noinline]] inline const unsigned char * vbGet64Long(const unsigned char * in, uint64_t & x, unsigned marker)
+{
+    if (marker < VBYTE64_MARKER_RAW) // marker < 0xF8
+    {
+        // 3-byte encoding: marker + 2 data bytes (little-endian)
+        const unsigned low16 = loadU16Fast(in);
+        x = low16 + ((marker - VBYTE64_MARKER_3BYTE) << 16) + VBYTE64_THRESHOLD_3BYTE;
+        return in + 2;
+    }
+
+    // Raw encoding: marker 0xF8..0xFD = 3..8 raw bytes
+    const unsigned raw_bytes = (marker - VBYTE64_MARKER_RAW) + 3u;
+    // Read up to 8 bytes and mask to the appropriate width
+    // Note: reading 8 bytes is safe because TurboPFor always overallocates
+    x = loadU64Fast(in) & ((raw_bytes >= 8u) ? 0xFFFFFFFFFFFFFFFFull : ((1ull << (raw_bytes * 8u)) - 1ull));
+    return in + raw_bytes;
+}
+
 TURBOPFOR_ALWAYS_INLINE const unsigned char * vbGet64Inline(const unsigned char * in, uint64_t & x)
 {
     const unsigned marker = *in++;
@@ -653,20 +1039,10 @@ TURBOPFOR_ALWAYS_INLINE const unsigned char * vbGet64Inline(const unsigned char
         return in;
     }
 
-    if (TURBOPFOR_LIKELY(marker < VBYTE64_MARKER_RAW)) // marker < 0xF8
-    {
-        // 3-byte encoding: marker + 2 data bytes (little-endian)
-        const unsigned low16 = loadU16Fast(in);
-        x = low16 + ((marker - VBYTE64_MARKER_3BYTE) << 16) + VBYTE64_THRESHOLD_3BYTE;
-        return in + 2;
-    }
-
-    // Raw encoding: marker 0xF8..0xFD = 3..8 raw bytes
-    const unsigned raw_bytes = (marker - VBYTE64_MARKER_RAW) + 3u;
-    // Read up to 8 bytes and mask to the appropriate width
-    // Note: reading 8 bytes is safe because TurboPFor always overallocates
-    x = loadU64Fast(in) & ((raw_bytes >= 8u) ? 0xFFFFFFFFFFFFFFFFull : ((1ull << (raw_bytes * 8u)) - 1ull));
-    return in + raw_bytes;
+    // 3-byte and raw encodings live out of line; the inlined portion stays
+    // two compares and two loads, which keeps the 8x unrolled vbDec64 loop
+    // inside a few cache lines.
+    return vbGet64Long(in, x, marker);
 }
 
 /// Variable-byte encoding/decoding (64-bit)
@@ -17,25 +17,55 @@ inline unsigned p4Bits128(const uint32_t * in, unsigned * pbx)
 {
     constexpr unsigned n = 128;
 
-    // Phase 1: Fast scan to find OR of all values and count equal to first
+    // Phase 1: Fast scan to find OR of all values and whether any differs
+    // from the first (the constant check only needs a boolean, so an OR of
+    // XORs replaces the old per-element match count)
     uint32_t or_acc = 0;
     const uint32_t first = in[0];
-    unsigned eq = 0;
+    uint32_t diff_acc = 0;
 
+#if defined(__x86_64__)
+    // 8 lanes per step over the whole 512-byte block; two accumulator pairs
+    // hide the por latency. This header compiles in baseline-ISA TUs, so
+    // SSE2 rather than AVX2.
+    {
+        const __m128i vfirst = _mm_set1_epi32(static_cast<int>(first));
+        __m128i vor0 = _mm_setzero_si128(), vor1 = _mm_setzero_si128();
+        __m128i vdiff0 = _mm_setzero_si128(), vdiff1 = _mm_setzero_si128();
+        for (unsigned i = 0; i < n; i += 8)
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+            const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 4));
+            vor0 = _mm_or_si128(vor0, a);
+            vor1 = _mm_or_si128(vor1, c);
+            vdiff0 = _mm_or_si128(vdiff0, _mm_xor_si128(a, vfirst));
+            vdiff1 = _mm_or_si128(vdiff1, _mm_xor_si128(c, vfirst));
+        }
+        __m128i vor = _mm_or_si128(vor0, vor1);
+        vor = _mm_or_si128(vor, _mm_shuffle_epi32(vor, _MM_SHUFFLE(1, 0, 3, 2)));
+        vor = _mm_or_si128(vor, _mm_shuffle_epi32(vor, _MM_SHUFFLE(2, 3, 0, 1)));
+        or_acc = static_cast<uint32_t>(_mm_cvtsi128_si32(vor));
+        __m128i vdiff = _mm_or_si128(vdiff0, vdiff1);
+        vdiff = _mm_or_si128(vdiff, _mm_shuffle_epi32(vdiff, _MM_SHUFFLE(1, 0, 3, 2)));
+        vdiff = _mm_or_si128(vdiff, _mm_shuffle_epi32(vdiff, _MM_SHUFFLE(2, 3, 0, 1)));
+        diff_acc = static_cast<uint32_t>(_mm_cvtsi128_si32(vdiff));
+    }
+#else
     // Unroll 8x for better throughput
     for (unsigned i = 0; i < n; i += 8)
     {
         or_acc |= in[i] | in[i + 1] | in[i + 2] | in[i + 3] | in[i + 4] | in[i + 5] | in[i + 6] | in[i + 7];
 
-        eq += (in[i] == first) + (in[i + 1] == first) + (in[i + 2] == first) + (in[i + 3] == first) + (in[i + 4] == first)
-            + (in[i + 5] == first) + (in[i + 6] == first) + (in[i + 7] == first);
+        diff_acc |= (in[i] ^ first) | (in[i + 1] ^ first) | (in[i + 2] ^ first) | (in[i + 3] ^ first) | (in[i + 4] ^ first)
+            | (in[i + 5] ^ first) | (in[i + 6] ^ first) | (in[i + 7] ^ first);
     }
+#endif
 
     // Compute bit width from OR result
     unsigned b = bitWidth32(or_acc);
 
     // Check for constant block (all values equal and non-zero)
-    if (eq == n && first != 0u)
+    if (diff_acc == 0u && first != 0u)
     {
         *pbx = MAX_BITS + 2u;
         return b;
@@ -49,8 +79,49 @@ inline unsigned p4Bits128(const uint32_t * in, unsigned * pbx)
     }
 
     // Phase 2: Build histogram of bit widths
-    alignas(64) unsigned cnt[MAX_BITS + 8] = {0};
-
+    // Padded past MAX_BITS so the Phase 3 vbyte-cost gather can read
+    // cnt[i + 25] unguarded — the tail stays zero and contributes nothing.
+    alignas(64) unsigned cnt[MAX_BITS + 25] = {0};
+
+#if defined(__x86_64__)
+    // Widths 8 lanes at a time via the float-exponent trick, applied to the
+    // 16-bit halves of each lane: both halves fit the 24-bit mantissa, so
+    // the signed convert is exact and never sees a negative, and the biased
+    // exponent is the half's bit width plus 126. A compare against zero
+    // selects high-half-plus-16 or the low half and zeroes all-zero lanes.
+    // Only the counter increments stay scalar.
+    {
+        const __m128i lo_mask = _mm_set1_epi32(0xFFFF);
+        const __m128i bias = _mm_set1_epi32(126);
+        const __m128i sixteen = _mm_set1_epi32(16);
+        const __m128i zero = _mm_setzero_si128();
+        alignas(16) uint32_t widths[8];
+        for (unsigned i = 0; i < n; i += 8)
+        {
+            for (unsigned g = 0; g < 2u; ++g)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 4u * g));
+                const __m128i hi = _mm_srli_epi32(v, 16);
+                const __m128i lo = _mm_and_si128(v, lo_mask);
+                const __m128i wh = _mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(_mm_cvtepi32_ps(hi)), 23), bias);
+                const __m128i wl = _mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(_mm_cvtepi32_ps(lo)), 23), bias);
+                const __m128i hi_zero = _mm_cmpeq_epi32(hi, zero);
+                const __m128i lo_zero = _mm_cmpeq_epi32(lo, zero);
+                const __m128i w = _mm_or_si128(
+                    _mm_andnot_si128(hi_zero, _mm_add_epi32(wh, sixteen)), _mm_and_si128(hi_zero, _mm_andnot_si128(lo_zero, wl)));
+                _mm_store_si128(reinterpret_cast<__m128i *>(widths + 4u * g), w);
+            }
+            ++cnt[widths[0]];
+            ++cnt[widths[1]];
+            ++cnt[widths[2]];
+            ++cnt[widths[3]];
+            ++cnt[widths[4]];
+            ++cnt[widths[5]];
+            ++cnt[widths[6]];
+            ++cnt[widths[7]];
+        }
+    }
+#else
     // Process 8 elements at a time - lzcnt is branchless
     for (unsigned i = 0; i < n; i += 8)
     {
@@ -63,6 +134,7 @@ inline unsigned p4Bits128(const uint32_t * in, unsigned * pbx)
         ++cnt[bitWidth32(in[i + 6])];
         ++cnt[bitWidth32(in[i + 7])];
     }
+#endif
 
     // Phase 3: Find optimal bit width using cost model
     unsigned bx = b;
@@ -78,19 +150,15 @@ inline unsigned p4Bits128(const uint32_t * in, unsigned * pbx)
         return b;
     }
 
-    // vb array for variable-byte cost estimation
-    int vb_storage[MAX_BITS * 2 + 64 + 16] = {0};
-    int * vb = vb_storage + MAX_BITS + 16;
-
-    auto vbb = [&vb](unsigned xval, int bval) {
-        vb[bval - 7] += static_cast<int>(xval);
-        vb[bval - 15] += static_cast<int>(xval * 2u);
-        vb[bval - 19] += static_cast<int>(xval * 3u);
-        vb[bval - 25] += static_cast<int>(xval * 4u);
-    };
-
+    // Variable-byte cost growth per step. Every width w in [0, bx] used to
+    // register cnt[w] into a delay-line array read 7/15/19/25 iterations
+    // later; but those writes only ever came from the histogram, so the
+    // value read at step i is just a gather over cnt[] at fixed offsets:
+    //   cnt[i+7] + 2*cnt[i+15] + 3*cnt[i+19] + 4*cnt[i+25]
+    // (extra bytes the exception stream grows by when the base drops past
+    // each vbyte length threshold). Reading the histogram directly removes
+    // the 576-byte zeroed scratch array and its store-to-load chain.
     int vv = static_cast<int>(x);
-    vbb(x, static_cast<int>(bx));
 
     int fx = 0;
 
@@ -102,8 +170,7 @@ inline unsigned p4Bits128(const uint32_t * in, unsigned * pbx)
         const int l = static_cast<int>(pad8(n * ui) + 2 + bmp8 + pad8(x * (bx - ui)));
 
         x += cnt[ui];
-        vv += static_cast<int>(cnt[ui]) + vb[i];
-        vbb(cnt[ui], i);
+        vv += static_cast<int>(cnt[ui] + cnt[ui + 7u] + 2u * cnt[ui + 15u] + 3u * cnt[ui + 19u] + 4u * cnt[ui + 25u]);
 
         fi = l < ml;
         ml = fi ? l : ml;
@@ -36,17 +36,152 @@ namespace
 //   out: Array to decode in-place
 //   n: Number of elements
 //   start: Initial value (previous element before this block)
-void applyDelta1(uint32_t * out, unsigned n, uint32_t start)
+//
+// Force-inlined so a caller with a compile-time n (the pinned N == 128
+// instantiations below) gets a constant trip count and no scalar tail.
+TURBOPFOR_ALWAYS_INLINE void applyDelta1(uint32_t * out, unsigned n, uint32_t start)
 {
     if (n == 0u)
         return;
 
+#if defined(__SSE2__)
+    // SIMD prefix sum: the serial form is one loop-carried add per element,
+    // so the whole pass costs n cycles of dependency chain. Per 4-lane
+    // vector: add the +1 offset, two shift-and-add steps build the in-lane
+    // prefix sum, then the running carry is added and the last lane is
+    // broadcast as the next carry — the chain shrinks to one vector add per
+    // 4 elements.
+    __m128i * op = reinterpret_cast<__m128i *>(out);
+    const __m128i ones = _mm_set1_epi32(1);
+    __m128i carry = _mm_set1_epi32(static_cast<int>(start));
+
+    const unsigned vec_count = n / 4u;
+    for (unsigned i = 0; i < vec_count; ++i)
+    {
+        __m128i v = _mm_loadu_si128(op + i);
+        v = _mm_add_epi32(v, ones);
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, carry);
+        _mm_storeu_si128(op + i, v);
+        carry = _mm_shuffle_epi32(v, 0xFF);
+    }
+
+    uint32_t acc = vec_count > 0u ? out[vec_count * 4u - 1u] : start;
+    for (unsigned i = vec_count * 4u; i < n; ++i)
+    {
+        acc += out[i] + 1u;
+        out[i] = acc;
+    }
+#else
+    uint32_t acc = start;
+    for (unsigned i = 0; i < n; ++i)
+    {
+        acc += out[i] + 1u;
+        out[i] = acc;
+    }
+#endif
+}
+
+// Apply bitmap exception patches and delta1 decoding in one pass
+//
+// bitunpackPatch32 followed by applyDelta1 walks out[0..n) twice — one pass
+// to OR the patches in, one for the prefix sum — and exceptions are sparse,
+// so the patch pass mostly revisits lines the prefix sum is about to load
+// anyway. This fused form keeps the SIMD prefix sum of applyDelta1 and
+// splices each patch in just ahead of the vector that consumes it, so the
+// block is traversed once.
+//
+// The bitmap walk yields ascending positions, so a single cursor over the
+// index array and the packed exception fields suffices; the fast path per
+// vector is one well-predicted compare against the next patch position.
+//
+// Parameters:
+//   ex_ptr: Exception region ([count x bx-bit fields], byte-padded)
+//   count: Number of exceptions
+//   out: Array holding unpacked base values; decoded in-place
+//   n: Number of elements
+//   start: Delta1 start value
+//   b: Base bit width (shift for patches)
+//   bx: Exception bit width
+//   bitmap: Exception position bitmap
+//   words: Number of 64-bit bitmap words
+void patchApplyDelta1(
+    const unsigned char * ex_ptr,
+    unsigned count,
+    uint32_t * out,
+    unsigned n,
+    uint32_t start,
+    unsigned b,
+    unsigned bx,
+    const uint64_t * bitmap,
+    unsigned words)
+{
+    using namespace turbopfor::scalar::detail;
+
+    // Expand the bitmap into ascending patch positions (8 bytes of slack
+    // for the byte-at-a-time expansion)
+    unsigned char idx[MAX_VALUES + 8];
+    expandBitmapIndices(bitmap, words, idx);
+
+    // Zero-padded copy of the final field bytes so no load crosses the end
+    // of the exception region (same contract as bitunpackPatch32)
+    const unsigned ex_bytes = pad8(count * bx);
+    const uint64_t field_mask = maskBits(bx);
+    unsigned char tail[16] = {};
+    const unsigned tail_start = ex_bytes > 8u ? ex_bytes - 8u : 0u;
+    for (unsigned i = tail_start; i < ex_bytes; ++i)
+        tail[i - tail_start] = ex_ptr[i];
+
+    unsigned k = 0;
+    const auto applyPatchesBelow = [&](unsigned limit)
+    {
+        while (k < count && idx[k] < limit)
+        {
+            const unsigned bitpos = k * bx;
+            const unsigned ofs = bitpos >> 3u;
+            const uint64_t w = ofs + 8u <= ex_bytes ? loadU64Fast(ex_ptr + ofs) : loadU64Fast(tail + (ofs - tail_start));
+            out[idx[k]] |= static_cast<uint32_t>((w >> (bitpos & 7u)) & field_mask) << b;
+            ++k;
+        }
+    };
+
+#if defined(__SSE2__)
+    // Same prefix-sum kernel as applyDelta1; each patched store is consumed
+    // by the very next vector load via store-to-load forwarding
+    __m128i * op = reinterpret_cast<__m128i *>(out);
+    const __m128i ones = _mm_set1_epi32(1);
+    __m128i carry = _mm_set1_epi32(static_cast<int>(start));
+
+    const unsigned vec_count = n / 4u;
+    for (unsigned i = 0; i < vec_count; ++i)
+    {
+        applyPatchesBelow(i * 4u + 4u);
+        __m128i v = _mm_loadu_si128(op + i);
+        v = _mm_add_epi32(v, ones);
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, carry);
+        _mm_storeu_si128(op + i, v);
+        carry = _mm_shuffle_epi32(v, 0xFF);
+    }
+
+    uint32_t acc = vec_count > 0u ? out[vec_count * 4u - 1u] : start;
+    for (unsigned i = vec_count * 4u; i < n; ++i)
+    {
+        applyPatchesBelow(i + 1u);
+        acc += out[i] + 1u;
+        out[i] = acc;
+    }
+#else
     uint32_t acc = start;
     for (unsigned i = 0; i < n; ++i)
     {
+        applyPatchesBelow(i + 1u);
         acc += out[i] + 1u;
         out[i] = acc;
     }
+#endif
 }
 
 // Decode P4 payload with bitmap exceptions for 128v32 format
@@ -55,82 +190,47 @@ void applyDelta1(uint32_t * out, unsigned n, uint32_t start)
 //
 // Parameters:
 //   in: Input buffer positioned at bitmap
-//   n: Number of elements (typically 128)
+//   n_rt: Number of elements (typically 128)
 //   out: Output array
 //   start: Delta1 start value
 //   b: Base bit width (with 0x80 flag cleared)
 //   bx: Exception bit width
 //
+// The block length is a template parameter following the p4Bits32Impl
+// pattern: N == 0 compiles the runtime-length version, N == 128 pins the
+// whole-block size so words, pad8(n) and the bitmap tail mask all
+// constant-fold and the two bitmap words stay in registers.
+//
 // Returns: Pointer past end of consumed input
+template <unsigned N>
 const unsigned char * p4D1Dec128PayloadBitmap(
-    const unsigned char * in, unsigned n, uint32_t * out, uint32_t start, unsigned b, unsigned bx)
+    const unsigned char * in, unsigned n_rt, uint32_t * out, uint32_t start, unsigned b, unsigned bx)
 {
     using namespace turbopfor::scalar::detail;
 
+    const unsigned n = (N != 0u) ? N : n_rt;
+
     // Phase 1: Read and parse bitmap
     //
     // Bitmap has n bits (one per value), padded to byte boundary
     // Bit set = position has exception that needs patching
     uint64_t bitmap[MAX_VALUES / 64] = {0};
     const unsigned words = (n + 63u) / 64u;
-    unsigned exception_count = 0;
-
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = loadU64(in + i * sizeof(uint64_t));
-
-        // Mask off unused bits in last word
-        if (i == words - 1u && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-
-        // Count exceptions using popcount
-#if defined(__GNUC__) || defined(__clang__)
-        exception_count += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        while (word)
-        {
-            ++exception_count;
-            word &= word - 1ull;
-        }
-#endif
-    }
+    unsigned exception_count = loadBitmap(in, n, bitmap);
 
     const unsigned char * ip = in + pad8(n);
 
-    // Phase 2: Unpack exception values (horizontal bitpacking)
-    uint32_t exceptions[MAX_VALUES + 64];
-    ip = bitunpack32Scalar(ip, exception_count, exceptions, bx);
+    // Phase 2: Note the exception region; the fields are consumed during
+    // the fused patch below, after the base values exist to patch into
+    const unsigned char * ex_ptr = ip;
+    ip += pad8(exception_count * bx);
 
     // Phase 3: Unpack base values (128v32 vertical bitpacking)
     ip = bitunpack128v32Scalar(ip, out, b);
 
-    // Phase 4: Apply patches
-    //
-    // For each set bit in bitmap, OR in the high bits from exceptions
-    unsigned k = 0;
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = bitmap[i];
-        while (word)
-        {
-            // Find lowest set bit
-#if defined(__GNUC__) || defined(__clang__)
-            unsigned bit = static_cast<unsigned>(__builtin_ctzll(word));
-#else
-            unsigned bit = 0;
-            while (((word >> bit) & 1ull) == 0ull)
-                ++bit;
-#endif
-            const unsigned idx = i * 64u + bit;
-            out[idx] |= static_cast<uint32_t>(exceptions[k++] << b);
-            word &= word - 1ull; // Clear lowest set bit
-        }
-    }
-
-    // Phase 5: Apply delta1 decoding
-    applyDelta1(out, n, start);
+    // Phase 4: Unpack exceptions, apply patches and delta1-decode in a
+    // single pass over the block
+    patchApplyDelta1(ex_ptr, exception_count, out, n, start, b, bx, bitmap, words);
 
     return ip;
 }
@@ -143,18 +243,21 @@ const unsigned char * p4D1Dec128PayloadBitmap(
 //
 // Parameters:
 //   in: Input buffer positioned at payload
-//   n: Number of elements (typically 128)
+//   n_rt: Number of elements (typically 128)
 //   out: Output array
 //   start: Delta1 start value
 //   b: Base bit width (may have 0x80 flag)
 //   bx: Exception strategy (0 = none, 1-31 = bitmap patching)
 //
 // Returns: Pointer past end of consumed input
+template <unsigned N>
 const unsigned char * p4D1Dec128Payload(
-    const unsigned char * in, unsigned n, uint32_t * out, uint32_t start, unsigned b, unsigned bx)
+    const unsigned char * in, unsigned n_rt, uint32_t * out, uint32_t start, unsigned b, unsigned bx)
 {
     using namespace turbopfor::scalar::detail;
 
+    const unsigned n = (N != 0u) ? N : n_rt;
+
     // Check for exception flag in b
     if ((b & 0x80u) == 0u)
     {
@@ -176,7 +279,7 @@ const unsigned char * p4D1Dec128Payload(
     }
 
     // Bitmap exception handling
-    return p4D1Dec128PayloadBitmap(in, n, out, start, b, bx);
+    return p4D1Dec128PayloadBitmap<N>(in, n, out, start, b, bx);
 }
 
 } // namespace
@@ -195,6 +298,12 @@ const unsigned char * p4D1Dec128Payload(
 // Returns: Pointer past end of consumed input
 //
 // Binary compatibility: Correctly decodes data from both scalar and SIMD encoders
+//
+// No target_clones here: the dispatch.cpp resolver takes this function's
+// address, so it must stay a plain symbol (an IFUNC whose address feeds
+// another IFUNC resolver is resolved in unspecified IRELATIVE order). The
+// resolver only ever picks this path on hosts without SSE4.2, where an AVX2
+// tier could not be selected anyway.
 const unsigned char * p4D1Dec128v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
 {
     using namespace turbopfor::scalar::detail;
@@ -218,12 +327,9 @@ const unsigned char * p4D1Dec128v32(const unsigned char * in, unsigned n, uint32
         if (b < MAX_BITS)
             value &= maskBits(b);
 
-        // Fill output with constant
-        for (unsigned i = 0; i < n; ++i)
-            out[i] = value;
-
-        // Apply delta1 decoding
-        applyDelta1(out, n, start);
+        // Constant delta means the output is an arithmetic progression;
+        // skip the fill + prefix-sum pair and emit it in closed form
+        applyDelta1Constant(out, n, start, value);
 
         return ip + (b + 7u) / 8u;
     }
@@ -238,7 +344,11 @@ const unsigned char * p4D1Dec128v32(const unsigned char * in, unsigned n, uint32
         if (b & 0x80u)
             bx = *ip++; // Read exception bit width
 
-        return p4D1Dec128Payload(ip, n, out, start, b, bx);
+        // Whole blocks dominate every decode loop; route them to the pinned
+        // instantiation and keep the runtime-length version for tails.
+        if (n == 128u)
+            return p4D1Dec128Payload<128u>(ip, n, out, start, b, bx);
+        return p4D1Dec128Payload<0u>(ip, n, out, start, b, bx);
     }
 
     // Case 3: Variable-byte exception encoding
@@ -255,9 +365,8 @@ const unsigned char * p4D1Dec128v32(const unsigned char * in, unsigned n, uint32
     uint32_t exceptions[MAX_VALUES + 64];
     ip = vbDec32(ip, bx, exceptions);
 
-    // Apply patches using position list
-    for (unsigned i = 0; i < bx; ++i)
-        out[ip[i]] |= static_cast<uint32_t>(exceptions[i] << b);
+    // Apply patches using position list (gather/scatter on capable hosts)
+    patchPositions32(out, ip, exceptions, b, bx);
 
     ip += bx;
 
@@ -67,30 +67,7 @@ p4D1Dec128v64PayloadBitmap(const unsigned char * in, unsigned n, uint64_t * out,
     // Bit set = position has exception that needs patching
     uint64_t bitmap[MAX_VALUES / 64] = {0};
     const unsigned words = (n + 63u) / 64u;
-    unsigned exception_count = 0;
-
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = loadU64Fast(in + i * sizeof(uint64_t));
-
-        // Mask off unused bits in last word
-        if (i == words - 1u && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-
-        // Count exceptions using popcount
-#if defined(__GNUC__) || defined(__clang__)
-        exception_count += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        uint64_t tmp = word;
-        while (tmp)
-        {
-            ++exception_count;
-            tmp &= tmp - 1ull;
-        }
-#endif
-    }
+    unsigned exception_count = loadBitmap(in, n, bitmap);
 
     const unsigned char * ip = in + pad8(n);
 
@@ -109,24 +86,7 @@ p4D1Dec128v64PayloadBitmap(const unsigned char * in, unsigned n, uint64_t * out,
     // Phase 4: Apply patches
     //
     // For each set bit in bitmap, OR in the high bits from exceptions
-    unsigned k = 0;
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = bitmap[i];
-        while (word)
-        {
-#if defined(__GNUC__) || defined(__clang__)
-            unsigned bit = static_cast<unsigned>(__builtin_ctzll(word));
-#else
-            unsigned bit = 0;
-            while (((word >> bit) & 1ull) == 0ull)
-                ++bit;
-#endif
-            const unsigned idx = i * 64u + bit;
-            out[idx] |= exceptions[k++] << b;
-            word &= word - 1ull; // Clear lowest set bit
-        }
-    }
+    patchExceptions(out, bitmap, words, exceptions, b, exception_count);
 
     // Phase 5: Apply delta1 decoding
     applyDelta1_64(out, n, start);
@@ -183,9 +143,9 @@ const unsigned char * p4D1Dec128v64(const unsigned char * in, unsigned n, uint64
         if (b < 64u)
             value &= (1ull << b) - 1ull;
 
-        // Fill output with constant + apply delta1
-        for (unsigned i = 0; i < n; ++i)
-            out[i] = (start += value) + (i + 1u);
+        // Constant delta collapses to an arithmetic progression — one
+        // vector add per store, no loop-carried chain
+        applyDelta1Constant64(out, n, start, value);
 
         return ip + bytes_stored;
     }
@@ -305,26 +265,7 @@ const unsigned char * p4Dec128v64(const unsigned char * in, unsigned n, uint64_t
         // Inline here since the non-delta bitmap helper is local to this TU
         uint64_t bitmap[MAX_VALUES / 64] = {0};
         const unsigned words = (n + 63u) / 64u;
-        unsigned exception_count = 0;
-
-        for (unsigned i = 0; i < words; ++i)
-        {
-            uint64_t word = loadU64Fast(ip + i * sizeof(uint64_t));
-            if (i == words - 1u && (n & 0x3Fu))
-                word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-            bitmap[i] = word;
-#if defined(__GNUC__) || defined(__clang__)
-            exception_count += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-            uint64_t tmp = word;
-            while (tmp)
-            {
-                ++exception_count;
-                tmp &= tmp - 1ull;
-            }
-#endif
-        }
+        unsigned exception_count = loadBitmap(ip, n, bitmap);
 
         ip += pad8(n);
 
@@ -333,24 +274,7 @@ const unsigned char * p4Dec128v64(const unsigned char * in, unsigned n, uint64_t
 
         ip = bitunpack128v64Scalar(ip, out, b);
 
-        unsigned k = 0;
-        for (unsigned i = 0; i < words; ++i)
-        {
-            uint64_t word = bitmap[i];
-            while (word)
-            {
-#if defined(__GNUC__) || defined(__clang__)
-                unsigned bit = static_cast<unsigned>(__builtin_ctzll(word));
-#else
-                unsigned bit = 0;
-                while (((word >> bit) & 1ull) == 0ull)
-                    ++bit;
-#endif
-                const unsigned idx = i * 64u + bit;
-                out[idx] |= exceptions[k++] << b;
-                word &= word - 1ull;
-            }
-        }
+        patchExceptions(out, bitmap, words, exceptions, b, exception_count);
 
         return ip;
     }
@@ -41,12 +41,42 @@ void applyDelta1_256(uint32_t * out, unsigned n, uint32_t start)
     if (n == 0u)
         return;
 
+#if defined(__SSE2__)
+    // SIMD prefix sum: the serial form is one loop-carried add per element.
+    // Per 4-lane vector: add the +1 offset, two shift-and-add steps build
+    // the in-lane prefix sum, then the running carry is added and the last
+    // lane is broadcast as the next carry — one vector add of chain per 4
+    // elements instead of 4 scalar adds.
+    __m128i * op = reinterpret_cast<__m128i *>(out);
+    const __m128i ones = _mm_set1_epi32(1);
+    __m128i carry = _mm_set1_epi32(static_cast<int>(start));
+
+    const unsigned vec_count = n / 4u;
+    for (unsigned i = 0; i < vec_count; ++i)
+    {
+        __m128i v = _mm_loadu_si128(op + i);
+        v = _mm_add_epi32(v, ones);
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, carry);
+        _mm_storeu_si128(op + i, v);
+        carry = _mm_shuffle_epi32(v, 0xFF);
+    }
+
+    uint32_t acc = vec_count > 0u ? out[vec_count * 4u - 1u] : start;
+    for (unsigned i = vec_count * 4u; i < n; ++i)
+    {
+        acc += out[i] + 1u;
+        out[i] = acc;
+    }
+#else
     uint32_t acc = start;
     for (unsigned i = 0; i < n; ++i)
     {
         acc += out[i] + 1u;
         out[i] = acc;
     }
+#endif
 }
 
 // Decode P4 payload with bitmap exceptions for 256v32 format
@@ -73,61 +103,20 @@ const unsigned char * p4D1Dec256PayloadBitmap(
     // Bit set = position has exception that needs patching
     uint64_t bitmap[MAX_VALUES / 64] = {0};
     const unsigned words = (n + 63u) / 64u;
-    unsigned exception_count = 0;
-
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = loadU64Fast(in + i * sizeof(uint64_t));
-
-        // Mask off unused bits in last word
-        if (i == words - 1u && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-
-        // Count exceptions using popcount
-#if defined(__GNUC__) || defined(__clang__)
-        exception_count += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        while (word)
-        {
-            ++exception_count;
-            word &= word - 1ull;
-        }
-#endif
-    }
+    unsigned exception_count = loadBitmap(in, n, bitmap);
 
     const unsigned char * ip = in + pad8(n);
 
-    // Phase 2: Unpack exception values (horizontal bitpacking)
-    uint32_t exceptions[MAX_VALUES + 64];
-    ip = bitunpack32Scalar(ip, exception_count, exceptions, bx);
+    // Phase 2: Note the exception region; the fields are consumed during
+    // the fused patch below, after the base values exist to patch into
+    const unsigned char * ex_ptr = ip;
+    ip += pad8(exception_count * bx);
 
     // Phase 3: Unpack base values (256v32 vertical bitpacking)
     ip = bitunpack256v32Scalar(ip, out, b);
 
-    // Phase 4: Apply patches
-    //
-    // For each set bit in bitmap, OR in the high bits from exceptions
-    unsigned k = 0;
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = bitmap[i];
-        while (word)
-        {
-            // Find lowest set bit
-#if defined(__GNUC__) || defined(__clang__)
-            unsigned bit = static_cast<unsigned>(__builtin_ctzll(word));
-#else
-            unsigned bit = 0;
-            while (((word >> bit) & 1ull) == 0ull)
-                ++bit;
-#endif
-            const unsigned idx = i * 64u + bit;
-            out[idx] |= static_cast<uint32_t>(exceptions[k++] << b);
-            word &= word - 1ull; // Clear lowest set bit
-        }
-    }
+    // Phase 4: Unpack exceptions and apply patches in one pass
+    bitunpackPatch32(ex_ptr, exception_count, out, b, bx, bitmap, words);
 
     // Phase 5: Apply delta1 decoding
     applyDelta1_256(out, n, start);
@@ -158,10 +147,8 @@ const unsigned char * p4D1Dec256Payload(
     // Check for exception flag in b
     if ((b & 0x80u) == 0u)
     {
-        // No exceptions - simple unpack + delta1
-        const unsigned char * ip = bitunpack256v32Scalar(in, out, b);
-        applyDelta1_256(out, n, start);
-        return ip;
+        // No exceptions - fused unpack + delta1, deltas never hit memory
+        return bitunpackd1_256v32Scalar(in, out, start, b);
     }
 
     // Clear exception flag
@@ -169,10 +156,8 @@ const unsigned char * p4D1Dec256Payload(
 
     if (bx == 0u)
     {
-        // Bitmap says no exceptions - simple unpack + delta1
-        const unsigned char * ip = bitunpack256v32Scalar(in, out, b);
-        applyDelta1_256(out, n, start);
-        return ip;
+        // Bitmap says no exceptions - fused unpack + delta1
+        return bitunpackd1_256v32Scalar(in, out, start, b);
     }
 
     // Bitmap exception handling
@@ -218,12 +203,9 @@ const unsigned char * p4D1Dec256v32(const unsigned char * in, unsigned n, uint32
         if (b < MAX_BITS)
             value &= maskBits(b);
 
-        // Fill output with constant
-        for (unsigned i = 0; i < n; ++i)
-            out[i] = value;
-
-        // Apply delta1 decoding
-        applyDelta1_256(out, n, start);
+        // Constant delta means the output is an arithmetic progression;
+        // skip the fill + prefix-sum pair and emit it in closed form
+        applyDelta1Constant(out, n, start, value);
 
         return ip + (b + 7u) / 8u;
     }
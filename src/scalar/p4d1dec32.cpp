@@ -26,37 +26,19 @@ namespace
 //   bx: Patch bit width (1-31)
 //
 // Returns: Pointer to next byte after decoded data
-const unsigned char * p4D1DecPayloadExceptions(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start, unsigned b, unsigned bx)
+template <unsigned N>
+const unsigned char * p4D1DecPayloadExceptions(const unsigned char * in, unsigned n_rt, uint32_t * out, uint32_t start, unsigned b, unsigned bx)
 {
     using namespace turbopfor::scalar::detail;
 
+    // N == 0 means the length is only known at runtime; otherwise the merge
+    // and delta loops below compile with constant trip counts.
+    const unsigned n = (N != 0u) ? N : n_rt;
+
     // Phase 1: Load and parse exception bitmap
     // Bitmap has 1 bit per value indicating if it has an exception
     uint64_t bitmap[MAX_VALUES / 64]; // 4 words for 256 bits
-    const unsigned bitmap_words = (n + 63u) / 64u;
-    unsigned exception_count = 0;
-
-    for (unsigned i = 0; i < bitmap_words; ++i)
-    {
-        uint64_t word = loadU64Fast(in + i * sizeof(uint64_t));
-
-        // Mask out unused bits in the last word
-        if (i == bitmap_words - 1u && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-
-        // Count set bits (number of exceptions)
-#if defined(__GNUC__) || defined(__clang__)
-        exception_count += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        while (word)
-        {
-            ++exception_count;
-            word &= word - 1ull;
-        }
-#endif
-    }
+    unsigned exception_count = loadBitmap(in, n, bitmap);
 
     // Advance past bitmap
     const unsigned char * input_ptr = in + pad8(n);
@@ -68,44 +50,177 @@ const unsigned char * p4D1DecPayloadExceptions(const unsigned char * in, unsigne
     input_ptr = bitunpack32Scalar(input_ptr, exception_count, exception_values, bx);
     input_ptr = bitunpack32Scalar(input_ptr, n, out, b);
 
-    // Phase 3: Merge exceptions into base values
-    // For each bit set in bitmap, OR the corresponding exception value into output
-    unsigned exception_index = 0;
-    for (unsigned word_index = 0; word_index < bitmap_words; ++word_index)
+    // Phase 3: Merge exceptions and apply delta1 decoding in one pass.
+    // The delta chain is a serial prefix sum — one loop-carried add per
+    // element — so the scalar form pays n cycles of dependency no matter
+    // how cheap the merge is. Instead, vectorize the prefix sum (shift-add
+    // ladder, one vector add of carried total per 4 lanes) and splice each
+    // exception in just before the vector that consumes it. The patches
+    // are driven straight off the bitmap — one nibble per vector, ctz over
+    // its set bits — with a running cursor into exception_values, so no
+    // position list is ever materialized; the patched store reaches the
+    // following load through store-to-load forwarding.
+    //
+    // Delta1: decode differences to reconstruct original sequence
+    // Original encoding: deltas[i] = original[i] - original[i-1] - 1
+    // Decoding: original[i] = original[i-1] + deltas[i] + 1
+    unsigned k = 0;
+
+#if defined(__SSE2__)
+    const auto applyPatches4 = [&](unsigned p)
     {
-        uint64_t word = bitmap[word_index];
-        while (word)
+        unsigned nib = static_cast<unsigned>(bitmap[p >> 6u] >> (p & 63u)) & 0xFu;
+        while (nib != 0u)
         {
-            // Find position of lowest set bit
-#if defined(__GNUC__) || defined(__clang__)
-            const unsigned bit_position = static_cast<unsigned>(__builtin_ctzll(word));
+            const unsigned bit = static_cast<unsigned>(__builtin_ctz(nib));
+            out[p + bit] |= exception_values[k++] << b;
+            nib &= nib - 1u;
+        }
+    };
+
+    __m128i * op = reinterpret_cast<__m128i *>(out);
+    const __m128i ones = _mm_set1_epi32(1);
+    __m128i carry = _mm_set1_epi32(static_cast<int>(start));
+
+    const unsigned vec_count = n / 4u;
+    for (unsigned i = 0; i < vec_count; ++i)
+    {
+        applyPatches4(i * 4u);
+        __m128i v = _mm_loadu_si128(op + i);
+        v = _mm_add_epi32(v, ones);
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, carry);
+        _mm_storeu_si128(op + i, v);
+        carry = _mm_shuffle_epi32(v, 0xFF);
+    }
+
+    // Residual lanes: single-bit cursor steps, branchless as in the 64-bit
+    // decoder — the masked-off read of exception_values[exception_count]
+    // stays inside the MAX_VALUES array.
+    uint32_t acc = vec_count > 0u ? out[vec_count * 4u - 1u] : start;
+    for (unsigned i = vec_count * 4u; i < n; ++i)
+    {
+        const uint32_t has_exception = static_cast<uint32_t>(bitmap[i >> 6u] >> (i & 63u)) & 1u;
+        uint32_t v = out[i];
+        v |= (exception_values[k] << b) & (0u - has_exception);
+        k += has_exception;
+        acc += v + 1u;
+        out[i] = acc;
+    }
 #else
-            unsigned bit_position = 0;
-            while (((word >> bit_position) & 1ull) == 0ull)
-                ++bit_position;
+    for (unsigned i = 0; i < n; ++i)
+    {
+        const uint32_t has_exception = static_cast<uint32_t>(bitmap[i >> 6u] >> (i & 63u)) & 1u;
+        uint32_t v = out[i];
+        v |= (exception_values[k] << b) & (0u - has_exception);
+        k += has_exception;
+        out[i] = (start += v) + (i + 1u);
+    }
 #endif
 
-            // Calculate array index and merge exception
-            const unsigned value_index = word_index * 64u + bit_position;
-            out[value_index] |= static_cast<uint32_t>(exception_values[exception_index++] << b);
+    return input_ptr;
+}
+
+// Rare-path bodies outlined into a cold section (same scheme as the
+// dispatch_cold table in the bitunpack dispatcher): the entry below stays a
+// small header decode plus the common bitunpackd1 call, so the hot path
+// competes for icache only with itself. Both paths take runtime n — at a few
+// percent of blocks the pinned-length specializations buy nothing.
+
+// Constant block: all deltas equal, output is an arithmetic progression
+[[gnu::cold]] [[gnu::noinline]] static const unsigned char *
+p4D1Dec32Constant(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start, unsigned base_bits)
+{
+    using namespace turbopfor::scalar::detail;
+
+    const unsigned bytes_stored = (base_bits + 7u) / 8u;
+
+    // Load constant value — TurboPFor reads a full 4-byte word then
+    // masks to base_bits, like the 64-bit decoder does with 8 bytes.
+    // This is safe because TurboPFor always overallocates, and it
+    // replaces a 4-way branch on bytes_stored with one load.
+    uint32_t constant_value = loadU32Fast(in);
+    constant_value &= static_cast<uint32_t>((1ull << base_bits) - 1u);
+
+    // Constant delta collapses to an arithmetic progression — one
+    // vector add per store, no loop-carried chain
+    applyDelta1Constant(out, n, start, constant_value);
+
+    return in + bytes_stored;
+}
+
+// Variable-byte exceptions: base bits for all values, vbyte-coded exception
+// values and an explicit position list
+[[gnu::cold]] [[gnu::noinline]] static const unsigned char *
+p4D1Dec32VbyteExceptions(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start, unsigned base_bits)
+{
+    using namespace turbopfor::scalar::detail;
+
+    const unsigned char * input_ptr = in;
+    const unsigned exception_count = *input_ptr++;
+
+    // Decode base values for all elements
+    uint32_t exception_values[MAX_VALUES];
+    input_ptr = bitunpack32Scalar(input_ptr, n, out, base_bits);
+
+    // Decode exception values using variable-byte encoding
+    input_ptr = vbDec32(input_ptr, exception_count, exception_values);
 
-            // Clear the lowest set bit
-            word &= word - 1ull;
+    // Merge exceptions and apply delta1 decoding in one pass, with the
+    // prefix sum vectorized as in the bitmap path. The encoder writes the
+    // position list in ascending order, so a single cursor over it splices
+    // each exception in just before the vector that consumes it; the
+    // cursor compare short-circuits (the position list is the last field
+    // in the stream, so reading past it is not an option).
+    unsigned k = 0;
+    const auto applyPatchesBelow = [&](unsigned limit)
+    {
+        while (k < exception_count && input_ptr[k] < limit)
+        {
+            out[input_ptr[k]] |= exception_values[k] << base_bits;
+            ++k;
         }
+    };
+
+#if defined(__SSE2__)
+    __m128i * op = reinterpret_cast<__m128i *>(out);
+    const __m128i ones = _mm_set1_epi32(1);
+    __m128i carry = _mm_set1_epi32(static_cast<int>(start));
+
+    const unsigned vec_count = n / 4u;
+    for (unsigned i = 0; i < vec_count; ++i)
+    {
+        applyPatchesBelow(i * 4u + 4u);
+        __m128i v = _mm_loadu_si128(op + i);
+        v = _mm_add_epi32(v, ones);
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi32(v, carry);
+        _mm_storeu_si128(op + i, v);
+        carry = _mm_shuffle_epi32(v, 0xFF);
     }
 
-    // Phase 4: Apply delta1 decoding
-    // Delta1: decode differences to reconstruct original sequence
-    // Original encoding: deltas[i] = original[i] - original[i-1] - 1
-    // Decoding: original[i] = original[i-1] + deltas[i] + 1
+    uint32_t acc = vec_count > 0u ? out[vec_count * 4u - 1u] : start;
+    for (unsigned i = vec_count * 4u; i < n; ++i)
+    {
+        applyPatchesBelow(i + 1u);
+        acc += out[i] + 1u;
+        out[i] = acc;
+    }
+#else
     for (unsigned i = 0; i < n; ++i)
+    {
+        applyPatchesBelow(i + 1u);
         out[i] = (start += out[i]) + (i + 1u);
+    }
+#endif
+
+    input_ptr += exception_count;
 
     return input_ptr;
 }
 
-} // namespace
-
 // Main P4D1 decoding entry point (P4 decode + Delta1 decode fused)
 //
 // P4D1 combines P4 decompression with delta1 decoding for better performance.
@@ -133,8 +248,10 @@ const unsigned char * p4D1DecPayloadExceptions(const unsigned char * in, unsigne
 //   start: Initial value for delta1 decoding (previous value in sequence)
 //
 // Returns: Pointer to next byte after decoded data
-const unsigned char * p4D1Dec32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
+template <unsigned N>
+TURBOPFOR_ALWAYS_INLINE const unsigned char * p4D1Dec32Impl(const unsigned char * in, unsigned n_rt, uint32_t * out, uint32_t start)
 {
+    const unsigned n = (N != 0u) ? N : n_rt;
     if (n == 0u)
         return in;
 
@@ -161,74 +278,52 @@ const unsigned char * p4D1Dec32(const unsigned char * in, unsigned n, uint32_t *
         if (exception_bits == 0u) [[likely]]
             return bitunpackd1_32Scalar(input_ptr, n, out, start, base_bits);
 
-        return p4D1DecPayloadExceptions(input_ptr, n, out, start, base_bits, exception_bits);
+        return p4D1DecPayloadExceptions<N>(input_ptr, n, out, start, base_bits, exception_bits);
     }
 
     // Rare path: Constant block
     // Header format: [0xC0 | base_bits], then constant value bytes
     // All values in block are the same (~5-10% of blocks)
     if ((base_bits & 0xC0u) == 0xC0u) [[unlikely]]
-    {
-        base_bits &= 0x3Fu; // Extract bit width
-        const unsigned bytes_stored = (base_bits + 7u) / 8u;
-
-        // Load constant value carefully to avoid over-reading
-        // Only (base_bits + 7) / 8 bytes are stored
-        uint32_t constant_value;
-        switch (bytes_stored)
-        {
-            case 1u:
-                constant_value = input_ptr[0];
-                break;
-            case 2u:
-                constant_value = loadU16Fast(input_ptr);
-                break;
-            case 3u:
-                constant_value = loadU24(input_ptr);
-                break;
-            case 4u:
-                constant_value = loadU32Fast(input_ptr);
-                break;
-            default:
-                __builtin_unreachable();
-        }
-        constant_value &= (1ull << base_bits) - 1u;
-
-        // Fill output with constant + apply delta1
-        // This is effectively: out[i] = start + i * (constant + 1)
-        for (unsigned i = 0; i < n; ++i)
-            out[i] = (start += constant_value) + (i + 1u);
-
-        return input_ptr + bytes_stored;
-    }
+        return p4D1Dec32Constant(input_ptr, n, out, start, base_bits & 0x3Fu);
 
     // Rare path: Variable-byte exceptions
     // Header format: [0x40 | base_bits][exception_count]
     // Used when exceptions are large (~1-5% of blocks)
-    base_bits &= 0x3Fu; // Extract base bits (remove 0x40 flag)
-    const unsigned exception_count = *input_ptr++;
-
-    // Decode base values for all elements
-    uint32_t exception_values[MAX_VALUES];
-    input_ptr = bitunpack32Scalar(input_ptr, n, out, base_bits);
-
-    // Decode exception values using variable-byte encoding
-    input_ptr = vbDec32(input_ptr, exception_count, exception_values);
-
-    // Merge exceptions: position list follows exception values
-    for (unsigned i = 0; i < exception_count; ++i)
-    {
-        const unsigned position = input_ptr[i];
-        out[position] |= exception_values[i] << base_bits;
-    }
+    return p4D1Dec32VbyteExceptions(input_ptr, n, out, start, base_bits & 0x3Fu);
+}
 
-    input_ptr += exception_count;
+} // namespace
 
-    // Apply delta1 decoding
-    for (unsigned i = 0; i < n; ++i)
-        out[i] = (start += out[i]) + (i + 1u);
+// target_clones adds AVX2/AVX-512 variants picked by a load-time resolver
+// (same mechanism as the IFUNC dispatch layer), so the per-block entry jumps
+// straight into code compiled for the host tier. The out-of-line kernels
+// (bitunpackd1_32Scalar, bitunpack32Scalar, vbDec32) already dispatch through
+// their own IFUNCs; what the clones buy is the inlined SSE merge/prefix-sum
+// loops re-encoded in VEX/EVEX form, removing SSE/AVX transition stalls when
+// a caller mixes this path with AVX2+ code. A hand-fused 512-bit
+// unpack+prefix-sum tier was considered and rejected: the prefix-sum ladder
+// is latency-bound, and wider vectors lengthen the shift-add chain per
+// carried add without shortening the dependency through `carry`.
+#if defined(__ELF__) && defined(__x86_64__)
+__attribute__((target_clones("default", "avx2", "arch=x86-64-v4")))
+#endif
+const unsigned char * p4D1Dec32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
+{
+    return p4D1Dec32Impl<0u>(in, n, out, start);
+}
 
-    return input_ptr;
+template <unsigned N>
+const unsigned char * p4D1Dec32Fixed(const unsigned char * in, uint32_t * out, uint32_t start)
+{
+    static_assert(N >= 1u && N <= 256u, "P4 blocks hold at most 256 values");
+    return p4D1Dec32Impl<N>(in, N, out, start);
 }
 
+template const unsigned char * p4D1Dec32Fixed<16u>(const unsigned char *, uint32_t *, uint32_t);
+template const unsigned char * p4D1Dec32Fixed<32u>(const unsigned char *, uint32_t *, uint32_t);
+template const unsigned char * p4D1Dec32Fixed<64u>(const unsigned char *, uint32_t *, uint32_t);
+template const unsigned char * p4D1Dec32Fixed<128u>(const unsigned char *, uint32_t *, uint32_t);
+template const unsigned char * p4D1Dec32Fixed<256u>(const unsigned char *, uint32_t *, uint32_t);
+
 } // namespace turbopfor::scalar
@@ -19,30 +19,7 @@ const unsigned char * p4D1Dec64PayloadExceptions(const unsigned char * in, unsig
 
     // Phase 1: Load and parse exception bitmap
     uint64_t bitmap[MAX_VALUES / 64]; // 4 words for 256 bits
-    const unsigned bitmap_words = (n + 63u) / 64u;
-    unsigned exception_count = 0;
-
-    for (unsigned i = 0; i < bitmap_words; ++i)
-    {
-        uint64_t word = loadU64Fast(in + i * sizeof(uint64_t));
-
-        // Mask out unused bits in the last word
-        if (i == bitmap_words - 1u && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-
-        // Count set bits (number of exceptions)
-#if defined(__GNUC__) || defined(__clang__)
-        exception_count += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        while (word)
-        {
-            ++exception_count;
-            word &= word - 1ull;
-        }
-#endif
-    }
+    unsigned exception_count = loadBitmap(in, n, bitmap);
 
     // Advance past bitmap
     const unsigned char * input_ptr = in + pad8(n);
@@ -52,35 +29,25 @@ const unsigned char * p4D1Dec64PayloadExceptions(const unsigned char * in, unsig
     input_ptr = bitunpack64Scalar(input_ptr, exception_count, exception_values, bx);
     input_ptr = bitunpack64Scalar(input_ptr, n, out, b);
 
-    // Phase 3: Merge exceptions into base values
-    unsigned exception_index = 0;
-    for (unsigned word_index = 0; word_index < bitmap_words; ++word_index)
-    {
-        uint64_t word = bitmap[word_index];
-        while (word)
-        {
-#if defined(__GNUC__) || defined(__clang__)
-            const unsigned bit_position = static_cast<unsigned>(__builtin_ctzll(word));
-#else
-            unsigned bit_position = 0;
-            while (((word >> bit_position) & 1ull) == 0ull)
-                ++bit_position;
-#endif
-
-            const unsigned value_index = word_index * 64u + bit_position;
-            out[value_index] |= exception_values[exception_index++] << b;
-
-            // Clear the lowest set bit
-            word &= word - 1ull;
-        }
-    }
-
-    // Phase 4: Apply delta1 decoding
+    // Phase 3: Merge exceptions and apply delta1 decoding in one pass
+    // Exceptions appear in bitmap (= position) order, so the merge rides
+    // along the sequential delta chain instead of making its own pass over
+    // out[] — one read-modify-write per element instead of two, branchless
+    // (masked OR plus bit-valued index bump). The masked-off read of
+    // exception_values[exception_count] stays inside the MAX_VALUES array.
+    //
     // Delta1: decode differences to reconstruct original sequence
     // Original encoding: deltas[i] = original[i] - original[i-1] - 1
     // Decoding: original[i] = original[i-1] + deltas[i] + 1
+    unsigned exception_index = 0;
     for (unsigned i = 0; i < n; ++i)
-        out[i] = (start += out[i]) + (i + 1u);
+    {
+        const uint64_t has_exception = (bitmap[i >> 6u] >> (i & 63u)) & 1ull;
+        uint64_t v = out[i];
+        v |= (exception_values[exception_index] << b) & (0ull - has_exception);
+        exception_index += static_cast<unsigned>(has_exception);
+        out[i] = (start += v) + (i + 1u);
+    }
 
     return input_ptr;
 }
@@ -152,9 +119,9 @@ const unsigned char * p4D1Dec64(const unsigned char * in, unsigned n, uint64_t *
         if (base_bits < 64u)
             constant_value &= (1ull << base_bits) - 1ull;
 
-        // Fill output with constant + apply delta1
-        for (unsigned i = 0; i < n; ++i)
-            out[i] = (start += constant_value) + (i + 1u);
+        // Constant delta collapses to an arithmetic progression — one
+        // vector add per store, no loop-carried chain
+        applyDelta1Constant64(out, n, start, constant_value);
 
         return input_ptr + bytes_stored;
     }
@@ -176,19 +143,23 @@ const unsigned char * p4D1Dec64(const unsigned char * in, unsigned n, uint64_t *
     // Decode exception values using 64-bit variable-byte encoding
     input_ptr = vbDec64(input_ptr, exception_count, exception_values);
 
-    // Merge exceptions: position list follows exception values
-    for (unsigned i = 0; i < exception_count; ++i)
+    // Merge exceptions and apply delta1 decoding in one pass. The position
+    // list is ascending, so the merge rides the sequential delta chain like
+    // the bitmap path — one read-modify-write per element instead of two.
+    // The cursor compare short-circuits rather than using a masked read:
+    // the position list is the last field in the stream, so reading one
+    // byte past it is not an option.
+    unsigned exception_index = 0;
+    for (unsigned i = 0; i < n; ++i)
     {
-        const unsigned position = input_ptr[i];
-        out[position] |= exception_values[i] << base_bits;
+        uint64_t v = out[i];
+        if (exception_index < exception_count && input_ptr[exception_index] == i)
+            v |= exception_values[exception_index++] << base_bits;
+        out[i] = (start += v) + (i + 1u);
     }
 
     input_ptr += exception_count;
 
-    // Apply delta1 decoding
-    for (unsigned i = 0; i < n; ++i)
-        out[i] = (start += out[i]) + (i + 1u);
-
     return input_ptr;
 }
 
@@ -14,53 +14,16 @@ const unsigned char * p4Dec256PayloadBitmap(
 
     uint64_t bitmap[MAX_VALUES / 64] = {0};
     const unsigned words = (n + 63u) / 64u;
-    unsigned exception_count = 0;
-
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = loadU64Fast(in + i * sizeof(uint64_t));
-
-        if (i == words - 1u && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-
-#if defined(__GNUC__) || defined(__clang__)
-        exception_count += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        while (word)
-        {
-            ++exception_count;
-            word &= word - 1ull;
-        }
-#endif
-    }
+    unsigned exception_count = loadBitmap(in, n, bitmap);
 
     const unsigned char * ip = in + pad8(n);
 
-    uint32_t exceptions[MAX_VALUES + 64];
-    ip = bitunpack32Scalar(ip, exception_count, exceptions, bx);
+    const unsigned char * ex_ptr = ip;
+    ip += pad8(exception_count * bx);
 
     ip = bitunpack256v32Scalar(ip, out, b);
 
-    unsigned k = 0;
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = bitmap[i];
-        while (word)
-        {
-#if defined(__GNUC__) || defined(__clang__)
-            unsigned bit = static_cast<unsigned>(__builtin_ctzll(word));
-#else
-            unsigned bit = 0;
-            while (((word >> bit) & 1ull) == 0ull)
-                ++bit;
-#endif
-            const unsigned idx = i * 64u + bit;
-            out[idx] |= static_cast<uint32_t>(exceptions[k++] << b);
-            word &= word - 1ull;
-        }
-    }
+    bitunpackPatch32(ex_ptr, exception_count, out, b, bx, bitmap, words);
 
     return ip;
 }
@@ -13,54 +13,15 @@ const unsigned char * p4DecPayloadExceptions(const unsigned char * in, unsigned
 
     uint64_t bitmap[MAX_VALUES / 64];
     const unsigned bitmap_words = (n + 63u) / 64u;
-    unsigned exception_count = 0;
-
-    for (unsigned i = 0; i < bitmap_words; ++i)
-    {
-        uint64_t word = loadU64Fast(in + i * sizeof(uint64_t));
-
-        if (i == bitmap_words - 1u && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-
-#if defined(__GNUC__) || defined(__clang__)
-        exception_count += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        while (word)
-        {
-            ++exception_count;
-            word &= word - 1ull;
-        }
-#endif
-    }
+    unsigned exception_count = loadBitmap(in, n, bitmap);
 
     const unsigned char * input_ptr = in + pad8(n);
 
-    uint32_t exception_values[MAX_VALUES];
-    input_ptr = bitunpack32Scalar(input_ptr, exception_count, exception_values, bx);
+    const unsigned char * ex_ptr = input_ptr;
+    input_ptr += pad8(exception_count * bx);
     input_ptr = bitunpack32Scalar(input_ptr, n, out, b);
 
-    unsigned exception_index = 0;
-    for (unsigned word_index = 0; word_index < bitmap_words; ++word_index)
-    {
-        uint64_t word = bitmap[word_index];
-        while (word)
-        {
-#if defined(__GNUC__) || defined(__clang__)
-            const unsigned bit_position = static_cast<unsigned>(__builtin_ctzll(word));
-#else
-            unsigned bit_position = 0;
-            while (((word >> bit_position) & 1ull) == 0ull)
-                ++bit_position;
-#endif
-
-            const unsigned value_index = word_index * 64u + bit_position;
-            out[value_index] |= static_cast<uint32_t>(exception_values[exception_index++] << b);
-
-            word &= word - 1ull;
-        }
-    }
+    bitunpackPatch32(ex_ptr, exception_count, out, b, bx, bitmap, bitmap_words);
 
     return input_ptr;
 }
@@ -96,28 +57,23 @@ const unsigned char * p4Dec32(const unsigned char * in, unsigned n, uint32_t * o
         base_bits &= 0x3Fu;
         const unsigned bytes_stored = (base_bits + 7u) / 8u;
 
-        uint32_t constant_value;
-        switch (bytes_stored)
-        {
-            case 1u:
-                constant_value = input_ptr[0];
-                break;
-            case 2u:
-                constant_value = loadU16Fast(input_ptr);
-                break;
-            case 3u:
-                constant_value = loadU24(input_ptr);
-                break;
-            case 4u:
-                constant_value = loadU32Fast(input_ptr);
-                break;
-            default:
-                __builtin_unreachable();
-        }
-        constant_value &= (1ull << base_bits) - 1u;
-
+        // Full 4-byte load then mask, like the 64-bit decoder — safe
+        // because TurboPFor always overallocates, and branchless
+        uint32_t constant_value = loadU32Fast(input_ptr);
+        constant_value &= static_cast<uint32_t>((1ull << base_bits) - 1u);
+
+        // Vector fill: store throughput instead of one 4-byte store per value
+#if defined(__SSE2__)
+        const __m128i vv = _mm_set1_epi32(static_cast<int>(constant_value));
+        unsigned i = 0;
+        for (; i + 4u <= n; i += 4u)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), vv);
+        for (; i < n; ++i)
+            out[i] = constant_value;
+#else
         for (unsigned i = 0; i < n; ++i)
             out[i] = constant_value;
+#endif
 
         return input_ptr + bytes_stored;
     }
@@ -13,27 +13,7 @@ const unsigned char * p4Dec64PayloadExceptions(const unsigned char * in, unsigne
 
     uint64_t bitmap[MAX_VALUES / 64];
     const unsigned bitmap_words = (n + 63u) / 64u;
-    unsigned exception_count = 0;
-
-    for (unsigned i = 0; i < bitmap_words; ++i)
-    {
-        uint64_t word = loadU64Fast(in + i * sizeof(uint64_t));
-
-        if (i == bitmap_words - 1u && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-
-#if defined(__GNUC__) || defined(__clang__)
-        exception_count += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        while (word)
-        {
-            ++exception_count;
-            word &= word - 1ull;
-        }
-#endif
-    }
+    unsigned exception_count = loadBitmap(in, n, bitmap);
 
     const unsigned char * input_ptr = in + pad8(n);
 
@@ -41,26 +21,7 @@ const unsigned char * p4Dec64PayloadExceptions(const unsigned char * in, unsigne
     input_ptr = bitunpack64Scalar(input_ptr, exception_count, exception_values, bx);
     input_ptr = bitunpack64Scalar(input_ptr, n, out, b);
 
-    unsigned exception_index = 0;
-    for (unsigned word_index = 0; word_index < bitmap_words; ++word_index)
-    {
-        uint64_t word = bitmap[word_index];
-        while (word)
-        {
-#if defined(__GNUC__) || defined(__clang__)
-            const unsigned bit_position = static_cast<unsigned>(__builtin_ctzll(word));
-#else
-            unsigned bit_position = 0;
-            while (((word >> bit_position) & 1ull) == 0ull)
-                ++bit_position;
-#endif
-
-            const unsigned value_index = word_index * 64u + bit_position;
-            out[value_index] |= exception_values[exception_index++] << b;
-
-            word &= word - 1ull;
-        }
-    }
+    patchExceptions(out, bitmap, bitmap_words, exception_values, b, exception_count);
 
     return input_ptr;
 }
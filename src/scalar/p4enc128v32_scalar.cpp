@@ -41,61 +41,58 @@ namespace
 //
 // Parameters:
 //   in: Input array of n values (n <= 128, typically 128)
-//   n: Number of values
+//   n_rt: Number of values
 //   out: Output buffer
 //   b: Base bit width (bits per value for base data)
 //   bx: Exception strategy indicator
 //
+// The block length is a template parameter following the p4Bits32Impl
+// pattern: N == 0 compiles the runtime-length version, N == 128 pins the
+// whole-block size so words, pad8(n) and the partial-block memset all
+// constant-fold.
+//
 // Returns: Pointer to end of encoded data
-unsigned char * p4Enc128v32PayloadExceptions(uint32_t * in, unsigned n, unsigned char * out, unsigned b, unsigned bx)
+template <unsigned N>
+unsigned char * p4Enc128v32PayloadExceptions(uint32_t * in, unsigned n_rt, unsigned char * out, unsigned b, unsigned bx)
 {
     using namespace turbopfor::scalar::detail;
 
-    // Create mask for extracting base bits (low b bits of each value)
-    const uint64_t base_mask = (b >= 32u) ? 0xFFFFFFFFull : ((1ull << b) - 1ull);
-
-    // Temporary arrays for exception handling
-    // base[]: stores low b bits of each value (to be bitpacked)
-    // exceptions[]: stores high bits of exception values (bits above b)
-    // exception_positions[]: stores indices of values that exceed b bits
-    uint32_t base[MAX_VALUES + 32] = {0}; // Extra padding for SIMD safety
-    uint32_t exceptions[MAX_VALUES + 32];
-    uint64_t bitmap[MAX_VALUES / 64] = {0}; // 1 bit per value: 1 = has exception
-    unsigned exception_positions[MAX_VALUES] = {0};
-
-    // Phase 1: Scan input and separate base values from exceptions
-    //
-    // For each value:
-    // - Extract low b bits as base value
-    // - If value > base_mask, it's an exception: record position and high bits
-    unsigned exception_count = 0;
-    for (unsigned i = 0; i < n; ++i)
-    {
-        // Record position first (branchless technique from TurboPFor)
-        // This avoids branch misprediction by always writing position,
-        // but only incrementing count when it's actually an exception
-        exception_positions[exception_count] = i;
-        exception_count += (in[i] > base_mask) ? 1u : 0u;
-
-        // Store base value (low b bits) - always needed
-        base[i] = static_cast<uint32_t>(in[i] & base_mask);
-    }
+    const unsigned n = (N != 0u) ? N : n_rt;
 
-    // Phase 2: Build exception data structures
-    //
-    // For bitwise patching, we need:
-    // - bitmap: marks which positions have exceptions
-    // - exceptions[]: the high bits (value >> b) for each exception
-    for (unsigned i = 0; i < exception_count; ++i)
+    // Create mask for extracting base bits (low b bits of each value)
+    const uint32_t base_mask = maskBits(b);
+
+    // Scratch for the block split, one 64-byte-aligned allocation so the
+    // split's stores and the packers' reads walk sequential cache lines
+    // instead of whatever the frame layout happened to be. No array carries
+    // zero-init: the scan writes base[0..n) and nothing past
+    // exceptions[0..count) is ever read — zeroing 1 KB of stack per call
+    // was pure overhead. bitmap accumulates with |=, so only it starts
+    // cleared. The old per-array +32 SIMD padding is gone: the scan kernel
+    // stores base in whole vectors only below n and compress-stores exactly
+    // the exception count.
+    alignas(64) struct
     {
-        const unsigned pos = exception_positions[i];
-
-        // Set bit in bitmap at exception position
-        bitmap[pos >> 6] |= 1ull << (pos & 0x3Fu);
-
-        // Store exception value (high bits above b)
-        exceptions[i] = static_cast<uint32_t>(in[pos] >> b);
-    }
+        uint32_t base[MAX_VALUES]; // Base values (low b bits)
+        uint32_t exceptions[MAX_VALUES]; // Exception values (high bits)
+        uint64_t bitmap[MAX_VALUES / 64]; // 1 bit per value: 1 = has exception
+    } scratch;
+    uint32_t * const base = scratch.base;
+    uint32_t * const exceptions = scratch.exceptions;
+    uint64_t * const bitmap = scratch.bitmap;
+    std::memset(bitmap, 0, sizeof(scratch.bitmap));
+
+    // Partial blocks: bitpack128v32Scalar always packs a full 128-value
+    // block, so the slots past n must still read as zero.
+    if (n < 128u)
+        std::memset(base + n, 0, (128u - n) * sizeof(uint32_t));
+
+    const unsigned words = (n + 63u) / 64u;
+
+    // Phases 1+2 in one kernel: mask the base values out, build the
+    // exception bitmap from the compare masks and pack the high bits
+    // (value >> b) into exceptions[] in position order
+    const unsigned exception_count = scanExceptions32(in, n, base_mask, b, base, bitmap, exceptions);
 
     // Phase 3: Encode based on exception strategy
     if (bx <= MAX_BITS)
@@ -108,12 +105,11 @@ unsigned char * p4Enc128v32PayloadExceptions(uint32_t * in, unsigned n, unsigned
         // patch bits: exception_count values, each bx bits (horizontal bitpacking)
         // base bits: n values using 128v32 vertical bitpacking
 
-        // Write exception bitmap
-        const unsigned bitmap_words = (n + 63u) / 64u;
-        for (unsigned i = 0; i < bitmap_words; ++i)
-        {
-            storeU64Fast(out + i * sizeof(uint64_t), bitmap[i]);
-        }
+        // Write exception bitmap: always both words (one 16-byte store,
+        // matching the SIMD twin) — partial blocks advance by pad8(n) and
+        // the patch bits written next overwrite any overshoot, the same
+        // slack storeU64Fast relied on
+        std::memcpy(out, bitmap, 16); // 128 bits = 16 bytes
 
         out += pad8(n); // Advance by bitmap size (padded to bytes)
 
@@ -144,9 +140,13 @@ unsigned char * p4Enc128v32PayloadExceptions(uint32_t * in, unsigned n, unsigned
     // Write exception values using variable-byte encoding
     out = vbEnc32(exceptions, exception_count, out);
 
-    // Write exception positions (1 byte each, since n <= 256)
-    for (unsigned i = 0; i < exception_count; ++i)
-        *out++ = static_cast<unsigned char>(exception_positions[i]);
+    // Write exception positions (1 byte each, since n <= 256): recover the
+    // ascending position list from the bitmap straight into the stream —
+    // only this strategy needs it. The expansion's 8-byte stores may run a
+    // few bytes past the list; the stream write slack covers that, as it
+    // does for the bitmap words.
+    expandBitmapIndices(bitmap, words, out);
+    out += exception_count;
 
     return out;
 }
@@ -168,6 +168,7 @@ unsigned char * p4Enc128v32PayloadExceptions(uint32_t * in, unsigned n, unsigned
 //   bx: Exception strategy
 //
 // Returns: Pointer to end of encoded data
+template <unsigned N>
 unsigned char * p4Enc128v32Payload(uint32_t * in, unsigned n, unsigned char * out, unsigned b, unsigned bx)
 {
     using namespace turbopfor::scalar::detail;
@@ -191,7 +192,7 @@ unsigned char * p4Enc128v32Payload(uint32_t * in, unsigned n, unsigned char * ou
     }
 
     // Case 3: Exception handling required
-    return p4Enc128v32PayloadExceptions(in, n, out, b, bx);
+    return p4Enc128v32PayloadExceptions<N>(in, n, out, b, bx);
 }
 
 } // namespace
@@ -228,17 +229,23 @@ unsigned char * p4Enc128v32(uint32_t * in, unsigned n, unsigned char * out)
     unsigned bx = 0;
     unsigned b;
 
-    // Use optimized version for full 128-element blocks
+    // Full 128-element blocks are the hot path: use the whole-block
+    // analyzer and the payload instantiation with the length pinned, so
+    // bitmap words and padding constant-fold
     if (n == 128u)
+    {
         b = p4Bits128(in, &bx);
-    else
-        b = p4Bits32(in, n, &bx);
+        writeHeader(out, b, bx);
+        return p4Enc128v32Payload<128u>(in, n, out, b, bx);
+    }
+
+    b = p4Bits32(in, n, &bx);
 
     // Write P4 header (1-2 bytes encoding b and bx)
     writeHeader(out, b, bx);
 
     // Write payload using determined strategy
-    return p4Enc128v32Payload(in, n, out, b, bx);
+    return p4Enc128v32Payload<0u>(in, n, out, b, bx);
 }
 
 } // namespace turbopfor::scalar
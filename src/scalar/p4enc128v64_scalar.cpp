@@ -58,32 +58,15 @@ unsigned char * p4Enc128v64PayloadExceptions(uint64_t * in, unsigned n, unsigned
     // Temporary arrays for exception handling
     uint64_t base[MAX_VALUES]; // Base values (low b bits)
     uint64_t exceptions[MAX_VALUES]; // Exception values (high bits)
-    unsigned exception_positions[MAX_VALUES]; // Indices of exception values
+    uint64_t bitmap[MAX_VALUES / 64] = {0}; // 1 bit per value: 1 = has exception
 
-    // Phase 1: Split values into base and exceptions
-    //
-    // For each value:
-    // - Extract low b bits as base value
-    // - If value > base_mask, it's an exception: record position and high bits
-    //
-    // Uses branchless technique from TurboPFor to avoid branch misprediction:
-    // always write position, only increment count when it's an exception.
-    unsigned exception_count = 0;
-    for (unsigned i = 0; i < n; ++i)
-    {
-        exception_positions[exception_count] = i;
-        exception_count += (in[i] > base_mask) ? 1u : 0u;
-        base[i] = in[i] & base_mask;
-    }
+    const unsigned words = (n + 63u) / 64u;
 
-    // Phase 2: Build exception data
-    uint64_t bitmap[MAX_VALUES / 64] = {0}; // 1 bit per value: 1 = has exception
-    for (unsigned i = 0; i < exception_count; ++i)
-    {
-        const unsigned pos = exception_positions[i];
-        bitmap[pos >> 6] |= 1ull << (pos & 0x3Fu);
-        exceptions[i] = in[pos] >> b;
-    }
+    // Phases 1+2 in one kernel: mask the base values out, build the
+    // exception bitmap from the compare masks and pack the high bits
+    // (value >> b) into exceptions[] in position order — the count stays in
+    // a register and no position list is materialized here.
+    const unsigned exception_count = scanExceptions64(in, n, base_mask, b, base, bitmap, exceptions);
 
     // Phase 3: Encode based on exception strategy
     if (bx <= MAX_BITS_64)
@@ -96,12 +79,10 @@ unsigned char * p4Enc128v64PayloadExceptions(uint64_t * in, unsigned n, unsigned
         // patch bits: exception_count values packed with bitpack64 (scalar horizontal)
         // base bits: n values packed with bitpack128v64 (hybrid format)
 
-        // Write exception bitmap
-        const unsigned bitmap_words = (n + 63u) / 64u;
-        for (unsigned i = 0; i < bitmap_words; ++i)
-        {
-            storeU64Fast(out + i * sizeof(uint64_t), bitmap[i]);
-        }
+        // Write exception bitmap: always both words (one 16-byte store) —
+        // partial blocks advance by pad8(n) and the patch bits written next
+        // overwrite any overshoot, the same slack storeU64Fast relied on
+        std::memcpy(out, bitmap, 16); // 128 bits = 16 bytes
 
         out += pad8(n); // Advance by bitmap size (padded to bytes)
 
@@ -132,9 +113,13 @@ unsigned char * p4Enc128v64PayloadExceptions(uint64_t * in, unsigned n, unsigned
     // Write exception values using 64-bit variable-byte encoding
     out = vbEnc64(exceptions, exception_count, out);
 
-    // Write exception positions (1 byte each, since n <= 128)
-    for (unsigned i = 0; i < exception_count; ++i)
-        *out++ = static_cast<unsigned char>(exception_positions[i]);
+    // Write exception positions (1 byte each, since n <= 128): recover the
+    // ascending position list from the bitmap straight into the stream —
+    // only this strategy needs it. The expansion's 8-byte stores may run a
+    // few bytes past the list; the stream write slack covers that, as it
+    // does for the bitmap words.
+    expandBitmapIndices(bitmap, words, out);
+    out += exception_count;
 
     return out;
 }
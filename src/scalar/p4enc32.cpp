@@ -16,70 +16,54 @@ namespace
 //    - Bitwise patching (bx < 32): bitmap + patch bits
 //    - Variable-byte (bx == 33): vbyte encoded exceptions + position list
 //
+// Template parameters:
+//   B: Base bit width (1-31)
+//   BX: Exception strategy:
+//       1-31: bitwise patching with patch_bits = BX
+//       33: variable-byte exception encoding
+//
 // Parameters:
 //   in: Input array of n values
 //   n: Number of values (max 256)
 //   out: Output buffer
-//   b: Base bit width (1-31)
-//   bx: Exception strategy:
-//       0: no exceptions
-//       1-31: bitwise patching with patch_bits = bx
-//       33: variable-byte exception encoding
 //
 // Returns: Pointer to end of encoded data
-unsigned char * p4Enc32PayloadExceptions(uint32_t * in, unsigned n, unsigned char * out, unsigned b, unsigned bx)
+template <unsigned B, unsigned BX>
+unsigned char * p4Enc32PayloadExceptions(uint32_t * in, unsigned n, unsigned char * out)
 {
     using namespace turbopfor::scalar::detail;
 
-    // Create mask for extracting base bits (low b bits)
-    const uint32_t base_mask = (1u << b) - 1u;
+    // Create mask for extracting base bits (low B bits)
+    constexpr uint32_t base_mask = maskBits(B);
 
-    // Temporary arrays for splitting values into base and exceptions
-    uint32_t base[MAX_VALUES]; // Base values (low b bits)
-    uint32_t exceptions[MAX_VALUES]; // Exception values (high bits)
-    uint32_t exception_positions[MAX_VALUES]; // Positions of exception values
+    // Temporary arrays for splitting values into base and exceptions, aligned
+    // to cache lines so the vector kernels' loads and stores never straddle
+    // one (16 u32s per line; 1 KB each, cheap on the stack).
+    alignas(64) uint32_t base[MAX_VALUES]; // Base values (low b bits)
+    alignas(64) uint32_t exceptions[MAX_VALUES]; // Exception values (high bits)
+    alignas(64) uint64_t bitmap[MAX_VALUES / 64] = {0}; // 1 bit per value: 1 = has exception
 
-    // Phase 1: Split values into base and exceptions
-    // Use unsigned for loop counter to avoid movzbl instructions
-    unsigned exception_count = 0;
-    for (unsigned i = 0; i < n; ++i)
-    {
-        const uint32_t value = in[i];
-        base[i] = static_cast<uint32_t>(value & base_mask);
+    const unsigned words = (n + 63u) / 64u;
 
-        // Check if this value needs more than b bits (is an exception)
-        if (value > base_mask)
-        {
-            exception_positions[exception_count] = i;
-            exceptions[exception_count] = value >> b; // Store high bits
-            ++exception_count;
-        }
-    }
+    // Phases 1+2 in one kernel: mask the base values out, build the
+    // exception bitmap from the compare masks and pack the high bits
+    // (value >> b) into exceptions[] in position order — the count stays in
+    // a register and no position list is materialized here.
+    const unsigned exception_count = scanExceptions32(in, n, base_mask, B, base, bitmap, exceptions);
 
-    // Phase 2: Encode exceptions based on strategy
+    // Phase 3: Encode exceptions based on strategy
 
-    if (bx <= MAX_BITS)
+    if constexpr (BX <= MAX_BITS)
     {
         // Strategy: Bitwise patching
         // Format: [bitmap][patch bits][base bits]
         //
         // Bitmap: 1 bit per value indicating if it has an exception
-        // Patch bits: bx bits per exception value
-        // Base bits: b bits per value
-
-        // Build exception bitmap (1 bit = has exception, 0 bit = no exception)
-        uint64_t bitmap[MAX_VALUES / 64]; // 4 uint64_t for 256 bits
-        std::memset(bitmap, 0, sizeof(bitmap));
-
-        for (unsigned i = 0; i < exception_count; ++i)
-        {
-            const unsigned pos = exception_positions[i];
-            bitmap[pos >> 6] |= 1ull << (pos & 0x3Fu); // Set bit at position
-        }
+        // Patch bits: BX bits per exception value
+        // Base bits: B bits per value
 
         // Write bitmap (pad to byte boundary)
-        const unsigned bitmap_words = (n + 63u) / 64u;
-        for (unsigned i = 0; i < bitmap_words; ++i)
+        for (unsigned i = 0; i < words; ++i)
         {
             storeU64Fast(out + i * sizeof(uint64_t), bitmap[i]);
         }
@@ -87,99 +71,115 @@ unsigned char * p4Enc32PayloadExceptions(uint32_t * in, unsigned n, unsigned cha
         out += pad8(n); // Advance by bitmap size in bytes
 
         // Write patch bits for exceptions
-        out = bitpack32Scalar(exceptions, exception_count, out, bx);
+        out = bitpack32Scalar(exceptions, exception_count, out, BX);
 
         // Write base bits for all values
-        out = bitpack32Scalar(base, n, out, b);
+        out = bitpack32Scalar(base, n, out, B);
 
         return out;
     }
+    else
+    {
+        // Strategy: Variable-byte exception encoding
+        // Format: [exception_count][base bits][vbyte exceptions][position list]
+        //
+        // exception_count: 1 byte, number of exceptions
+        // base bits: B bits per value
+        // vbyte exceptions: variable-byte encoded exception values
+        // position list: 1 byte per exception indicating its position
 
-    // Strategy: Variable-byte exception encoding
-    // Format: [exception_count][base bits][vbyte exceptions][position list]
-    //
-    // exception_count: 1 byte, number of exceptions
-    // base bits: b bits per value
-    // vbyte exceptions: variable-byte encoded exception values
-    // position list: 1 byte per exception indicating its position
-
-    *out++ = static_cast<unsigned char>(exception_count);
+        *out++ = static_cast<unsigned char>(exception_count);
 
-    // Write base bits for all values
-    out = bitpack32Scalar(base, n, out, b);
+        // Write base bits for all values
+        out = bitpack32Scalar(base, n, out, B);
 
-    // Write exception values using variable-byte encoding
-    out = vbEnc32(exceptions, exception_count, out);
+        // Write exception values using variable-byte encoding
+        out = vbEnc32(exceptions, exception_count, out);
 
-    // Write exception positions
-    for (unsigned i = 0; i < exception_count; ++i)
-        *out++ = exception_positions[i];
+        // Write exception positions (1 byte each, since n <= 256): recover the
+        // ascending position list from the bitmap straight into the stream —
+        // only this strategy needs it. The expansion's 8-byte stores may run
+        // a few bytes past the list; the stream write slack covers that, as
+        // it does for the bitmap words.
+        expandBitmapIndices(bitmap, words, out);
+        out += exception_count;
 
-    return out;
+        return out;
+    }
 }
 
 // Encode P4 block payload (data after header)
 //
-// Handles different encoding strategies based on bx value:
-// - b=0: All zeros, no data needed
-// - bx=0: Simple bitpacking, no exceptions
-// - bx=1-31: Bitwise patching (patch_bits = bx)
-// - bx=33: Variable-byte exception encoding
-// - bx=34: Constant block (all values equal)
-// Note: bx=32 is reserved/unused (separates patching from special encodings)
+// Handles different encoding strategies based on the BX template parameter:
+// - B=0: All zeros, no data needed
+// - BX=0: Simple bitpacking, no exceptions
+// - BX=1-31: Bitwise patching (patch_bits = BX)
+// - BX=33: Variable-byte exception encoding
+// - BX=34: Constant block (all values equal)
+// Note: BX=32 is reserved/unused (separates patching from special encodings)
 //
 // Parameters:
 //   in: Input array
 //   n: Number of values
 //   out: Output buffer
-//   b: Base bit width
-//   bx: Exception strategy (see p4Bits32 for encoding)
 //
 // Returns: Pointer to end of encoded data
-unsigned char * p4Enc32Payload(uint32_t * in, unsigned n, unsigned char * out, unsigned b, unsigned bx)
+template <unsigned B, unsigned BX>
+unsigned char * p4Enc32Payload(uint32_t * in, unsigned n, unsigned char * out)
 {
     using namespace turbopfor::scalar::detail;
 
     // Special case 1: All zeros
     // No data needed, header alone indicates all zeros
-    if (b == 0u && bx == 0u)
+    if constexpr (B == 0u && BX == 0u)
         return out;
 
     // Special case 2: Simple bitpacking (no exceptions)
-    // All values fit in b bits, just pack them
-    if (bx == 0u)
-        return bitpack32Scalar(in, n, out, b);
+    // All values fit in B bits, just pack them
+    else if constexpr (BX == 0u)
+        return bitpack32Scalar(in, n, out, B);
 
     // Special case 2: Constant block (all values equal, non-zero)
-    // bx = 34 (MAX_BITS + 2) indicates constant block
+    // BX = 34 (MAX_BITS + 2) indicates constant block
     // Format: Just store the constant value once
-    if (bx == MAX_BITS + 2u)
+    else if constexpr (BX == MAX_BITS + 2u)
     {
-        if (b == 32u) [[unlikely]]
-        {
-            storeU32Fast(out, in[0]);
-            return out + 4;
-        }
-
-        // Advance by bytes needed for b bits
-        // Store only the bytes needed for b bits (avoids garbage writes)
-        // Mask the value to b bits to ensure clean encoding
-        const uint32_t masked_value = in[0] & ((1u << b) - 1u);
-        const uint32_t bytes_needed = (b + 7u) / 8u;
-
-        // Write bytes in little-endian order (lowest byte first)
-        for (unsigned i = 0; i < bytes_needed; ++i)
-        {
-            out[i] = static_cast<unsigned char>(masked_value >> (i * 8u));
-        }
-        return out + bytes_needed;
+        // One full 4-byte store, advancing only by the bytes B needs: the
+        // next block's write overwrites the trailing bytes, and the decoder
+        // already reads this field with a 4-byte loadU32Fast, so the stream
+        // contract includes that much slack anyway. Masking to B bits keeps
+        // the stored prefix clean; B = 32 folds in via maskBits.
+        storeU32Fast(out, in[0] & maskBits(B));
+        return out + (B + 7u) / 8u;
     }
 
     // General case: Exception handling (bitwise patching or variable-byte)
-    return p4Enc32PayloadExceptions(in, n, out, b, bx);
+    else
+        return p4Enc32PayloadExceptions<B, BX>(in, n, out);
 }
 
-} // namespace
+using P4Enc32PayloadFn = unsigned char * (*)(uint32_t *, unsigned, unsigned char *);
+
+// Constexpr dispatch table over the (b, bx) specializations, generated from
+// index sequences so the rows can never drift out of step with the header
+// encoding (b in [0, 32], bx in [0, 34]). Each entry is the payload with the
+// whole strategy ladder, the base mask and both pack widths folded; bulk
+// ingestion tends to repeat one (b, bx), so the indirect target stays
+// predicted.
+template <std::size_t B, std::size_t... BXs>
+static constexpr std::array<P4Enc32PayloadFn, sizeof...(BXs)> makeP4Enc32PayloadRow(std::index_sequence<BXs...>)
+{
+    return {&p4Enc32Payload<static_cast<unsigned>(B), static_cast<unsigned>(BXs)>...};
+}
+
+template <std::size_t... Bs>
+static constexpr auto makeP4Enc32PayloadTable(std::index_sequence<Bs...>)
+{
+    return std::array{makeP4Enc32PayloadRow<Bs>(std::make_index_sequence<detail::MAX_BITS + 3u>{})...};
+}
+
+static constexpr auto p4enc32_payload_table = makeP4Enc32PayloadTable(std::make_index_sequence<detail::MAX_BITS + 1u>{});
+
 
 // Main P4 encoding entry point for 32-bit integer arrays
 //
@@ -198,8 +198,10 @@ unsigned char * p4Enc32Payload(uint32_t * in, unsigned n, unsigned char * out, u
 //   out: Output buffer (must have enough space)
 //
 // Returns: Pointer to end of encoded data
-unsigned char * p4Enc32(uint32_t * in, unsigned n, unsigned char * out)
+template <unsigned N>
+TURBOPFOR_ALWAYS_INLINE unsigned char * p4Enc32Impl(uint32_t * in, unsigned n_rt, unsigned char * out)
 {
+    const unsigned n = (N != 0u) ? N : n_rt;
     if (n == 0u)
         return out;
 
@@ -212,8 +214,28 @@ unsigned char * p4Enc32(uint32_t * in, unsigned n, unsigned char * out)
     // Write encoding header (1-2 bytes)
     writeHeader(out, base_bits, exception_bits);
 
-    // Write payload (compressed data)
-    return p4Enc32Payload(in, n, out, base_bits, exception_bits);
+    // Write payload (compressed data) through the (b, bx) specialization
+    return p4enc32_payload_table[base_bits][exception_bits](in, n, out);
 }
 
+} // namespace
+
+unsigned char * p4Enc32(uint32_t * in, unsigned n, unsigned char * out)
+{
+    return p4Enc32Impl<0u>(in, n, out);
+}
+
+template <unsigned N>
+unsigned char * p4Enc32Fixed(uint32_t * in, unsigned char * out)
+{
+    static_assert(N >= 1u && N <= 256u, "P4 blocks hold at most 256 values");
+    return p4Enc32Impl<N>(in, N, out);
+}
+
+template unsigned char * p4Enc32Fixed<16u>(uint32_t *, unsigned char *);
+template unsigned char * p4Enc32Fixed<32u>(uint32_t *, unsigned char *);
+template unsigned char * p4Enc32Fixed<64u>(uint32_t *, unsigned char *);
+template unsigned char * p4Enc32Fixed<128u>(uint32_t *, unsigned char *);
+template unsigned char * p4Enc32Fixed<256u>(uint32_t *, unsigned char *);
+
 } // namespace turbopfor::scalar
@@ -19,44 +19,25 @@ unsigned char * p4Enc64PayloadExceptions(uint64_t * in, unsigned n, unsigned cha
     // Temporary arrays for splitting values into base and exceptions
     uint64_t base[MAX_VALUES]; // Base values (low b bits)
     uint64_t exceptions[MAX_VALUES]; // Exception values (high bits)
-    uint32_t exception_positions[MAX_VALUES]; // Positions of exception values
+    uint64_t bitmap[MAX_VALUES / 64] = {0}; // 1 bit per value: 1 = has exception
 
-    // Phase 1: Split values into base and exceptions
-    unsigned exception_count = 0;
-    for (unsigned i = 0; i < n; ++i)
-    {
-        const uint64_t value = in[i];
-        base[i] = value & base_mask;
+    const unsigned words = (n + 63u) / 64u;
 
-        // Check if this value needs more than b bits (is an exception)
-        if (value > base_mask)
-        {
-            exception_positions[exception_count] = i;
-            exceptions[exception_count] = value >> b; // Store high bits
-            ++exception_count;
-        }
-    }
+    // Phases 1+2 in one kernel: mask the base values out, build the
+    // exception bitmap from the compare masks and pack the high bits
+    // (value >> b) into exceptions[] in position order — the count stays in
+    // a register and no position list is materialized here.
+    const unsigned exception_count = scanExceptions64(in, n, base_mask, b, base, bitmap, exceptions);
 
-    // Phase 2: Encode exceptions based on strategy
+    // Phase 3: Encode exceptions based on strategy
 
     if (bx <= MAX_BITS_64)
     {
         // Strategy: Bitwise patching
         // Format: [bitmap][patch bits][base bits]
 
-        // Build exception bitmap (1 bit = has exception, 0 bit = no exception)
-        uint64_t bitmap[MAX_VALUES / 64]; // 4 uint64_t for 256 bits
-        std::memset(bitmap, 0, sizeof(bitmap));
-
-        for (unsigned i = 0; i < exception_count; ++i)
-        {
-            const unsigned pos = exception_positions[i];
-            bitmap[pos >> 6] |= 1ull << (pos & 0x3Fu); // Set bit at position
-        }
-
         // Write bitmap (pad to byte boundary)
-        const unsigned bitmap_words = (n + 63u) / 64u;
-        for (unsigned i = 0; i < bitmap_words; ++i)
+        for (unsigned i = 0; i < words; ++i)
         {
             storeU64Fast(out + i * sizeof(uint64_t), bitmap[i]);
         }
@@ -83,9 +64,13 @@ unsigned char * p4Enc64PayloadExceptions(uint64_t * in, unsigned n, unsigned cha
     // Write exception values using 64-bit variable-byte encoding
     out = vbEnc64(exceptions, exception_count, out);
 
-    // Write exception positions
-    for (unsigned i = 0; i < exception_count; ++i)
-        *out++ = exception_positions[i];
+    // Write exception positions (1 byte each, since n <= 256): recover the
+    // ascending position list from the bitmap straight into the stream —
+    // only this strategy needs it. The expansion's 8-byte stores may run a
+    // few bytes past the list; the stream write slack covers that, as it
+    // does for the bitmap words.
+    expandBitmapIndices(bitmap, words, out);
+    out += exception_count;
 
     return out;
 }
@@ -1,11 +1,30 @@
 #include "p4_simd_internal.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    define TURBOPFOR_BITPACK128V32_AVX2 1
+#endif
+
 namespace turbopfor::simd::detail
 {
 
+// Loads one group, masking it to b bits unless the caller guarantees the
+// values already fit (PreMasked): the P4 encoders pack base[] arrays the
+// exception scan has just masked, so the AND per group is pure overhead there.
+template <bool PreMasked>
+ALWAYS_INLINE __m128i loadGroup(const uint32_t * p, __m128i mv)
+{
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    if constexpr (PreMasked)
+        return v;
+    else
+        return _mm_and_si128(v, mv);
+}
+
 // Optimized general implementation with 4x unrolling
-// Minimizes branch overhead and improves instruction-level parallelism
-static unsigned char * bitpack128v32_general(const uint32_t * in, unsigned char * out, unsigned b)
+// Minimizes branch overhead and improves instruction-level parallelism.
+// ALWAYS_INLINE so the fixed-b wrappers below fold b into immediates.
+template <bool PreMasked>
+ALWAYS_INLINE static unsigned char * bitpack128v32_general(const uint32_t * in, unsigned char * out, unsigned b)
 {
     const __m128i mv = _mm_set1_epi32(static_cast<int>((1u << b) - 1u));
     __m128i * op = reinterpret_cast<__m128i *>(out);
@@ -16,22 +35,22 @@ static unsigned char * bitpack128v32_general(const uint32_t * in, unsigned char
     // Process 4 groups at a time (16 elements per iteration)
     for (unsigned g = 0; g < 32u; g += 4u)
     {
-        __m128i iv0 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + g * 4u)), mv);
-        __m128i iv1 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (g + 1) * 4u)), mv);
-        __m128i iv2 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (g + 2) * 4u)), mv);
-        __m128i iv3 = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (g + 3) * 4u)), mv);
-
-        // Process iv0
-        if (shift == 0u)
-            ov = iv0;
-        else
-            ov = _mm_or_si128(ov, _mm_slli_epi32(iv0, static_cast<int>(shift)));
+        __m128i iv0 = loadGroup<PreMasked>(in + g * 4u, mv);
+        __m128i iv1 = loadGroup<PreMasked>(in + (g + 1) * 4u, mv);
+        __m128i iv2 = loadGroup<PreMasked>(in + (g + 2) * 4u, mv);
+        __m128i iv3 = loadGroup<PreMasked>(in + (g + 3) * 4u, mv);
+
+        // Process iv0 (ov is zero whenever shift is, so the OR needs no guard)
+        ov = _mm_or_si128(ov, _mm_slli_epi32(iv0, static_cast<int>(shift)));
         shift += b;
         if (shift >= 32u)
         {
             _mm_storeu_si128(op++, ov);
             shift -= 32u;
-            ov = (shift > 0u) ? _mm_srli_epi32(iv0, static_cast<int>(b - shift)) : _mm_setzero_si128();
+            // iv0 holds at most b bits (masked here or by the caller's
+            // contract), so when shift == 0 this shifts by b and lands on
+            // zero anyway — no conditional needed (same below).
+            ov = _mm_srli_epi32(iv0, static_cast<int>(b - shift));
         }
 
         // Process iv1
@@ -41,7 +60,7 @@ static unsigned char * bitpack128v32_general(const uint32_t * in, unsigned char
         {
             _mm_storeu_si128(op++, ov);
             shift -= 32u;
-            ov = (shift > 0u) ? _mm_srli_epi32(iv1, static_cast<int>(b - shift)) : _mm_setzero_si128();
+            ov = _mm_srli_epi32(iv1, static_cast<int>(b - shift));
         }
 
         // Process iv2
@@ -51,7 +70,7 @@ static unsigned char * bitpack128v32_general(const uint32_t * in, unsigned char
         {
             _mm_storeu_si128(op++, ov);
             shift -= 32u;
-            ov = (shift > 0u) ? _mm_srli_epi32(iv2, static_cast<int>(b - shift)) : _mm_setzero_si128();
+            ov = _mm_srli_epi32(iv2, static_cast<int>(b - shift));
         }
 
         // Process iv3
@@ -61,19 +80,20 @@ static unsigned char * bitpack128v32_general(const uint32_t * in, unsigned char
         {
             _mm_storeu_si128(op++, ov);
             shift -= 32u;
-            ov = (shift > 0u) ? _mm_srli_epi32(iv3, static_cast<int>(b - shift)) : _mm_setzero_si128();
+            ov = _mm_srli_epi32(iv3, static_cast<int>(b - shift));
         }
     }
 
-    if (shift > 0u)
-    {
-        _mm_storeu_si128(op++, ov);
-    }
-
-    return out + (128u * b + 7u) / 8u;
+    // No tail store: each lane packs exactly 32 * b bits, a multiple of 32,
+    // so the last group always lands on a word boundary and the in-loop store
+    // has already flushed it (shift is provably 0 here). 128 values at b bits
+    // is a whole number of bytes, so the stream size is exactly 16 * b — no
+    // round-up arithmetic on the return path.
+    return out + b * 16u;
 }
 
 // Specialized implementation for b=1 - fully unrolled
+template <bool PreMasked>
 static unsigned char * bitpack128v32_b1(const uint32_t * in, unsigned char * out)
 {
     __m128i * op = reinterpret_cast<__m128i *>(out);
@@ -82,8 +102,7 @@ static unsigned char * bitpack128v32_b1(const uint32_t * in, unsigned char * out
 
 #define PACK1(g) \
     { \
-        __m128i iv = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (g) * 4u)); \
-        iv = _mm_and_si128(iv, mv); \
+        __m128i iv = loadGroup<PreMasked>(in + (g) * 4u, mv); \
         ov = _mm_or_si128(ov, _mm_slli_epi32(iv, g)); \
     }
 
@@ -127,6 +146,7 @@ static unsigned char * bitpack128v32_b1(const uint32_t * in, unsigned char * out
 }
 
 // Specialized implementation for b=2 - fully unrolled
+template <bool PreMasked>
 static unsigned char * bitpack128v32_b2(const uint32_t * in, unsigned char * out)
 {
     __m128i * op = reinterpret_cast<__m128i *>(out);
@@ -135,8 +155,7 @@ static unsigned char * bitpack128v32_b2(const uint32_t * in, unsigned char * out
 
 #define PACK2(g, sh) \
     { \
-        __m128i iv = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (g) * 4u)); \
-        iv = _mm_and_si128(iv, mv); \
+        __m128i iv = loadGroup<PreMasked>(in + (g) * 4u, mv); \
         if (sh == 0) \
             ov = iv; \
         else \
@@ -187,6 +206,7 @@ static unsigned char * bitpack128v32_b2(const uint32_t * in, unsigned char * out
 }
 
 // Specialized implementation for b=4 - fully unrolled
+template <bool PreMasked>
 static unsigned char * bitpack128v32_b4(const uint32_t * in, unsigned char * out)
 {
     __m128i * op = reinterpret_cast<__m128i *>(out);
@@ -195,8 +215,7 @@ static unsigned char * bitpack128v32_b4(const uint32_t * in, unsigned char * out
 
 #define PACK4(g, sh) \
     { \
-        __m128i iv = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (g) * 4u)); \
-        iv = _mm_and_si128(iv, mv); \
+        __m128i iv = loadGroup<PreMasked>(in + (g) * 4u, mv); \
         if (sh == 0) \
             ov = iv; \
         else \
@@ -250,6 +269,7 @@ static unsigned char * bitpack128v32_b4(const uint32_t * in, unsigned char * out
 }
 
 // Specialized implementation for b=8 - fully unrolled
+template <bool PreMasked>
 static unsigned char * bitpack128v32_b8(const uint32_t * in, unsigned char * out)
 {
     __m128i * op = reinterpret_cast<__m128i *>(out);
@@ -270,14 +290,10 @@ static unsigned char * bitpack128v32_b8(const uint32_t * in, unsigned char * out
     for (unsigned i = 0; i < 8; ++i)
     {
         unsigned base = i * 4;
-        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (base + 0) * 4u));
-        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (base + 1) * 4u));
-        __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (base + 2) * 4u));
-        __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (base + 3) * 4u));
-        v0 = _mm_and_si128(v0, mv);
-        v1 = _mm_and_si128(v1, mv);
-        v2 = _mm_and_si128(v2, mv);
-        v3 = _mm_and_si128(v3, mv);
+        __m128i v0 = loadGroup<PreMasked>(in + (base + 0) * 4u, mv);
+        __m128i v1 = loadGroup<PreMasked>(in + (base + 1) * 4u, mv);
+        __m128i v2 = loadGroup<PreMasked>(in + (base + 2) * 4u, mv);
+        __m128i v3 = loadGroup<PreMasked>(in + (base + 3) * 4u, mv);
         ov = v0;
         ov = _mm_or_si128(ov, _mm_slli_epi32(v1, 8));
         ov = _mm_or_si128(ov, _mm_slli_epi32(v2, 16));
@@ -291,6 +307,7 @@ static unsigned char * bitpack128v32_b8(const uint32_t * in, unsigned char * out
 }
 
 // Specialized implementation for b=16 - fully unrolled
+template <bool PreMasked>
 static unsigned char * bitpack128v32_b16(const uint32_t * in, unsigned char * out)
 {
     __m128i * op = reinterpret_cast<__m128i *>(out);
@@ -299,10 +316,8 @@ static unsigned char * bitpack128v32_b16(const uint32_t * in, unsigned char * ou
     // 16 outputs, 2 groups each
     for (unsigned i = 0; i < 16; ++i)
     {
-        __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (i * 2 + 0) * 4u));
-        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + (i * 2 + 1) * 4u));
-        v0 = _mm_and_si128(v0, mv);
-        v1 = _mm_and_si128(v1, mv);
+        __m128i v0 = loadGroup<PreMasked>(in + (i * 2 + 0) * 4u, mv);
+        __m128i v1 = loadGroup<PreMasked>(in + (i * 2 + 1) * 4u, mv);
         __m128i ov = _mm_or_si128(v0, _mm_slli_epi32(v1, 16));
         _mm_storeu_si128(op++, ov);
     }
@@ -310,7 +325,237 @@ static unsigned char * bitpack128v32_b16(const uint32_t * in, unsigned char * ou
     return out + 256;
 }
 
-unsigned char * bitpack128v32(const uint32_t * in, unsigned char * out, unsigned b)
+#ifdef TURBOPFOR_BITPACK128V32_AVX2
+
+/// AVX2 b = 8 packer: two 16-byte output words per iteration. A ymm load
+/// covers two consecutive groups, so four loads bring in the eight groups the
+/// two words need; VPERM2I128 re-pairs them so each half of the accumulator
+/// sees its own word's groups, and three shift+OR steps lay the byte lanes
+/// down. Halves the loop trips and store count of the SSE body.
+template <bool PreMasked>
+__attribute__((target("avx2"))) static unsigned char * bitpack128v32_b8_avx2(const uint32_t * in, unsigned char * out)
+{
+    const __m256i mv = _mm256_set1_epi32(0xFF);
+
+    for (unsigned i = 0; i < 4u; ++i)
+    {
+        const uint32_t * p = in + i * 32u;
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); // groups 8i+0, 8i+1
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 8u)); // 8i+2, 8i+3
+        __m256i vc = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 16u)); // 8i+4, 8i+5
+        __m256i vd = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 24u)); // 8i+6, 8i+7
+        if constexpr (!PreMasked)
+        {
+            va = _mm256_and_si256(va, mv);
+            vb = _mm256_and_si256(vb, mv);
+            vc = _mm256_and_si256(vc, mv);
+            vd = _mm256_and_si256(vd, mv);
+        }
+
+        // Re-pair so the low half holds word 2i's groups and the high half
+        // word 2i+1's: t0 = {g0, g4}, t1 = {g1, g5}, t2 = {g2, g6}, t3 = {g3, g7}
+        __m256i t0 = _mm256_permute2x128_si256(va, vc, 0x20);
+        __m256i t1 = _mm256_permute2x128_si256(va, vc, 0x31);
+        __m256i t2 = _mm256_permute2x128_si256(vb, vd, 0x20);
+        __m256i t3 = _mm256_permute2x128_si256(vb, vd, 0x31);
+
+        __m256i ov = _mm256_or_si256(t0, _mm256_slli_epi32(t1, 8));
+        ov = _mm256_or_si256(ov, _mm256_slli_epi32(t2, 16));
+        ov = _mm256_or_si256(ov, _mm256_slli_epi32(t3, 24));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * 32u), ov);
+    }
+
+    return out + 128;
+}
+
+/// AVX2 b = 16 packer: same re-pairing scheme, two groups per word.
+template <bool PreMasked>
+__attribute__((target("avx2"))) static unsigned char * bitpack128v32_b16_avx2(const uint32_t * in, unsigned char * out)
+{
+    const __m256i mv = _mm256_set1_epi32(0xFFFF);
+
+    for (unsigned i = 0; i < 8u; ++i)
+    {
+        const uint32_t * p = in + i * 16u;
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); // groups 4i+0, 4i+1
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 8u)); // 4i+2, 4i+3
+        if constexpr (!PreMasked)
+        {
+            va = _mm256_and_si256(va, mv);
+            vb = _mm256_and_si256(vb, mv);
+        }
+
+        __m256i t0 = _mm256_permute2x128_si256(va, vb, 0x20); // {g0, g2}
+        __m256i t1 = _mm256_permute2x128_si256(va, vb, 0x31); // {g1, g3}
+        __m256i ov = _mm256_or_si256(t0, _mm256_slli_epi32(t1, 16));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i * 32u), ov);
+    }
+
+    return out + 256;
+}
+
+/// AVX2 general packer: builds two output words per iteration in one ymm
+/// (low half word w, high half word w+1), so the cross-iteration shift
+/// accumulator and its shift >= 32 split disappear. Each contributing group
+/// is broadcast to both halves and placed with per-lane variable shifts;
+/// VPSLLVD/VPSRLVD zero lanes whose count falls outside 0..31, so one
+/// sllv|srlv pair covers starts, spills and non-contributors branch-free
+/// (the ymm version of the 256v32 AVX-512 tier's scheme).
+template <bool PreMasked>
+__attribute__((target("avx2"))) ALWAYS_INLINE static unsigned char *
+bitpack128v32_general_avx2(const uint32_t * in, unsigned char * out, unsigned b)
+{
+    const __m256i mask = _mm256_set1_epi32(static_cast<int>(maskBits(b)));
+    const __m256i word_bias = _mm256_inserti128_si256(_mm256_setzero_si256(), _mm_set1_epi32(32), 1);
+
+    unsigned w = 0;
+    for (; w + 2u <= b; w += 2u)
+    {
+        __m256i acc = _mm256_setzero_si256();
+        for (unsigned g = (w * 32u) / b; g < 32u && g * b < (w + 2u) * 32u; ++g)
+        {
+            const int s = static_cast<int>(g * b) - static_cast<int>(w * 32u);
+            __m256i v = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + g * 4u)));
+            if constexpr (!PreMasked)
+                v = _mm256_and_si256(v, mask);
+            const __m256i sl = _mm256_sub_epi32(_mm256_set1_epi32(s), word_bias);
+            acc = _mm256_or_si256(acc, _mm256_sllv_epi32(v, sl));
+            acc = _mm256_or_si256(acc, _mm256_srlv_epi32(v, _mm256_sub_epi32(_mm256_setzero_si256(), sl)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + w * 16u), acc);
+    }
+
+    if (w < b)
+    {
+        // Odd b: the last word gets the xmm version of the same scheme.
+        const __m128i mask128 = _mm256_castsi256_si128(mask);
+        __m128i acc = _mm_setzero_si128();
+        for (unsigned g = (w * 32u) / b; g < 32u; ++g)
+        {
+            const int s = static_cast<int>(g * b) - static_cast<int>(w * 32u);
+            const __m128i v = loadGroup<PreMasked>(in + g * 4u, mask128);
+            acc = _mm_or_si128(acc, s >= 0 ? _mm_slli_epi32(v, s) : _mm_srli_epi32(v, -s));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + w * 16u), acc);
+    }
+
+    return out + b * 16u; // 128 values at b bits: exactly 16 * b bytes
+}
+
+/// AVX-512 general packer: the zmm version of the AVX2 scheme above — four
+/// output words per iteration, one 128-bit lane each. Every contributing
+/// group is broadcast to all four lanes with VBROADCASTI32X4 and placed by
+/// per-lane variable shifts against a {0,32,64,96} word bias; counts outside
+/// 0..31 shift to zero, so starts, spills and non-contributors stay
+/// branch-free. The 0-3 words b leaves over run the two-word ymm step and
+/// the one-word xmm step from the AVX2 kernel.
+template <bool PreMasked>
+__attribute__((target("avx512f"))) ALWAYS_INLINE static unsigned char *
+bitpack128v32_general_avx512(const uint32_t * in, unsigned char * out, unsigned b)
+{
+    const __m512i mask = _mm512_set1_epi32(static_cast<int>(maskBits(b)));
+    const __m512i word_bias = _mm512_set_epi32(96, 96, 96, 96, 64, 64, 64, 64, 32, 32, 32, 32, 0, 0, 0, 0);
+
+    unsigned w = 0;
+    for (; w + 4u <= b; w += 4u)
+    {
+        __m512i acc = _mm512_setzero_si512();
+        for (unsigned g = (w * 32u) / b; g < 32u && g * b < (w + 4u) * 32u; ++g)
+        {
+            const int s = static_cast<int>(g * b) - static_cast<int>(w * 32u);
+            __m512i v = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + g * 4u)));
+            if constexpr (!PreMasked)
+                v = _mm512_and_si512(v, mask);
+            const __m512i sl = _mm512_sub_epi32(_mm512_set1_epi32(s), word_bias);
+            acc = _mm512_or_si512(acc, _mm512_sllv_epi32(v, sl));
+            acc = _mm512_or_si512(acc, _mm512_srlv_epi32(v, _mm512_sub_epi32(_mm512_setzero_si512(), sl)));
+        }
+        _mm512_storeu_si512(out + w * 16u, acc);
+    }
+
+    if (w + 2u <= b)
+    {
+        const __m256i mask256 = _mm512_castsi512_si256(mask);
+        const __m256i word_bias256 = _mm256_inserti128_si256(_mm256_setzero_si256(), _mm_set1_epi32(32), 1);
+        __m256i acc = _mm256_setzero_si256();
+        // Explicit end group (first one starting at or past the window) so
+        // the bound is a single comparison the unroller can see through
+        const unsigned g_hi = ((w + 2u) * 32u + b - 1u) / b;
+        const unsigned g_end = g_hi < 32u ? g_hi : 32u;
+        for (unsigned g = (w * 32u) / b; g < g_end; ++g)
+        {
+            const int s = static_cast<int>(g * b) - static_cast<int>(w * 32u);
+            __m256i v = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + g * 4u)));
+            if constexpr (!PreMasked)
+                v = _mm256_and_si256(v, mask256);
+            const __m256i sl = _mm256_sub_epi32(_mm256_set1_epi32(s), word_bias256);
+            acc = _mm256_or_si256(acc, _mm256_sllv_epi32(v, sl));
+            acc = _mm256_or_si256(acc, _mm256_srlv_epi32(v, _mm256_sub_epi32(_mm256_setzero_si256(), sl)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + w * 16u), acc);
+        w += 2u;
+    }
+
+    if (w < b)
+    {
+        const __m128i mask128 = _mm512_castsi512_si128(mask);
+        __m128i acc = _mm_setzero_si128();
+        for (unsigned g = (w * 32u) / b; g < 32u; ++g)
+        {
+            const int s = static_cast<int>(g * b) - static_cast<int>(w * 32u);
+            const __m128i v = loadGroup<PreMasked>(in + g * 4u, mask128);
+            acc = _mm_or_si128(acc, s >= 0 ? _mm_slli_epi32(v, s) : _mm_srli_epi32(v, -s));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + w * 16u), acc);
+    }
+
+    return out + b * 16u; // 128 values at b bits: exactly 16 * b bytes
+}
+
+#endif
+
+// Fixed-b families over the general packers, one per tier. With B a constant
+// the word loops unroll, trip counts and group ranges fold, and every shift
+// count or shift vector becomes a compile-time constant — the same per-b
+// specialization the decode dispatch gets from GEN_SWITCH_AVX2. The members
+// carry the tier's target attribute so the ALWAYS_INLINE generals fold into
+// them.
+template <bool PreMasked>
+struct PackGeneralSse
+{
+    template <unsigned B>
+    static unsigned char * run(const uint32_t * in, unsigned char * out)
+    {
+        return bitpack128v32_general<PreMasked>(in, out, B);
+    }
+};
+
+#ifdef TURBOPFOR_BITPACK128V32_AVX2
+
+template <bool PreMasked>
+struct PackGeneralAvx2
+{
+    template <unsigned B>
+    __attribute__((target("avx2"))) static unsigned char * run(const uint32_t * in, unsigned char * out)
+    {
+        return bitpack128v32_general_avx2<PreMasked>(in, out, B);
+    }
+};
+
+template <bool PreMasked>
+struct PackGeneralAvx512
+{
+    template <unsigned B>
+    __attribute__((target("avx512f"))) static unsigned char * run(const uint32_t * in, unsigned char * out)
+    {
+        return bitpack128v32_general_avx512<PreMasked>(in, out, B);
+    }
+};
+
+#endif
+
+template <class General, bool PreMasked, bool Avx2>
+static unsigned char * bitpack128v32Entry(const uint32_t * in, unsigned char * out, unsigned b)
 {
     if (b == 0u)
         return out;
@@ -325,18 +570,110 @@ unsigned char * bitpack128v32(const uint32_t * in, unsigned char * out, unsigned
     switch (b)
     {
         case 1:
-            return bitpack128v32_b1(in, out);
+            return bitpack128v32_b1<PreMasked>(in, out);
         case 2:
-            return bitpack128v32_b2(in, out);
+            return bitpack128v32_b2<PreMasked>(in, out);
         case 4:
-            return bitpack128v32_b4(in, out);
+            return bitpack128v32_b4<PreMasked>(in, out);
         case 8:
-            return bitpack128v32_b8(in, out);
+#ifdef TURBOPFOR_BITPACK128V32_AVX2
+            if constexpr (Avx2)
+                return bitpack128v32_b8_avx2<PreMasked>(in, out);
+#endif
+            return bitpack128v32_b8<PreMasked>(in, out);
         case 16:
-            return bitpack128v32_b16(in, out);
+#ifdef TURBOPFOR_BITPACK128V32_AVX2
+            if constexpr (Avx2)
+                return bitpack128v32_b16_avx2<PreMasked>(in, out);
+#endif
+            return bitpack128v32_b16<PreMasked>(in, out);
         default:
-            return bitpack128v32_general(in, out, b);
+            break;
+    }
+
+    // Remaining widths: a switch into the fixed-b instantiations. b comes
+    // straight from the cost model, never above 32, so there is no default —
+    // same contract as the decode-side b dispatch.
+#define PACK_CASE(B_) \
+    case B_: \
+        return General::template run<B_>(in, out);
+    switch (b)
+    {
+        PACK_CASE(3)
+        PACK_CASE(5)
+        PACK_CASE(6)
+        PACK_CASE(7)
+        PACK_CASE(9)
+        PACK_CASE(10)
+        PACK_CASE(11)
+        PACK_CASE(12)
+        PACK_CASE(13)
+        PACK_CASE(14)
+        PACK_CASE(15)
+        PACK_CASE(17)
+        PACK_CASE(18)
+        PACK_CASE(19)
+        PACK_CASE(20)
+        PACK_CASE(21)
+        PACK_CASE(22)
+        PACK_CASE(23)
+        PACK_CASE(24)
+        PACK_CASE(25)
+        PACK_CASE(26)
+        PACK_CASE(27)
+        PACK_CASE(28)
+        PACK_CASE(29)
+        PACK_CASE(30)
+        PACK_CASE(31)
     }
+#undef PACK_CASE
+    __builtin_unreachable();
 }
 
+#if defined(TURBOPFOR_BITPACK128V32_AVX2) && defined(__ELF__)
+
+// IFUNC resolver, as elsewhere: one load-time selection, no per-call CPUID
+// check. The power-of-2 widths keep the fully unrolled SSE bodies — they
+// never split a value across words, so the accumulator chain the AVX2 kernel
+// removes does not exist there.
+extern "C" void * turbopforResolveBitpack128v32()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return reinterpret_cast<void *>(&bitpack128v32Entry<PackGeneralAvx512<false>, false, true>);
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&bitpack128v32Entry<PackGeneralAvx2<false>, false, true>);
+    return reinterpret_cast<void *>(&bitpack128v32Entry<PackGeneralSse<false>, false, false>);
+}
+
+unsigned char * bitpack128v32(const uint32_t * in, unsigned char * out, unsigned b)
+    __attribute__((ifunc("turbopforResolveBitpack128v32")));
+
+extern "C" void * turbopforResolveBitpack128v32NoMask()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return reinterpret_cast<void *>(&bitpack128v32Entry<PackGeneralAvx512<true>, true, true>);
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&bitpack128v32Entry<PackGeneralAvx2<true>, true, true>);
+    return reinterpret_cast<void *>(&bitpack128v32Entry<PackGeneralSse<true>, true, false>);
+}
+
+unsigned char * bitpack128v32NoMask(const uint32_t * in, unsigned char * out, unsigned b)
+    __attribute__((ifunc("turbopforResolveBitpack128v32NoMask")));
+
+#else
+
+unsigned char * bitpack128v32(const uint32_t * in, unsigned char * out, unsigned b)
+{
+    return bitpack128v32Entry<PackGeneralSse<false>, false, false>(in, out, b);
+}
+
+unsigned char * bitpack128v32NoMask(const uint32_t * in, unsigned char * out, unsigned b)
+{
+    return bitpack128v32Entry<PackGeneralSse<true>, true, false>(in, out, b);
+}
+
+#endif
+
 } // namespace turbopfor::simd::detail
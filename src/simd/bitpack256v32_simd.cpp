@@ -2,6 +2,10 @@
 #include "p4_simd_internal_256v.h"
 #include <immintrin.h>
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    define TURBOPFOR_BITPACK256V32_AVX512 1
+#endif
+
 namespace turbopfor::simd::detail {
 namespace {
 
@@ -19,93 +23,125 @@ struct MaskGen<32> {
     static constexpr uint32_t value = 0xFFFFFFFFu;
 };
 
-// Pack 8x32 bits horizontally
-template <unsigned B, unsigned G, int CurrentStoredIdx>
-struct PackStep {
-    static ALWAYS_INLINE void run(const __m256i*& ip, __m256i& ov, unsigned char*& op, const __m256i& mask) {
-        constexpr int TargetIdx = (G * B) / 32;      // Index of 32-bit word we are writing to (0..B-1)
-        constexpr int Offset = (G * B) % 32;         // Bit offset within that word
-        constexpr bool Spans = (Offset + B > 32);    // Does this value span across two words?
-        
-        // Load input (8 x 32-bit integers from input group G)
-        // Group G contains: in[G*8], in[G*8+1], ... in[G*8+7]
-        // Which corresponds to one value per lane.
-        __m256i iv = _mm256_loadu_si256(ip++);
-        
-        // Mask the input values (only B bits)
-        if (B != 32) {
-            iv = _mm256_and_si256(iv, mask);
-        }
-
-        // Pack bits into accumulator ov
-        if (Offset == 0) {
-            // New word starts exactly at bit 0
-            if (CurrentStoredIdx != TargetIdx) {
-               // We moved to a new word, but previous one was fully written? 
-               // Wait, logic:
-               // ov holds the CURRENT 32-bit word being built.
-               // If Offset == 0, it means we just finished previous word (or this is the first).
-               // So ov should be reset to iv.
-               ov = iv;
-            } else {
-               // This should not happen if logic is correct, Offset 0 usually implies new word start
-               ov = iv;
-            }
-        } else {
-            // Add to existing accumulator
-            ov = _mm256_or_si256(ov, _mm256_slli_epi32(iv, Offset));
-        }
-
-        if (Spans) {
-            // The current value spills over to the next 32-bit word.
-            // 1. Store the current full word
-            _mm256_storeu_si256(reinterpret_cast<__m256i*>(op), ov);
-            op += 32; // Advance 32 bytes (8 lanes x 4 bytes)
-
-            // 2. Start next word with remaining bits
-            constexpr int BitsInFirst = 32 - Offset;
-            ov = _mm256_srli_epi32(iv, BitsInFirst);
-        } else if (Offset + B == 32) {
-             // Exact fit at end of word
-            _mm256_storeu_si256(reinterpret_cast<__m256i*>(op), ov);
-            op += 32;
-            // Next iteration will start new word (Offset=0)
-        }
-
-        constexpr int NextStoredIdx = Spans ? TargetIdx + 1 : TargetIdx;
-        PackStep<B, G + 1, NextStoredIdx>::run(ip, ov, op, mask);
+// Pack 8x32 bits horizontally, one output word at a time.
+//
+// The old scheme threaded a single accumulator through all 32 input groups,
+// so the recurrence depth equalled the number of output words. Here each
+// output word W is built independently: the (at most ceil(32/B)+1) groups
+// whose bit ranges overlap [W*32, (W+1)*32) are loaded, masked, shifted into
+// place and OR-combined. All shift amounts are compile-time constants per
+// (W, G) pair, so the terms are fully independent and the only dependency
+// left is the short OR reduction feeding each store.
+
+// OR together the groups contributing to output word W, starting at group G.
+template <unsigned B, unsigned W, unsigned G>
+struct WordTerm {
+    static ALWAYS_INLINE __m256i run(const __m256i* ip, const __m256i& mask) {
+        // Bit position of group G relative to the start of word W; negative
+        // means the group began in the previous word and its high bits spill
+        // into this one.
+        constexpr int Shift = static_cast<int>(G * B) - static_cast<int>(W * 32);
+
+        __m256i iv = _mm256_and_si256(_mm256_loadu_si256(ip + G), mask);
+        __m256i term;
+        if constexpr (Shift >= 0)
+            term = _mm256_slli_epi32(iv, Shift);
+        else
+            term = _mm256_srli_epi32(iv, -Shift);
+
+        constexpr unsigned NextG = G + 1;
+        if constexpr (NextG < 32 && NextG * B < (W + 1) * 32)
+            term = _mm256_or_si256(term, WordTerm<B, W, NextG>::run(ip, mask));
+        return term;
     }
 };
 
-// Base case
-template <unsigned B, int CurrentStoredIdx>
-struct PackStep<B, 32, CurrentStoredIdx> {
-    static ALWAYS_INLINE void run(const __m256i*&, __m256i&, unsigned char*&, const __m256i&) {}
+template <unsigned B, unsigned W>
+struct PackWord {
+    static ALWAYS_INLINE void run(const __m256i* ip, unsigned char* op, const __m256i& mask) {
+        // First group whose bit range reaches into word W.
+        constexpr unsigned FirstG = (W * 32) / B;
+        const __m256i ov = WordTerm<B, W, FirstG>::run(ip, mask);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(op + W * 32), ov);
+        if constexpr (W + 1 < B)
+            PackWord<B, W + 1>::run(ip, op, mask);
+    }
 };
 
 // Entry point wrappers
 template <unsigned B>
 ALWAYS_INLINE unsigned char* bitpack_entry(const uint32_t* in, unsigned char* out) {
-    if (B == 0) return out;
-    if (B == 32) {
+    if constexpr (B == 0) {
+        return out;
+    } else if constexpr (B == 32) {
         // Just copy
         std::memcpy(out, in, 256 * 4);
         return out + 256 * 4;
+    } else {
+        const __m256i* ip = reinterpret_cast<const __m256i*>(in);
+        const __m256i mask = _mm256_set1_epi32(static_cast<int>(MaskGen<B>::value));
+
+        PackWord<B, 0>::run(ip, out, mask);
+
+        return out + (256 * B + 7) / 8;
+    }
+}
+
+#ifdef TURBOPFOR_BITPACK256V32_AVX512
+
+/// AVX-512 packer: builds two output words per iteration in one zmm (low half
+/// word w, high half word w+1). Each contributing group is broadcast to both
+/// halves and shifted into place with per-lane variable shifts; counts outside
+/// [0,31] come out as zero on VPSLLVD/VPSRLVD, so a single sllv|srlv pair
+/// covers "starts in this word", "spills from the previous word" and "does
+/// not touch this word" without any branches. One runtime-b kernel serves all
+/// widths, so no 512-bit dispatch table is needed.
+__attribute__((target("avx512f"))) static unsigned char *
+bitpack256v32Avx512(const uint32_t * __restrict in, unsigned char * __restrict out, unsigned b)
+{
+    const __m512i mask = _mm512_set1_epi32(static_cast<int>(maskBits(b)));
+    // Low half targets word w, high half word w+1: bias the shift counts by
+    // 32 in the upper 8 lanes.
+    const __m512i word_bias = _mm512_inserti64x4(_mm512_setzero_si512(), _mm256_set1_epi32(32), 1);
+
+    unsigned w = 0;
+    for (; w + 2u <= b; w += 2u)
+    {
+        __m512i acc = _mm512_setzero_si512();
+        for (unsigned g = (w * 32u) / b; g < 32u && g * b < (w + 2u) * 32u; ++g)
+        {
+            // Bit position of group g relative to the start of word w;
+            // negative when the group began in the previous word.
+            const int s = static_cast<int>(g * b) - static_cast<int>(w * 32u);
+            const __m512i v = _mm512_and_si512(
+                _mm512_broadcast_i64x4(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + g * 8u))), mask);
+            const __m512i sl = _mm512_sub_epi32(_mm512_set1_epi32(s), word_bias);
+            acc = _mm512_or_si512(acc, _mm512_sllv_epi32(v, sl));
+            acc = _mm512_or_si512(acc, _mm512_srlv_epi32(v, _mm512_sub_epi32(_mm512_setzero_si512(), sl)));
+        }
+        _mm512_storeu_si512(out + w * 32u, acc);
+    }
+
+    if (w < b)
+    {
+        // Odd b: the last word gets the ymm version of the same scheme.
+        const __m256i mask256 = _mm512_castsi512_si256(mask);
+        __m256i acc = _mm256_setzero_si256();
+        for (unsigned g = (w * 32u) / b; g < 32u; ++g)
+        {
+            const int s = static_cast<int>(g * b) - static_cast<int>(w * 32u);
+            const __m256i v
+                = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + g * 8u)), mask256);
+            acc = _mm256_or_si256(acc, s >= 0 ? _mm256_slli_epi32(v, s) : _mm256_srli_epi32(v, -s));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + w * 32u), acc);
     }
 
-    const __m256i* ip = reinterpret_cast<const __m256i*>(in);
-    unsigned char* op = out;
-    
-    const uint32_t mask_val = MaskGen<B>::value;
-    const __m256i mask = _mm256_set1_epi32(static_cast<int>(mask_val));
-    
-    __m256i ov = _mm256_setzero_si256(); // Accumulator
-
-    PackStep<B, 0, -1>::run(ip, ov, op, mask);
-    
-    return out + (256 * B + 7) / 8;
+    return out + 32u * b;
 }
 
+#endif
+
 } // namespace
 
 // Dispatch Table
@@ -122,9 +158,40 @@ static const bitpack256v32_func bitpack_table_256v[33] = {
     bitpack_entry<32>
 };
 
-unsigned char * bitpack256v32(const uint32_t * in, unsigned char * out, unsigned b)
+static unsigned char * bitpack256v32Portable(const uint32_t * in, unsigned char * out, unsigned b)
 {
     return bitpack_table_256v[b](in, out);
 }
 
+#if defined(TURBOPFOR_BITPACK256V32_AVX512) && defined(__ELF__)
+
+static unsigned char * bitpack256v32Avx512Entry(const uint32_t * in, unsigned char * out, unsigned b)
+{
+    if (b >= 1u && b < 32u)
+        return bitpack256v32Avx512(in, out, b);
+    return bitpack_table_256v[b](in, out); // b = 0 and b = 32 are copies
+}
+
+// IFUNC resolver: the loader picks the variant once at startup, so the
+// per-call CPUID check and branch disappear from the entry point entirely.
+extern "C" void * turbopforResolveBitpack256v32Simd()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return reinterpret_cast<void *>(&bitpack256v32Avx512Entry);
+    return reinterpret_cast<void *>(&bitpack256v32Portable);
+}
+
+unsigned char * bitpack256v32(const uint32_t * in, unsigned char * out, unsigned b)
+    __attribute__((ifunc("turbopforResolveBitpack256v32Simd")));
+
+#else
+
+unsigned char * bitpack256v32(const uint32_t * in, unsigned char * out, unsigned b)
+{
+    return bitpack256v32Portable(in, out, b);
+}
+
+#endif
+
 } // namespace turbopfor::simd::detail
@@ -4,9 +4,80 @@
 #include "p4_simd.h"
 #include "p4_simd_internal.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    define TURBOPFOR_BITUNPACK128V32_AVX512 1
+#endif
+
 namespace turbopfor::simd::detail
 {
 
+#ifdef TURBOPFOR_BITUNPACK128V32_AVX512
+
+/// AVX-512 unpacker for the plain (no delta, no patch) path: the 128v sibling
+/// of bitunpack256v32Avx512, emitting four groups of 4 values per iteration.
+/// Each 128-bit lane of the zmm reads its group's starting word plus the
+/// following word and combines them with per-lane variable shifts; the mask at
+/// the end drops whatever the spill word contributed when the field did not
+/// actually span. For the last word the "following word" is clamped back onto
+/// itself so no load reaches past the packed stream. (VPMULTISHIFTQB does not
+/// apply here: it extracts fields from within one qword, but this format
+/// interleaves each value's bits across 16-byte-strided words.)
+__attribute__((target("avx512f"))) static const unsigned char *
+bitunpack128v32Avx512(const unsigned char * __restrict in, uint32_t * __restrict out, unsigned b)
+{
+    const __m512i mask = _mm512_set1_epi32(static_cast<int>((1u << b) - 1u));
+    const __m512i k32 = _mm512_set1_epi32(32);
+
+    const auto word = [in](unsigned w) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + w * 16u)); };
+
+    for (unsigned g = 0; g < 32u; g += 4u)
+    {
+        const unsigned bit0 = g * b, bit1 = bit0 + b, bit2 = bit1 + b, bit3 = bit2 + b;
+        const unsigned w0 = bit0 >> 5u, w1 = bit1 >> 5u, w2 = bit2 >> 5u, w3 = bit3 >> 5u;
+        const unsigned sp0 = (w0 + 1u < b) ? w0 + 1u : w0;
+        const unsigned sp1 = (w1 + 1u < b) ? w1 + 1u : w1;
+        const unsigned sp2 = (w2 + 1u < b) ? w2 + 1u : w2;
+        const unsigned sp3 = (w3 + 1u < b) ? w3 + 1u : w3;
+
+        __m512i main = _mm512_castsi128_si512(word(w0));
+        main = _mm512_inserti32x4(main, word(w1), 1);
+        main = _mm512_inserti32x4(main, word(w2), 2);
+        main = _mm512_inserti32x4(main, word(w3), 3);
+        __m512i spill = _mm512_castsi128_si512(word(sp0));
+        spill = _mm512_inserti32x4(spill, word(sp1), 1);
+        spill = _mm512_inserti32x4(spill, word(sp2), 2);
+        spill = _mm512_inserti32x4(spill, word(sp3), 3);
+        const __m512i scnt = _mm512_setr_epi32(
+            static_cast<int>(bit0 & 31u),
+            static_cast<int>(bit0 & 31u),
+            static_cast<int>(bit0 & 31u),
+            static_cast<int>(bit0 & 31u),
+            static_cast<int>(bit1 & 31u),
+            static_cast<int>(bit1 & 31u),
+            static_cast<int>(bit1 & 31u),
+            static_cast<int>(bit1 & 31u),
+            static_cast<int>(bit2 & 31u),
+            static_cast<int>(bit2 & 31u),
+            static_cast<int>(bit2 & 31u),
+            static_cast<int>(bit2 & 31u),
+            static_cast<int>(bit3 & 31u),
+            static_cast<int>(bit3 & 31u),
+            static_cast<int>(bit3 & 31u),
+            static_cast<int>(bit3 & 31u));
+
+        // Low bits from the starting word, high bits from the spill word; an
+        // s = 0 lane gets a left-shift count of 32, which VPSLLVD turns into
+        // zero, so the combine is branch-free.
+        __m512i v = _mm512_or_si512(_mm512_srlv_epi32(main, scnt), _mm512_sllv_epi32(spill, _mm512_sub_epi32(k32, scnt)));
+        v = _mm512_and_si512(v, mask);
+        _mm512_storeu_si512(out + g * 4u, v);
+    }
+
+    return in + 16u * b;
+}
+
+#endif
+
 // --- bitunpack128v32 (Standard) ---
 using BitUnpackFn = const unsigned char * (*)(const unsigned char *, uint32_t *);
 
@@ -23,12 +94,45 @@ const unsigned char * bitunpack128v32_impl(const unsigned char * in, uint32_t *
         FUNC<14>, FUNC<15>, FUNC<16>, FUNC<17>, FUNC<18>, FUNC<19>, FUNC<20>, FUNC<21>, FUNC<22>, FUNC<23>, FUNC<24>, FUNC<25>, FUNC<26>, \
         FUNC<27>, FUNC<28>, FUNC<29>, FUNC<30>, FUNC<31>, FUNC<32>
 
-const unsigned char * bitunpack128v32(const unsigned char * __restrict in, uint32_t * __restrict out, unsigned b)
+static const unsigned char * bitunpack128v32Portable(const unsigned char * __restrict in, uint32_t * __restrict out, unsigned b)
 {
     static const BitUnpackFn funcs[] = {GEN_TABLE(bitunpack128v32_impl)};
     return funcs[b](in, out);
 }
 
+#if defined(TURBOPFOR_BITUNPACK128V32_AVX512) && defined(__ELF__)
+
+static const unsigned char * bitunpack128v32Avx512Entry(const unsigned char * in, uint32_t * out, unsigned b)
+{
+    if (b >= 1u && b < 32u)
+        return bitunpack128v32Avx512(in, out, b);
+    return bitunpack128v32Portable(in, out, b); // b = 0 and b = 32 are copies
+}
+
+// IFUNC resolver, as in the 256v tier: one load-time selection, no per-call
+// CPUID check. The delta and patching variants keep the SSE templates — their
+// carry and patch merge chain through the groups, which the wide
+// load-both-words scheme above has no room for.
+extern "C" void * turbopforResolveBitunpack128v32Simd()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return reinterpret_cast<void *>(&bitunpack128v32Avx512Entry);
+    return reinterpret_cast<void *>(&bitunpack128v32Portable);
+}
+
+const unsigned char * bitunpack128v32(const unsigned char * in, uint32_t * out, unsigned b)
+    __attribute__((ifunc("turbopforResolveBitunpack128v32Simd")));
+
+#else
+
+const unsigned char * bitunpack128v32(const unsigned char * __restrict in, uint32_t * __restrict out, unsigned b)
+{
+    return bitunpack128v32Portable(in, out, b);
+}
+
+#endif
+
 // --- bitd1unpack128v32 (Delta) ---
 using BitD1UnpackFn = const unsigned char * (*)(const unsigned char *, uint32_t *, __m128i);
 
@@ -3,6 +3,10 @@
 #include "p4_simd.h"
 #include "p4_simd_internal_256v.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    define TURBOPFOR_BITUNPACK256V32_AVX512 1
+#endif
+
 namespace turbopfor::simd::detail
 {
 namespace
@@ -10,77 +14,218 @@ namespace
 
 using namespace turbopfor::simd::detail;
 
-// Wrappers for 256v32 (Count = 256)
-template <unsigned B>
-ALWAYS_INLINE const unsigned char * bitunpack_256v_wrapper(const unsigned char * __restrict in, uint32_t * __restrict out)
+#ifdef TURBOPFOR_BITUNPACK256V32_AVX512
+
+/// AVX-512 unpacker for the plain (no delta, no patch) path: emits two groups
+/// of 8 values per iteration. Each half of the zmm reads its group's starting
+/// word plus the following word and combines them with per-lane variable
+/// shifts; the mask at the end drops whatever the spill word contributed when
+/// the field did not actually span. For the last word the "following word" is
+/// clamped back onto itself so no load reaches past the packed stream, which
+/// is also why no tail loop is needed. (VPMULTISHIFTQB does not apply here:
+/// it extracts fields from within one qword, but this format interleaves each
+/// value's bits across 32-byte-strided words.)
+__attribute__((target("avx512f"))) static const unsigned char *
+bitunpack256v32Avx512(const unsigned char * __restrict in, uint32_t * __restrict out, unsigned b)
 {
-    __m256i sv = _mm256_setzero_si256();
-    return bitunpack_avx2_entry<B, 256, false, false>(in, out, sv, nullptr, nullptr);
+    const __m512i mask = _mm512_set1_epi32(static_cast<int>(maskBits(b)));
+    const __m512i k32 = _mm512_set1_epi32(32);
+
+    for (unsigned g = 0; g < 32u; g += 2u)
+    {
+        const unsigned bit0 = g * b;
+        const unsigned bit1 = bit0 + b;
+        const unsigned w0 = bit0 >> 5u, w1 = bit1 >> 5u;
+        const unsigned sp0 = (w0 + 1u < b) ? w0 + 1u : w0;
+        const unsigned sp1 = (w1 + 1u < b) ? w1 + 1u : w1;
+
+        const __m512i main = _mm512_inserti64x4(
+            _mm512_castsi256_si512(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + w0 * 32u))),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + w1 * 32u)), 1);
+        const __m512i spill = _mm512_inserti64x4(
+            _mm512_castsi256_si512(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + sp0 * 32u))),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + sp1 * 32u)), 1);
+        const __m512i scnt = _mm512_inserti64x4(
+            _mm512_castsi256_si512(_mm256_set1_epi32(static_cast<int>(bit0 & 31u))),
+            _mm256_set1_epi32(static_cast<int>(bit1 & 31u)), 1);
+
+        // Low bits from the starting word, high bits from the spill word; an
+        // s = 0 lane gets a left-shift count of 32, which VPSLLVD turns into
+        // zero, so the combine is branch-free.
+        __m512i v = _mm512_or_si512(_mm512_srlv_epi32(main, scnt), _mm512_sllv_epi32(spill, _mm512_sub_epi32(k32, scnt)));
+        v = _mm512_and_si512(v, mask);
+        _mm512_storeu_si512(out + g * 8u, v);
+    }
+
+    return in + 32u * b;
 }
 
-template <unsigned B>
-ALWAYS_INLINE const unsigned char * bitd1unpack_256v_wrapper(const unsigned char * __restrict in, uint32_t * __restrict out, __m256i sv)
+#endif
+
+// One wrapper family for all four mode combinations (plain / delta, with /
+// without patches): the (Delta, Ex) pair rides in the enclosing struct so the
+// b dispatch below is written once instead of four near-identical copies.
+template <bool Delta, bool Ex>
+struct Unpack256v
 {
-    return bitunpack_avx2_entry<B, 256, true, false>(in, out, sv, nullptr, nullptr);
-}
+    template <unsigned B>
+    static ALWAYS_INLINE const unsigned char *
+    run(const unsigned char * __restrict in, uint32_t * __restrict out, __m256i sv, const uint64_t * bitmap, const uint32_t * pex)
+    {
+        return bitunpack_avx2_entry<B, 256, Delta, Ex>(in, out, sv, bitmap, pex);
+    }
+};
 
-template <unsigned B>
-ALWAYS_INLINE const unsigned char * bitd1unpack_256v_ex_wrapper(
-    const unsigned char * __restrict in, uint32_t * __restrict out, __m256i sv, const uint64_t * bitmap, const uint32_t *& pex)
+} // namespace
+
+// Dispatch: a switch over b instead of a function-pointer table. The compiler
+// lowers it to the same 33-entry jump table, but the targets are direct
+// branches the kernels inline into, so bulk decode pays a predictable indirect
+// jump per block rather than an indirect call — and b comes straight from the
+// header byte, so the jump resolves early. b > 32 was already undefined with
+// the table (out-of-bounds read), so the switch has no default.
+#define GEN_SWITCH_AVX2(FUNC, ...) \
+    switch (b) \
+    { \
+        case 0: return FUNC<0>(__VA_ARGS__); \
+        case 1: return FUNC<1>(__VA_ARGS__); \
+        case 2: return FUNC<2>(__VA_ARGS__); \
+        case 3: return FUNC<3>(__VA_ARGS__); \
+        case 4: return FUNC<4>(__VA_ARGS__); \
+        case 5: return FUNC<5>(__VA_ARGS__); \
+        case 6: return FUNC<6>(__VA_ARGS__); \
+        case 7: return FUNC<7>(__VA_ARGS__); \
+        case 8: return FUNC<8>(__VA_ARGS__); \
+        case 9: return FUNC<9>(__VA_ARGS__); \
+        case 10: return FUNC<10>(__VA_ARGS__); \
+        case 11: return FUNC<11>(__VA_ARGS__); \
+        case 12: return FUNC<12>(__VA_ARGS__); \
+        case 13: return FUNC<13>(__VA_ARGS__); \
+        case 14: return FUNC<14>(__VA_ARGS__); \
+        case 15: return FUNC<15>(__VA_ARGS__); \
+        case 16: return FUNC<16>(__VA_ARGS__); \
+        case 17: return FUNC<17>(__VA_ARGS__); \
+        case 18: return FUNC<18>(__VA_ARGS__); \
+        case 19: return FUNC<19>(__VA_ARGS__); \
+        case 20: return FUNC<20>(__VA_ARGS__); \
+        case 21: return FUNC<21>(__VA_ARGS__); \
+        case 22: return FUNC<22>(__VA_ARGS__); \
+        case 23: return FUNC<23>(__VA_ARGS__); \
+        case 24: return FUNC<24>(__VA_ARGS__); \
+        case 25: return FUNC<25>(__VA_ARGS__); \
+        case 26: return FUNC<26>(__VA_ARGS__); \
+        case 27: return FUNC<27>(__VA_ARGS__); \
+        case 28: return FUNC<28>(__VA_ARGS__); \
+        case 29: return FUNC<29>(__VA_ARGS__); \
+        case 30: return FUNC<30>(__VA_ARGS__); \
+        case 31: return FUNC<31>(__VA_ARGS__); \
+        case 32: return FUNC<32>(__VA_ARGS__); \
+    } \
+    __builtin_unreachable()
+
+// Shared b dispatch over the unified wrapper family; each (Delta, Ex)
+// instantiation gets its own jump table but the source is written once.
+template <bool Delta, bool Ex>
+static const unsigned char *
+dispatch256v(const unsigned char * in, uint32_t * out, unsigned b, __m256i sv, const uint64_t * bitmap, const uint32_t * pex)
 {
-    return bitunpack_avx2_entry<B, 256, true, true>(in, out, sv, bitmap, pex);
+    using U = Unpack256v<Delta, Ex>;
+    GEN_SWITCH_AVX2(U::template run, in, out, sv, bitmap, pex);
 }
 
-template <unsigned B>
-ALWAYS_INLINE const unsigned char * bitunpack_256v_ex_wrapper(
-    const unsigned char * __restrict in, uint32_t * __restrict out, __m256i sv, const uint64_t * bitmap, const uint32_t *& pex)
+const unsigned char * bitd1unpack256v32(const unsigned char * in, uint32_t * out, unsigned b, uint32_t start)
 {
-    return bitunpack_avx2_entry<B, 256, false, true>(in, out, sv, bitmap, pex);
+    __m256i sv = _mm256_set1_epi32(static_cast<int>(start));
+    return dispatch256v<true, false>(in, out, b, sv, nullptr, nullptr);
 }
 
-} // namespace
-
-// Dispatch Tables
-#define GEN_TABLE_AVX2(FUNC) \
-    FUNC<0>, FUNC<1>, FUNC<2>, FUNC<3>, FUNC<4>, FUNC<5>, FUNC<6>, FUNC<7>, FUNC<8>, FUNC<9>, FUNC<10>, FUNC<11>, FUNC<12>, FUNC<13>, \
-        FUNC<14>, FUNC<15>, FUNC<16>, FUNC<17>, FUNC<18>, FUNC<19>, FUNC<20>, FUNC<21>, FUNC<22>, FUNC<23>, FUNC<24>, FUNC<25>, FUNC<26>, \
-        FUNC<27>, FUNC<28>, FUNC<29>, FUNC<30>, FUNC<31>, FUNC<32>
-
-typedef const unsigned char * (*bitd1unpack256v32_func)(const unsigned char *, uint32_t *, __m256i);
-static const bitd1unpack256v32_func bitd1unpack_table_256v[33] = {GEN_TABLE_AVX2(bitd1unpack_256v_wrapper)};
-
-typedef const unsigned char * (*bitunpack256v32_func)(const unsigned char *, uint32_t *);
-static const bitunpack256v32_func bitunpack_table_256v[33] = {GEN_TABLE_AVX2(bitunpack_256v_wrapper)};
+static const unsigned char * bitunpack256v32Portable(const unsigned char * in, uint32_t * out, unsigned b)
+{
+    return dispatch256v<false, false>(in, out, b, _mm256_setzero_si256(), nullptr, nullptr);
+}
 
-typedef const unsigned char * (*bitd1unpack256v32_ex_func)(const unsigned char *, uint32_t *, __m256i, const uint64_t *, const uint32_t *&);
-static const bitd1unpack256v32_ex_func bitd1unpack_ex_table_256v[33] = {GEN_TABLE_AVX2(bitd1unpack_256v_ex_wrapper)};
+#if defined(TURBOPFOR_BITUNPACK256V32_AVX512) && defined(__ELF__)
 
-typedef const unsigned char * (*bitunpack256v32_ex_func)(const unsigned char *, uint32_t *, __m256i, const uint64_t *, const uint32_t *&);
-static const bitunpack256v32_ex_func bitunpack_ex_table_256v[33] = {GEN_TABLE_AVX2(bitunpack_256v_ex_wrapper)};
+static const unsigned char * bitunpack256v32Avx512Entry(const unsigned char * in, uint32_t * out, unsigned b)
+{
+    if (b >= 1u && b < 32u)
+        return bitunpack256v32Avx512(in, out, b);
+    return bitunpack256v32Portable(in, out, b); // b = 0 and b = 32 are copies
+}
 
-const unsigned char * bitd1unpack256v32(const unsigned char * in, uint32_t * out, unsigned b, uint32_t start)
+// IFUNC resolver, as in the scalar tier: one load-time selection, no per-call
+// CPUID check.
+extern "C" void * turbopforResolveBitunpack256v32Simd()
 {
-    __m256i sv = _mm256_set1_epi32(static_cast<int>(start));
-    return bitd1unpack_table_256v[b](in, out, sv);
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return reinterpret_cast<void *>(&bitunpack256v32Avx512Entry);
+    return reinterpret_cast<void *>(&bitunpack256v32Portable);
 }
 
+const unsigned char * bitunpack256v32(const unsigned char * in, uint32_t * out, unsigned b)
+    __attribute__((ifunc("turbopforResolveBitunpack256v32Simd")));
+
+#else
+
 const unsigned char * bitunpack256v32(const unsigned char * in, uint32_t * out, unsigned b)
 {
-    return bitunpack_table_256v[b](in, out);
+    return bitunpack256v32Portable(in, out, b);
 }
 
+#endif
+
 const unsigned char *
 bitd1unpack256v32_ex(const unsigned char * in, uint32_t * out, unsigned b, uint32_t start, const uint64_t * bitmap, const uint32_t *& pex)
 {
     __m256i sv = _mm256_set1_epi32(static_cast<int>(start));
-    return bitd1unpack_ex_table_256v[b](in, out, sv, bitmap, pex);
+    return dispatch256v<true, true>(in, out, b, sv, bitmap, pex);
 }
 
 const unsigned char *
 bitunpack256v32_ex(const unsigned char * in, uint32_t * out, unsigned b, const uint64_t * bitmap, const uint32_t *& pex)
+{
+    return dispatch256v<false, true>(in, out, b, _mm256_setzero_si256(), bitmap, pex);
+}
+
+namespace
+{
+
+// Plain unpack runner for the exception-stream: every chunk of one stream
+// shares the same bx, so the chunk loops live inside the instantiation and
+// the entries inline into them as direct calls. The callers used to hoist a
+// table lookup and pay an indirect call per 128/32-value chunk; now the
+// whole stream costs the one indirect jump of the switch below.
+template <unsigned B>
+const unsigned char * bitunpackAvx2StreamImpl(const unsigned char * in, uint32_t * out, unsigned num)
 {
     __m256i sv = _mm256_setzero_si256();
-    return bitunpack_ex_table_256v[b](in, out, sv, bitmap, pex);
+
+    while (num >= 128u)
+    {
+        in = bitunpack_avx2_entry<B, 128, false, false>(in, out, sv, nullptr, nullptr);
+        out += 128;
+        num -= 128u;
+    }
+
+    while (num >= 32u)
+    {
+        in = bitunpack_avx2_entry<B, 32, false, false>(in, out, sv, nullptr, nullptr);
+        out += 32;
+        num -= 32u;
+    }
+
+    if (num > 0u)
+        in = scalar::detail::bitunpack32Scalar(in, num, out, B);
+
+    return in;
+}
+
+} // namespace
+
+const unsigned char * bitunpackAvx2Stream(const unsigned char * in, uint32_t * out, unsigned num, unsigned b)
+{
+    GEN_SWITCH_AVX2(bitunpackAvx2StreamImpl, in, out, num);
 }
 
 } // namespace turbopfor::simd::detail
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <immintrin.h>
 #include "p4_simd_internal_256v.h"
@@ -7,103 +8,27 @@
 namespace turbopfor::simd::detail
 {
 
-// Extern the shuffle table (defined in bitunpack128v32_simd.cpp or similar)
-// We need it here. If not available, we define it.
-// To avoid linker errors, we can use a static const in header or weak symbol.
-// Or just replicate it as a static member.
-alignas(16) static const char _shuffle_avx2[16][16] = {
-    {(char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff},
-    {0,
-     1,
-     2,
-     3,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff},
-    {(char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     0,
-     1,
-     2,
-     3,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff},
-    {0, 1, 2, 3, 4, 5, 6, 7, (char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff},
-    {(char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     0,
-     1,
-     2,
-     3,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff},
-    {0, 1, 2, 3, (char)0xff, (char)0xff, (char)0xff, (char)0xff, 4, 5, 6, 7, (char)0xff, (char)0xff, (char)0xff, (char)0xff},
-    {(char)0xff, (char)0xff, (char)0xff, (char)0xff, 0, 1, 2, 3, 4, 5, 6, 7, (char)0xff, (char)0xff, (char)0xff, (char)0xff},
-    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, (char)0xff, (char)0xff, (char)0xff, (char)0xff},
-    {(char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     (char)0xff,
-     0,
-     1,
-     2,
-     3},
-    {0, 1, 2, 3, (char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff, 4, 5, 6, 7},
-    {(char)0xff, (char)0xff, (char)0xff, (char)0xff, 0, 1, 2, 3, (char)0xff, (char)0xff, (char)0xff, (char)0xff, 4, 5, 6, 7},
-    {0, 1, 2, 3, 4, 5, 6, 7, (char)0xff, (char)0xff, (char)0xff, (char)0xff, 8, 9, 10, 11},
-    {(char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff, (char)0xff, 0, 1, 2, 3, 4, 5, 6, 7},
-    {0, 1, 2, 3, (char)0xff, (char)0xff, (char)0xff, (char)0xff, 4, 5, 6, 7, 8, 9, 10, 11},
-    {(char)0xff, (char)0xff, (char)0xff, (char)0xff, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11},
-    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
-};
+
+// 256-entry expand LUT for the patching path: entry m maps each dword lane to
+// the index (prefix popcount order) of the packed exception that patches it.
+// Lanes whose bitmap bit is clear read source 0 and are zeroed afterwards by
+// the bit-select compare in UnpackStep.
+static constexpr std::array<std::array<uint32_t, 8>, 256> makeExpandLut32()
+{
+    std::array<std::array<uint32_t, 8>, 256> lut{};
+    for (unsigned m = 0; m < 256u; ++m)
+    {
+        unsigned k = 0;
+        for (unsigned lane = 0; lane < 8u; ++lane)
+            lut[m][lane] = ((m >> lane) & 1u) ? k++ : 0u;
+    }
+    return lut;
+}
+
+// An inline variable, so the linker folds the per-TU copies of this 8 KB
+// table into one .rodata instance instead of duplicating it in every decoder
+// TU that includes the templates.
+alignas(32) inline constexpr auto expand_lut32 = makeExpandLut32();
 
 template <unsigned B>
 struct MaskGen
@@ -120,15 +45,20 @@ struct MaskGen<32>
 template <unsigned B, unsigned G, unsigned MaxG, int CurrentLoadedIdx, bool Delta, bool Patching>
 struct UnpackStep
 {
+    // mask and cv go by value: they are loop-invariant, and a reference would
+    // give them an address, which is all GCC needs to spill them to the stack
+    // and re-broadcast per group once the inlined chain runs out of registers
+    // at high B. By value they stay plain YMM temporaries the whole way down.
     static ALWAYS_INLINE void
     run(const __m256i *& ip,
         __m256i & iv,
         uint32_t * out,
-        const __m256i & mask,
-        const __m256i & cv,
+        const __m256i mask,
+        const __m256i cv,
         __m256i & sv,
-        const uint64_t * bitmap,
-        const uint32_t *& pex)
+        const __m256i bitmap_vec,
+        const uint32_t * pex,
+        const uint8_t * prefix)
     {
         constexpr int TargetIdx = (G * B) / 32;
         constexpr int Offset = (G * B) % 32;
@@ -167,70 +97,29 @@ struct UnpackStep
 
         if (Patching)
         {
-            // Bitmap access for 256v (4 x 64-bit words)
-            // G goes 0..31. Each G produces 8 values (256 bits).
-            // But 'bitmap' is array of uint64_t.
-            // Values 0..63 are in bitmap[0].
-            // G=0 -> values 0..7. G=7 -> values 56..63.
-            // G=8 -> values 64..71 (bitmap[1]).
-
-            constexpr int WordIdx = G / 8;
-            constexpr int Shift = (G % 8) * 8;
-
-            // We need 8 bits for the current 8 values.
-            uint64_t w = bitmap[WordIdx];
-            unsigned m = (w >> Shift) & 0xFF; // 8 bits
-
-            // Unconditional patching
-            // Split into low 4 (for low 128 lane) and high 4 (for high 128 lane)
-            unsigned m_low = m & 0xF;
-            unsigned m_high = m >> 4;
-
-            // Low Lane
-            {
-                __m128i v_low = _mm256_extracti128_si256(ov, 0);
-                __m128i exc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pex));
-                __m128i exc_s = _mm_slli_epi32(exc, B);
-                __m128i p_mask = _mm_load_si128(reinterpret_cast<const __m128i *>(_shuffle_avx2[m_low]));
-                __m128i p = _mm_shuffle_epi8(exc_s, p_mask);
-                v_low = _mm_add_epi32(v_low, p);
-                ov = _mm256_inserti128_si256(ov, v_low, 0);
-
-#if defined(__GNUC__) || defined(__clang__)
-                pex += __builtin_popcount(m_low);
-#else
-                unsigned c = 0, tm = m_low;
-                while (tm)
-                {
-                    tm &= tm - 1;
-                    c++;
-                }
-                pex += c;
-#endif
-            }
-
-            // High Lane
-            {
-                __m128i v_high = _mm256_extracti128_si256(ov, 1);
-                __m128i exc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pex));
-                __m128i exc_s = _mm_slli_epi32(exc, B);
-                __m128i p_mask = _mm_load_si128(reinterpret_cast<const __m128i *>(_shuffle_avx2[m_high]));
-                __m128i p = _mm_shuffle_epi8(exc_s, p_mask);
-                v_high = _mm_add_epi32(v_high, p);
-                ov = _mm256_inserti128_si256(ov, v_high, 1);
-
-#if defined(__GNUC__) || defined(__clang__)
-                pex += __builtin_popcount(m_high);
-#else
-                unsigned c = 0, tm = m_high;
-                while (tm)
-                {
-                    tm &= tm - 1;
-                    c++;
-                }
-                pex += c;
-#endif
-            }
+            // The whole 256-bit bitmap rides along in a vector register; each
+            // group's 8 bits are one byte of it, pulled out with a
+            // compile-time-indexed extract instead of a word reload per group.
+            const unsigned m = static_cast<unsigned>(_mm256_extract_epi8(bitmap_vec, G)) & 0xFFu;
+
+            // This group's exceptions start at the number of bitmap bits set
+            // before it, read from the prefix-popcount array the entry built:
+            // no serial pex advance chains the unrolled steps, so all patch
+            // loads can issue independently.
+            const uint32_t * pg = pex + prefix[G];
+
+            // Full-width expand: one VPERMD through the 256-entry LUT routes
+            // the next popcount(m) packed exceptions into their lanes, and a
+            // bit-select compare zeroes the lanes whose bitmap bit is clear —
+            // no 128-bit extract/shuffle/insert round trip per half. The
+            // 32-byte load may read past the remaining exceptions; every pex
+            // buffer carries MAX_VALUES + 64 entries, which covers it.
+            const __m256i bit_sel = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+            const __m256i exc = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pg));
+            const __m256i exc_s = _mm256_slli_epi32(exc, B);
+            const __m256i shuf = _mm256_load_si256(reinterpret_cast<const __m256i *>(expand_lut32[m].data()));
+            const __m256i keep = _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(static_cast<int>(m)), bit_sel), bit_sel);
+            ov = _mm256_add_epi32(ov, _mm256_and_si256(_mm256_permutevar8x32_epi32(exc_s, shuf), keep));
         }
 
         if (Delta)
@@ -244,7 +133,7 @@ struct UnpackStep
         }
 
         constexpr int NextLoadedIdx = Spans ? TargetIdx + 1 : TargetIdx;
-        UnpackStep<B, G + 1, MaxG, NextLoadedIdx, Delta, Patching>::run(ip, iv, out, mask, cv, sv, bitmap, pex);
+        UnpackStep<B, G + 1, MaxG, NextLoadedIdx, Delta, Patching>::run(ip, iv, out, mask, cv, sv, bitmap_vec, pex, prefix);
     }
 };
 
@@ -252,8 +141,16 @@ struct UnpackStep
 template <unsigned B, unsigned MaxG, int CurrentLoadedIdx, bool Delta, bool Patching>
 struct UnpackStep<B, MaxG, MaxG, CurrentLoadedIdx, Delta, Patching>
 {
-    static ALWAYS_INLINE void
-    run(const __m256i *&, __m256i &, uint32_t *, const __m256i &, const __m256i &, __m256i &, const uint64_t *, const uint32_t *&)
+    static ALWAYS_INLINE void run(
+        const __m256i *&,
+        __m256i &,
+        uint32_t *,
+        const __m256i,
+        const __m256i,
+        __m256i &,
+        const __m256i,
+        const uint32_t *,
+        const uint8_t *)
     {
     }
 };
@@ -308,7 +205,28 @@ bitunpack_avx2_entry(const unsigned char * in, uint32_t * out, __m256i & sv, con
 
     const __m256i cv = Delta ? _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8) : _mm256_setzero_si256();
 
-    UnpackStep<B, 0, MaxG, -1, Delta, Patching>::run(ip, iv, out, mask, cv, sv, bitmap, pex);
+    // Per-group prefix popcounts of the bitmap, materialized once: each step
+    // reads its pex offset from one byte instead of recomputing it, and no
+    // serial pointer advance threads the unrolled steps. Fits one cache line
+    // (at most 248 exceptions precede the last group, so uint8_t holds it).
+    uint8_t prefix[MaxG];
+    // The 256-bit bitmap is loaded into a register once here; the steps pull
+    // their bytes out with compile-time-indexed extracts instead of reloading
+    // a word per group. Patching entries always cover 256 values.
+    __m256i bitmap_vec = _mm256_setzero_si256();
+    if (Patching)
+    {
+        static_assert(!Patching || MaxG <= 32, "bitmap register holds 32 group bytes");
+        bitmap_vec = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bitmap));
+        unsigned acc = 0;
+        for (unsigned g = 0; g < MaxG; ++g)
+        {
+            prefix[g] = static_cast<uint8_t>(acc);
+            acc += scalar::detail::popcount64((bitmap[g / 8u] >> ((g % 8u) * 8u)) & 0xFFu);
+        }
+    }
+
+    UnpackStep<B, 0, MaxG, -1, Delta, Patching>::run(ip, iv, out, mask, cv, sv, bitmap_vec, pex, prefix);
     return reinterpret_cast<const unsigned char *>(ip);
 }
 
@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <immintrin.h>
+#include "scalar/p4_scalar_internal.h" // popcount64 for the patching path
 
 #ifndef ALWAYS_INLINE
 #    if defined(_MSC_VER)
@@ -23,7 +24,9 @@ namespace turbopfor::simd::detail
 // Result: [E0, 0, E1, 0]
 // Shuffle: 0, 0xFF, 1, 0xFF... (bytes)
 // This table is standard TurboPFor _shuffle_128.
-alignas(16) static const char _shuffle_128_table[16][16] = {
+// An inline variable, so the linker folds the copies from every TU that
+// includes this header into one .rodata instance (as block_size_table does).
+alignas(16) inline const char _shuffle_128_table[16][16] = {
     {(char)0xff,
      (char)0xff,
      (char)0xff,
@@ -118,6 +121,30 @@ alignas(16) static const char _shuffle_128_table[16][16] = {
 };
 
 
+#if defined(__x86_64__) && defined(__BMI2__)
+
+/// Shuffle control for the patch scatter, computed with PDEP instead of loaded
+/// from _shuffle_128_table: per 64-bit half, the nibble's lane bits expand to
+/// full dword byte-masks, PDEP deposits consecutive identity bytes into the
+/// selected lanes (so lane i reads packed exception prefix-popcount(i)), and
+/// the unselected bytes get the PSHUFB zeroing bit. The high half's identity
+/// starts past the bytes the low half consumed. Saves the table-indexed
+/// cache-line load per patched group; the table remains the non-BMI2 path.
+ALWAYS_INLINE __m128i patchShuffleControl(unsigned m)
+{
+    constexpr uint64_t lane_bits = 0x0000000100000001ull;
+    constexpr uint64_t identity = 0x0706050403020100ull;
+    constexpr uint64_t zeroing = 0x8080808080808080ull;
+
+    const uint64_t em_lo = _pdep_u64(m, lane_bits) * 0xFFFFFFFFull;
+    const uint64_t em_hi = _pdep_u64(m >> 2, lane_bits) * 0xFFFFFFFFull;
+    const uint64_t lo = _pdep_u64(identity, em_lo) | (~em_lo & zeroing);
+    const uint64_t hi = _pdep_u64(identity + 0x0404040404040404ull * scalar::detail::popcount64(m & 3u), em_hi) | (~em_hi & zeroing);
+    return _mm_set_epi64x(static_cast<long long>(hi), static_cast<long long>(lo));
+}
+
+#endif
+
 template <unsigned B>
 struct MaskGenSSE
 {
@@ -140,8 +167,9 @@ struct UnpackStepSSE
         const __m128i & mask,
         const __m128i & cv,
         __m128i & sv,
-        const uint64_t * bitmap,
-        const uint32_t *& pex)
+        const __m128i bitmap_vec,
+        const uint32_t * pex,
+        const uint8_t * prefix)
     {
         constexpr int TargetIdx = (G * B) / 32;
         constexpr int Offset = (G * B) % 32;
@@ -179,38 +207,34 @@ struct UnpackStepSSE
 
         if (Patching)
         {
-            // Bitmap access for 128v (2 x 64-bit words)
-            // G goes 0..31.
-            uint64_t w = (G < 16) ? bitmap[0] : bitmap[1];
-            unsigned shift = (G % 16) * 4;
-            unsigned m = (w >> shift) & 0xF;
+            // The whole 128-bit bitmap rides along in a vector register; a
+            // PEXTRB with a compile-time index pulls this group's byte out
+            // without touching memory, and the nibble select folds into the
+            // surrounding constants.
+            constexpr int ByteIdx = G / 2;
+            const unsigned byte = static_cast<unsigned>(_mm_extract_epi8(bitmap_vec, ByteIdx));
+            const unsigned m = (G & 1) ? (byte >> 4) : (byte & 0xFu);
+
+            // This group's exceptions start at the number of bitmap bits set
+            // before it, read from the prefix-popcount array the entry built:
+            // no serial pex advance chains the unrolled steps, so all patch
+            // loads can issue independently.
+            const uint32_t * pg = pex + prefix[G];
 
             // Always execute patching logic to avoid branch misprediction
             // For sparse exceptions, this adds overhead. For dense, it helps.
             // Since we only call this when exceptions exist, and misprediction is costly...
-            // Let's test unconditional execution.
-            // if (m) {
-            __m128i exc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pex));
+            __m128i exc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pg));
             __m128i exc_s = _mm_slli_epi32(exc, B);
 
+#if defined(__x86_64__) && defined(__BMI2__)
+            __m128i p_mask = patchShuffleControl(m);
+#else
             __m128i p_mask = _mm_load_si128(reinterpret_cast<const __m128i *>(_shuffle_128_table[m]));
+#endif
 
             __m128i p = _mm_shuffle_epi8(exc_s, p_mask);
             ov = _mm_add_epi32(ov, p);
-
-#if defined(__GNUC__) || defined(__clang__)
-            pex += __builtin_popcount(m);
-#else
-            unsigned c = 0;
-            unsigned tm = m;
-            while (tm)
-            {
-                tm &= tm - 1;
-                c++;
-            }
-            pex += c;
-#endif
-            // }
         }
 
         if (Delta)
@@ -224,9 +248,10 @@ struct UnpackStepSSE
 
             _mm_storeu_si128(reinterpret_cast<__m128i *>(out + G * 4), ov);
 
-            // Update sv (carry)
-            int last = _mm_cvtsi128_si32(_mm_shuffle_epi32(ov, 0xFF));
-            sv = _mm_set1_epi32(last);
+            // Update sv (carry): broadcast the last lane in-vector, as the
+            // other delta variants below do — going through a GPR and back
+            // with cvtsi128/set1 pays a cross-domain penalty per group.
+            sv = _mm_shuffle_epi32(ov, 0xFF);
         }
         else
         {
@@ -234,7 +259,7 @@ struct UnpackStepSSE
         }
 
         constexpr int NextLoadedIdx = Spans ? TargetIdx + 1 : TargetIdx;
-        UnpackStepSSE<B, G + 1, MaxG, NextLoadedIdx, Delta, Patching>::run(ip, iv, out, mask, cv, sv, bitmap, pex);
+        UnpackStepSSE<B, G + 1, MaxG, NextLoadedIdx, Delta, Patching>::run(ip, iv, out, mask, cv, sv, bitmap_vec, pex, prefix);
     }
 };
 
@@ -242,8 +267,16 @@ struct UnpackStepSSE
 template <unsigned B, unsigned MaxG, int CurrentLoadedIdx, bool Delta, bool Patching>
 struct UnpackStepSSE<B, MaxG, MaxG, CurrentLoadedIdx, Delta, Patching>
 {
-    static ALWAYS_INLINE void
-    run(const __m128i *&, __m128i &, uint32_t *, const __m128i &, const __m128i &, __m128i &, const uint64_t *, const uint32_t *&)
+    static ALWAYS_INLINE void run(
+        const __m128i *&,
+        __m128i &,
+        uint32_t *,
+        const __m128i &,
+        const __m128i &,
+        __m128i &,
+        const __m128i,
+        const uint32_t *,
+        const uint8_t *)
     {
     }
 };
@@ -297,7 +330,25 @@ bitunpack_sse_entry(const unsigned char * in, uint32_t * out, __m128i & sv, cons
     // cv for Delta (1,2,3,4)
     const __m128i cv = Delta ? _mm_setr_epi32(1, 2, 3, 4) : _mm_setzero_si128();
 
-    UnpackStepSSE<B, 0, MaxG, -1, Delta, Patching>::run(ip, iv, out, mask, cv, sv, bitmap, pex);
+    // Per-group prefix popcounts of the bitmap, materialized once: each step
+    // reads its pex offset from one byte instead of recomputing it, and no
+    // serial pointer advance threads the unrolled steps. Fits one cache line.
+    uint8_t prefix[MaxG];
+    // The 128-bit bitmap is loaded into a register once here; the steps pull
+    // their nibbles out with PEXTRB instead of reloading a word per group.
+    __m128i bitmap_vec = _mm_setzero_si128();
+    if (Patching)
+    {
+        bitmap_vec = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bitmap));
+        unsigned acc = 0;
+        for (unsigned g = 0; g < MaxG; ++g)
+        {
+            prefix[g] = static_cast<uint8_t>(acc);
+            acc += scalar::detail::popcount64((bitmap[g / 16u] >> ((g % 16u) * 4u)) & 0xFu);
+        }
+    }
+
+    UnpackStepSSE<B, 0, MaxG, -1, Delta, Patching>::run(ip, iv, out, mask, cv, sv, bitmap_vec, pex, prefix);
 
     return reinterpret_cast<const unsigned char *>(ip);
 }
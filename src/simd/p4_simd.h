@@ -19,6 +19,12 @@ const unsigned char * p4Dec128v32(const unsigned char * in, unsigned n, uint32_t
 /// P4 decoding with delta1 (128-element vertical bitpacking format)
 const unsigned char * p4D1Dec128v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start);
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+/// VEX-encoded variant of p4D1Dec128v32 for the load-time dispatcher; a plain
+/// named symbol so the dispatch resolver can take its address safely
+const unsigned char * p4D1Dec128v32Avx2(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start);
+#endif
+
 /// P4 encoding (256-element vertical bitpacking format, AVX2)
 unsigned char * p4Enc256v32(uint32_t * in, unsigned n, unsigned char * out);
 unsigned char * p4D1Enc256v32(uint32_t * in, unsigned n, unsigned char * out, uint32_t start);
@@ -6,6 +6,11 @@
 
 #include <smmintrin.h> // SSE4.1
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    include <immintrin.h>
+#    define TURBOPFOR_APPLYDELTA1_AVX2 1
+#endif
+
 namespace turbopfor::simd::detail
 {
 
@@ -34,7 +39,7 @@ void writeHeader64(unsigned char *& out, unsigned b, unsigned bx)
     scalar::detail::writeHeader64(out, b, bx);
 }
 
-__attribute__((noinline)) void applyDelta1(uint32_t * out, unsigned n, uint32_t start)
+__attribute__((noinline)) static void applyDelta1Portable(uint32_t * out, unsigned n, uint32_t start)
 {
     if (n == 0u)
         return;
@@ -89,6 +94,80 @@ __attribute__((noinline)) void applyDelta1(uint32_t * out, unsigned n, uint32_t
     }
 }
 
+#ifdef TURBOPFOR_APPLYDELTA1_AVX2
+
+/// AVX2 variant: 8 lanes per iteration with the scan mm256_scan_epi32 uses
+/// (in-lane Hillis-Steele, then VPERMD broadcasts carrying the low lane's
+/// total into the high lane and the previous vector's last element into
+/// both). The pattern is repeated here rather than shared because this TU
+/// builds without -mavx2, so the always_inline helper cannot be instantiated
+/// outside a target("avx2") body.
+__attribute__((target("avx2"), noinline)) static void applyDelta1Avx2(uint32_t * out, unsigned n, uint32_t start)
+{
+    __m256i * op = reinterpret_cast<__m256i *>(out);
+    const __m256i ones = _mm256_set1_epi32(1);
+    const __m256i idx3 = _mm256_set1_epi32(3);
+    const __m256i idx7 = _mm256_set1_epi32(7);
+    __m256i sv = _mm256_set1_epi32(static_cast<int>(start));
+
+    const unsigned vec_count = n / 8u;
+    for (unsigned i = 0; i < vec_count; ++i)
+    {
+        __m256i v = _mm256_add_epi32(_mm256_loadu_si256(op + i), ones);
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+        sv = _mm256_add_epi32(
+            _mm256_permutevar8x32_epi32(sv, idx7),
+            _mm256_add_epi32(
+                v, _mm256_blend_epi32(_mm256_setzero_si256(), _mm256_permutevar8x32_epi32(v, idx3), 0xF0)));
+        _mm256_storeu_si256(op + i, sv);
+    }
+
+    // Remainder: run the same scan once more behind a VPMASKMOVD load/store
+    // pair instead of peeling a scalar loop off the register carry. Lane j of
+    // the prefix sum only reads lanes 0..j, all live when j < rem, so the
+    // inactive lanes' garbage never reaches a stored lane.
+    const unsigned rem = n - vec_count * 8u;
+    if (rem > 0u)
+    {
+        const __m256i tail_mask
+            = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(rem)), _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+        __m256i v = _mm256_add_epi32(_mm256_maskload_epi32(reinterpret_cast<const int *>(out) + vec_count * 8u, tail_mask), ones);
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+        v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+        sv = _mm256_add_epi32(
+            _mm256_permutevar8x32_epi32(sv, idx7),
+            _mm256_add_epi32(
+                v, _mm256_blend_epi32(_mm256_setzero_si256(), _mm256_permutevar8x32_epi32(v, idx3), 0xF0)));
+        _mm256_maskstore_epi32(reinterpret_cast<int *>(out) + vec_count * 8u, tail_mask, sv);
+    }
+}
+
+#endif
+
+#if defined(TURBOPFOR_APPLYDELTA1_AVX2) && defined(__ELF__)
+
+// IFUNC resolver, as in the pack/unpack tiers: one load-time selection, no
+// per-call CPUID check.
+extern "C" void * turbopforResolveApplyDelta1()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return reinterpret_cast<void *>(&applyDelta1Avx2);
+    return reinterpret_cast<void *>(&applyDelta1Portable);
+}
+
+void applyDelta1(uint32_t * out, unsigned n, uint32_t start) __attribute__((ifunc("turbopforResolveApplyDelta1")));
+
+#else
+
+void applyDelta1(uint32_t * out, unsigned n, uint32_t start)
+{
+    applyDelta1Portable(out, n, start);
+}
+
+#endif
+
 __attribute__((noinline)) void applyDelta1_64(uint64_t * out, unsigned n, uint64_t start)
 {
     uint64_t * ip = out;
@@ -40,10 +40,12 @@ namespace turbopfor::simd::detail
 {
 
 // Import constants and utilities from scalar namespace
+using scalar::detail::applyDelta1Constant;
+using scalar::detail::applyDelta1Constant64;
 using scalar::detail::bitWidth32;
 using scalar::detail::bitWidth64;
-using scalar::detail::bsr32;
-using scalar::detail::bsr64;
+using scalar::detail::expandBitmapIndices;
+using scalar::detail::loadBitmap;
 using scalar::detail::loadU32;
 using scalar::detail::loadU64;
 using scalar::detail::loadU64Fast;
@@ -53,11 +55,17 @@ using scalar::detail::MAX_BITS;
 using scalar::detail::MAX_BITS_64;
 using scalar::detail::MAX_VALUES;
 using scalar::detail::pad8;
+using scalar::detail::patchExceptions;
+using scalar::detail::popcountBitmap;
 using scalar::detail::storeU32;
 using scalar::detail::storeU64Fast;
 
 /// SSE4.1 128v vertical bitpacking (4-lane interleaved, 128 elements)
 unsigned char * bitpack128v32(const uint32_t * in, unsigned char * out, unsigned b);
+/// Same, but the caller guarantees every value already fits in b bits (e.g. a
+/// base[] array the exception scan masked, or a block whose b came from the
+/// bit-width histogram) — skips the per-group mask AND.
+unsigned char * bitpack128v32NoMask(const uint32_t * in, unsigned char * out, unsigned b);
 const unsigned char * bitunpack128v32(const unsigned char * in, uint32_t * out, unsigned b);
 
 /// SSE4.1 128v vertical bitunpacking with delta1 decode (fused operation)
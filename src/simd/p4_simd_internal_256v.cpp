@@ -6,6 +6,10 @@
 
 #include <immintrin.h> // AVX2
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    define TURBOPFOR_APPLYDELTA1_256V_AVX512 1
+#endif
+
 namespace turbopfor::simd::detail
 {
 
@@ -29,7 +33,7 @@ void writeHeader_256v(unsigned char *& out, unsigned b, unsigned bx)
     scalar::detail::writeHeader(out, b, bx);
 }
 
-void applyDelta1_256v(uint32_t * out, unsigned n, uint32_t start)
+static void applyDelta1_256vAvx2(uint32_t * out, unsigned n, uint32_t start)
 {
     if (n == 0u)
         return;
@@ -48,13 +52,109 @@ void applyDelta1_256v(uint32_t * out, unsigned n, uint32_t start)
         _mm256_storeu_si256(op + i, vs);
     }
 
-    // Handle remaining elements
-    start = static_cast<uint32_t>(_mm256_extract_epi32(vs, 7));
-    for (unsigned j = vec_count * 8u; j < n; ++j)
+    // Remainder: one masked scan iteration instead of a scalar loop. Lane j of
+    // the prefix sum only reads lanes 0..j, which are all live when j < rem,
+    // so the garbage the inactive lanes carry never reaches a stored lane.
+    const unsigned rem = n - vec_count * 8u;
+    if (rem > 0u)
     {
-        start += out[j] + 1u;
-        out[j] = start;
+        const __m256i tail_mask
+            = _mm256_cmpgt_epi32(_mm256_set1_epi32(static_cast<int>(rem)), _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+        __m256i v = _mm256_maskload_epi32(reinterpret_cast<const int *>(out) + vec_count * 8u, tail_mask);
+        vs = mm256_scani_epi32(v, vs, cv);
+        _mm256_maskstore_epi32(reinterpret_cast<int *>(out) + vec_count * 8u, tail_mask, vs);
     }
 }
 
+#ifdef TURBOPFOR_APPLYDELTA1_256V_AVX512
+
+/// AVX-512 tier: 16 lanes per iteration. The Hillis-Steele shifts become
+/// full-width VALIGND against zero, so the scan crosses all 16 lanes in four
+/// dependent adds, and one VPERMD broadcast of lane 15 carries the previous
+/// vector — half as many carry broadcasts per element as the 8-lane form.
+/// The write mask makes the tail one more masked iteration of the same body.
+/// (The fused bitd1unpack256v32 scan keeps the AVX2 pattern: the unpack
+/// templates produce one 8-lane group per step, so a 16-lane scan would have
+/// to buffer pairs of groups and re-serialize on the same carry.)
+__attribute__((target("avx512f"))) static void applyDelta1_256vAvx512(uint32_t * out, unsigned n, uint32_t start)
+{
+    const __m512i ones = _mm512_set1_epi32(1);
+    const __m512i zero = _mm512_setzero_si512();
+    const __m512i idx15 = _mm512_set1_epi32(15);
+    __m512i sv = _mm512_set1_epi32(static_cast<int>(start));
+
+    const unsigned vec_count = n / 16u;
+    for (unsigned i = 0; i < vec_count; ++i)
+    {
+        __m512i v = _mm512_add_epi32(_mm512_loadu_si512(out + i * 16u), ones);
+        v = _mm512_add_epi32(v, _mm512_alignr_epi32(v, zero, 15));
+        v = _mm512_add_epi32(v, _mm512_alignr_epi32(v, zero, 14));
+        v = _mm512_add_epi32(v, _mm512_alignr_epi32(v, zero, 12));
+        v = _mm512_add_epi32(v, _mm512_alignr_epi32(v, zero, 8));
+        sv = _mm512_add_epi32(v, _mm512_permutexvar_epi32(idx15, sv));
+        _mm512_storeu_si512(out + i * 16u, sv);
+    }
+
+    const unsigned rem = n - vec_count * 16u;
+    if (rem > 0u)
+    {
+        const __mmask16 k = static_cast<__mmask16>((1u << rem) - 1u);
+        __m512i v = _mm512_add_epi32(_mm512_maskz_loadu_epi32(k, out + vec_count * 16u), ones);
+        v = _mm512_add_epi32(v, _mm512_alignr_epi32(v, zero, 15));
+        v = _mm512_add_epi32(v, _mm512_alignr_epi32(v, zero, 14));
+        v = _mm512_add_epi32(v, _mm512_alignr_epi32(v, zero, 12));
+        v = _mm512_add_epi32(v, _mm512_alignr_epi32(v, zero, 8));
+        sv = _mm512_add_epi32(v, _mm512_permutexvar_epi32(idx15, sv));
+        _mm512_mask_storeu_epi32(out + vec_count * 16u, k, sv);
+    }
+}
+
+#endif
+
+#if defined(TURBOPFOR_APPLYDELTA1_256V_AVX512) && defined(__ELF__)
+
+// IFUNC resolver, as in the other tiers: one load-time selection, no
+// per-call CPUID check.
+extern "C" void * turbopforResolveApplyDelta1256v()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return reinterpret_cast<void *>(&applyDelta1_256vAvx512);
+    return reinterpret_cast<void *>(&applyDelta1_256vAvx2);
+}
+
+void applyDelta1_256v(uint32_t * out, unsigned n, uint32_t start) __attribute__((ifunc("turbopforResolveApplyDelta1256v")));
+
+#else
+
+void applyDelta1_256v(uint32_t * out, unsigned n, uint32_t start)
+{
+    applyDelta1_256vAvx2(out, n, start);
+}
+
+#endif
+
+void applyDelta1Constant_256v(uint32_t * out, unsigned n, uint32_t start, uint32_t value)
+{
+    // Constant block: the prefix sum collapses to the arithmetic progression
+    // out[i] = start + (value + 1) * (i + 1), so there is no fill pass and no
+    // loop-carried chain — one vector add per 8 stores.
+    const uint32_t step = value + 1u;
+    const __m256i step_vec = _mm256_set1_epi32(static_cast<int>(step));
+    __m256i cur = _mm256_add_epi32(
+        _mm256_set1_epi32(static_cast<int>(start)), _mm256_mullo_epi32(_mm256_set_epi32(8, 7, 6, 5, 4, 3, 2, 1), step_vec));
+    const __m256i inc = _mm256_set1_epi32(static_cast<int>(8u * step));
+
+    unsigned i = 0;
+    for (; i + 8u <= n; i += 8u)
+    {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), cur);
+        cur = _mm256_add_epi32(cur, inc);
+    }
+
+    uint32_t acc = start + step * i;
+    for (; i < n; ++i)
+        out[i] = (acc += step);
+}
+
 } // namespace turbopfor::simd::detail
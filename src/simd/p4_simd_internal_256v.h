@@ -27,7 +27,7 @@ namespace turbopfor::simd::detail
 
 // Import constants and utilities from scalar namespace
 using scalar::detail::bitWidth32;
-using scalar::detail::bsr32;
+using scalar::detail::loadBitmap;
 using scalar::detail::loadU32;
 using scalar::detail::loadU64;
 using scalar::detail::maskBits;
@@ -35,6 +35,7 @@ using scalar::detail::MAX_BITS;
 using scalar::detail::MAX_VALUES;
 using scalar::detail::pad8;
 using scalar::detail::storeU32;
+using scalar::detail::storeU64Fast;
 
 /// AVX2 256v vertical bitpacking (8-lane interleaved, 256 elements)
 unsigned char * bitpack256v32(const uint32_t * in, unsigned char * out, unsigned b);
@@ -51,6 +52,13 @@ bitd1unpack256v32_ex(const unsigned char * in, uint32_t * out, unsigned b, uint3
 const unsigned char *
 bitunpack256v32_ex(const unsigned char * in, uint32_t * out, unsigned b, const uint64_t * bitmap, const uint32_t *& pex);
 
+/// Plain (no delta, no patch) unpack of a whole exception stream: num values
+/// at b bits, consumed in 128- then 32-element AVX2 chunks with a scalar
+/// tail. b is dispatched once per stream; the chunk loops inside run with
+/// direct calls, so no per-chunk indirect call remains. Defined in
+/// bitunpack256v32_simd.cpp so the 33 instantiations live in a single TU.
+const unsigned char * bitunpackAvx2Stream(const unsigned char * in, uint32_t * out, unsigned num, unsigned b);
+
 /// Variable-byte encoding/decoding (reuse from scalar - not SIMD critical path)
 unsigned char * vbEnc32_256v(const uint32_t * in, unsigned n, unsigned char * out);
 const unsigned char * vbDec32_256v(const unsigned char * in, unsigned n, uint32_t * out);
@@ -65,6 +73,10 @@ void writeHeader_256v(unsigned char *& out, unsigned b, unsigned bx);
 /// NOT inlined to match TurboPFor's bitd1dec32 structure - improves icache behavior
 void applyDelta1_256v(uint32_t * out, unsigned n, uint32_t start);
 
+/// Delta1-decode a constant block as the closed-form arithmetic progression
+/// out[i] = start + (value + 1) * (i + 1) — replaces the fill + prefix-sum pair
+void applyDelta1Constant_256v(uint32_t * out, unsigned n, uint32_t start, uint32_t value);
+
 // Exact copy of TurboPFor's MM256_HDEC_EPI32 pattern - this is the key optimization!
 // mm256_scan_epi32: AVX2 inclusive prefix sum (scan)
 // Input: v = [a, b, c, d, e, f, g, h], sv = previous vector (we use sv[7] as carry)
@@ -77,21 +89,16 @@ ALWAYS_INLINE __m256i mm256_scan_epi32(__m256i v, __m256i sv)
     v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
     // Now: v = [a, a+b, a+b+c, a+b+c+d, e, e+f, e+f+g, e+f+g+h]
 
-    // Cross-lane carry propagation (TurboPFor's MM256_HDEC_EPI32 pattern)
-    // This is the magic: we need to add sv[7] to all elements AND v[3] to upper lane
-    //
-    // permute2x128(shuffle(sv, 0xFF), sv, 0x11):
-    //   shuffle(sv, 0xFF) = [sv[3],sv[3],sv[3],sv[3], sv[7],sv[7],sv[7],sv[7]]
-    //   permute2x128(..., sv, 0x11) selects [high(sv),high(sv)] = [sv[7] broadcast, sv[7] broadcast]
-    //
-    // permute2x128(zero, shuffle(v, 0xFF), 0x20):
-    //   shuffle(v, 0xFF) = [v[3],v[3],v[3],v[3], v[7],v[7],v[7],v[7]]
-    //   permute2x128(zero, ..., 0x20) selects [zero, low(...)] = [0,0,0,0, v[3],v[3],v[3],v[3]]
-    //
-    // Final: sv_broadcast + (v + lane_sum)
-    return _mm256_add_epi32(
-        _mm256_permute2x128_si256(_mm256_shuffle_epi32(sv, _MM_SHUFFLE(3, 3, 3, 3)), sv, 0x11),
-        _mm256_add_epi32(v, _mm256_permute2x128_si256(_mm256_setzero_si256(), _mm256_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3)), 0x20)));
+    // Cross-lane carry propagation: add sv[7] to all elements AND v[3] to the
+    // upper lane. TurboPFor's MM256_HDEC_EPI32 builds each broadcast from a
+    // shuffle + permute2x128 pair; a single VPERMD produces it in one shuffle
+    // uop, and the upper-lane select becomes a VPBLENDD, which runs on the
+    // plain ALU ports instead of the shuffle port — 4 shuffle-port uops per
+    // scan instead of 6, on the loop's critical carry path.
+    const __m256i carry = _mm256_permutevar8x32_epi32(sv, _mm256_set1_epi32(7));
+    const __m256i lane_sum
+        = _mm256_blend_epi32(_mm256_setzero_si256(), _mm256_permutevar8x32_epi32(v, _mm256_set1_epi32(3)), 0xF0);
+    return _mm256_add_epi32(carry, _mm256_add_epi32(v, lane_sum));
 }
 
 // mm256_scani_epi32: scan + add increment vector (for delta1: adds 1,2,3,4,5,6,7,8)
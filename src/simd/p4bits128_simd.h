@@ -20,11 +20,20 @@ inline unsigned p4Bits128(const uint32_t * in, unsigned * pbx)
 {
     constexpr unsigned n = 128;
 
-    // Phase 1: SIMD reduction to find OR of all values and count equal to first
+    // Phase 1: SIMD reduction to find OR of all values and count equal to
+    // first, fused with the bit-width histogram the cost model reads — one
+    // walk over in[] instead of two. The histogram increments are scalar
+    // (lzcnt per element; SSE4.1 has no vector lzcnt) but hit the cache
+    // lines the vector loads just touched. Constant and all-zero blocks pay
+    // for a histogram their early exits never read; they are the rare cases.
+    //
+    // Padded past MAX_BITS so the Phase 2 vbyte-cost gather can read
+    // cnt[i + 25] unguarded — the tail stays zero and contributes nothing.
+    alignas(64) unsigned cnt[MAX_BITS + 25] = {0};
+
     const __m128i first_vec = _mm_set1_epi32(static_cast<int>(in[0]));
     __m128i or_acc = _mm_setzero_si128();
     __m128i eq_count = _mm_setzero_si128();
-    const __m128i ones = _mm_set1_epi32(1);
 
     // Unroll 4x for better throughput (16 values per iteration)
     for (unsigned i = 0; i < n; i += 16)
@@ -34,32 +43,36 @@ inline unsigned p4Bits128(const uint32_t * in, unsigned * pbx)
         __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 8));
         __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 12));
 
-        // OR accumulation
-        or_acc = _mm_or_si128(or_acc, v0);
-        or_acc = _mm_or_si128(or_acc, v1);
-        or_acc = _mm_or_si128(or_acc, v2);
-        or_acc = _mm_or_si128(or_acc, v3);
-
-        // Count equals
-        __m128i eq0 = _mm_and_si128(_mm_cmpeq_epi32(v0, first_vec), ones);
-        __m128i eq1 = _mm_and_si128(_mm_cmpeq_epi32(v1, first_vec), ones);
-        __m128i eq2 = _mm_and_si128(_mm_cmpeq_epi32(v2, first_vec), ones);
-        __m128i eq3 = _mm_and_si128(_mm_cmpeq_epi32(v3, first_vec), ones);
-
-        eq_count = _mm_add_epi32(eq_count, eq0);
-        eq_count = _mm_add_epi32(eq_count, eq1);
-        eq_count = _mm_add_epi32(eq_count, eq2);
-        eq_count = _mm_add_epi32(eq_count, eq3);
+        // OR accumulation, tree-shaped: the four inputs merge in two levels
+        // instead of serializing four ORs on the accumulator
+        or_acc = _mm_or_si128(or_acc, _mm_or_si128(_mm_or_si128(v0, v1), _mm_or_si128(v2, v3)));
+
+        // Count equals by subtracting the compare mask: each matching lane
+        // is all-ones (-1), so the subtract adds 1 — no AND-with-ones per
+        // vector and no ones register held across the loop
+        eq_count = _mm_sub_epi32(eq_count, _mm_cmpeq_epi32(v0, first_vec));
+        eq_count = _mm_sub_epi32(eq_count, _mm_cmpeq_epi32(v1, first_vec));
+        eq_count = _mm_sub_epi32(eq_count, _mm_cmpeq_epi32(v2, first_vec));
+        eq_count = _mm_sub_epi32(eq_count, _mm_cmpeq_epi32(v3, first_vec));
+
+        for (unsigned j = 0; j < 16u; j += 4u)
+        {
+            ++cnt[bitWidth32(in[i + j + 0u])];
+            ++cnt[bitWidth32(in[i + j + 1u])];
+            ++cnt[bitWidth32(in[i + j + 2u])];
+            ++cnt[bitWidth32(in[i + j + 3u])];
+        }
     }
 
-    // Horizontal reduction for OR
-    __m128i or_tmp = _mm_or_si128(or_acc, _mm_srli_si128(or_acc, 8));
-    or_tmp = _mm_or_si128(or_tmp, _mm_srli_si128(or_tmp, 4));
+    // Horizontal reductions via unpackhi/shuffle instead of psrldq: the
+    // same two shuffle steps, but without the byte-shift, which some cores
+    // split into a copy plus a shift
+    __m128i or_tmp = _mm_or_si128(or_acc, _mm_unpackhi_epi64(or_acc, or_acc));
+    or_tmp = _mm_or_si128(or_tmp, _mm_shuffle_epi32(or_tmp, _MM_SHUFFLE(1, 1, 1, 1)));
     uint32_t u = static_cast<uint32_t>(_mm_cvtsi128_si32(or_tmp));
 
-    // Horizontal reduction for eq_count
-    __m128i eq_tmp = _mm_add_epi32(eq_count, _mm_srli_si128(eq_count, 8));
-    eq_tmp = _mm_add_epi32(eq_tmp, _mm_srli_si128(eq_tmp, 4));
+    __m128i eq_tmp = _mm_add_epi32(eq_count, _mm_unpackhi_epi64(eq_count, eq_count));
+    eq_tmp = _mm_add_epi32(eq_tmp, _mm_shuffle_epi32(eq_tmp, _MM_SHUFFLE(1, 1, 1, 1)));
     unsigned eq = static_cast<unsigned>(_mm_cvtsi128_si32(eq_tmp));
 
     // Compute bit width from OR result using lzcnt (branchless)
@@ -79,23 +92,7 @@ inline unsigned p4Bits128(const uint32_t * in, unsigned * pbx)
         return 0;
     }
 
-    // Phase 2: Build histogram of bit widths using lzcnt
-    alignas(64) unsigned cnt[MAX_BITS + 8] = {0};
-
-    // Process 8 elements at a time - lzcnt is branchless
-    for (unsigned i = 0; i < n; i += 8)
-    {
-        ++cnt[bitWidth32(in[i])];
-        ++cnt[bitWidth32(in[i + 1])];
-        ++cnt[bitWidth32(in[i + 2])];
-        ++cnt[bitWidth32(in[i + 3])];
-        ++cnt[bitWidth32(in[i + 4])];
-        ++cnt[bitWidth32(in[i + 5])];
-        ++cnt[bitWidth32(in[i + 6])];
-        ++cnt[bitWidth32(in[i + 7])];
-    }
-
-    // Phase 3: Find optimal bit width using cost model
+    // Phase 2: Find optimal bit width using cost model
     unsigned bx = b;
     unsigned x = cnt[bx];
     int ml = static_cast<int>(pad8(n * bx) + 1);
@@ -109,19 +106,15 @@ inline unsigned p4Bits128(const uint32_t * in, unsigned * pbx)
         return b;
     }
 
-    // vb array for variable-byte cost estimation
-    int vb_storage[MAX_BITS * 2 + 64 + 16] = {0};
-    int * vb = vb_storage + MAX_BITS + 16;
-
-    auto vbb = [&vb](unsigned xval, int bval) {
-        vb[bval - 7] += static_cast<int>(xval);
-        vb[bval - 15] += static_cast<int>(xval * 2u);
-        vb[bval - 19] += static_cast<int>(xval * 3u);
-        vb[bval - 25] += static_cast<int>(xval * 4u);
-    };
-
+    // Variable-byte cost growth per step. Every width w in [0, bx] used to
+    // register cnt[w] into a delay-line array read 7/15/19/25 iterations
+    // later; but those writes only ever came from the histogram, so the
+    // value read at step i is just a gather over cnt[] at fixed offsets:
+    //   cnt[i+7] + 2*cnt[i+15] + 3*cnt[i+19] + 4*cnt[i+25]
+    // (extra bytes the exception stream grows by when the base drops past
+    // each vbyte length threshold). Reading the histogram directly removes
+    // the 576-byte zeroed scratch array and its store-to-load chain.
     int vv = static_cast<int>(x);
-    vbb(x, static_cast<int>(bx));
 
     int fx = 0;
 
@@ -133,8 +126,7 @@ inline unsigned p4Bits128(const uint32_t * in, unsigned * pbx)
         const int l = static_cast<int>(pad8(n * ui) + 2 + bmp8 + pad8(x * (bx - ui)));
 
         x += cnt[ui];
-        vv += static_cast<int>(cnt[ui]) + vb[i];
-        vbb(cnt[ui], i);
+        vv += static_cast<int>(cnt[ui] + cnt[ui + 7u] + 2u * cnt[ui + 15u] + 3u * cnt[ui + 19u] + 4u * cnt[ui + 25u]);
 
         fi = l < ml;
         ml = fi ? l : ml;
@@ -15,26 +15,13 @@ __attribute__((noinline)) const unsigned char * p4D1Dec128Exceptions(
     using namespace turbopfor::simd::detail;
 
     uint64_t bitmap[MAX_VALUES / 64] = {0};
-    const unsigned words = (n + 63u) / 64u;
-    unsigned num = 0;
+    unsigned num = loadBitmap(in, n, bitmap);
 
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = loadU64(in + i * sizeof(uint64_t));
-        if (i == words - 1 && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-#if defined(__GNUC__) || defined(__clang__)
-        num += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        while (word)
-        {
-            ++num;
-            word &= word - 1u;
-        }
-#endif
-    }
+    // An all-clear bitmap decodes exactly like a no-exception block: skip the
+    // exception unpack and the patching kernel. Our encoder never emits a
+    // patching header with zero exceptions, but the format allows it.
+    if (num == 0u) [[unlikely]]
+        return bitd1unpack128v32(in + pad8(n), out, b, start);
 
     const unsigned char * ip = in + pad8(n);
 
@@ -50,9 +37,8 @@ __attribute__((noinline)) const unsigned char * p4D1Dec128Exceptions(
     return ip;
 }
 
-} // namespace
-
-const unsigned char * p4D1Dec128v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
+// Single body shared by the baseline and AVX2 entry points below
+ALWAYS_INLINE const unsigned char * p4D1Dec128v32Impl(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
 {
     using namespace turbopfor::simd::detail;
 
@@ -62,73 +48,84 @@ const unsigned char * p4D1Dec128v32(const unsigned char * in, unsigned n, uint32
     const unsigned char * ip = in;
     unsigned b = *ip++;
 
-    // Case 1: All values equal (b & 0xC0 == 0xC0)
-    if ((b & 0xC0u) == 0xC0u)
+    // One 4-way dispatch on the two header flag bits instead of three
+    // dependent tests ordered rarest-first (constant, then PFOR, then
+    // vbyte): the common plain-PFOR block resolves in a single compare and
+    // the cases stay direct branches the kernels inline into.
+    switch ((b >> 6u) & 3u)
     {
-        b &= 0x3Fu;
-        uint32_t value = loadU32(ip);
-        if (b < MAX_BITS)
-            value &= maskBits(b);
-
-        for (unsigned i = 0; i < n; ++i)
-            out[i] = value;
+        // Plain PFOR, no exception byte: the most common header
+        case 0u:
+            return bitd1unpack128v32(ip, out, b, start);
 
-        applyDelta1(out, n, start);
-        return ip + (b + 7u) / 8u;
-    }
+        // PFOR with exception bitmap (which may have zero exceptions)
+        case 2u:
+        {
+            const unsigned bx = *ip++;
+            b &= 0x3Fu;
+            if (bx == 0u)
+                return bitd1unpack128v32(ip, out, b, start);
 
-    // Case 2: PFOR format (b & 0x40 == 0)
-    if ((b & 0x40u) == 0u)
-    {
-        unsigned bx = 0u;
-        if (b & 0x80u)
-            bx = *ip++;
+            return p4D1Dec128Exceptions(ip, n, out, start, b, bx);
+        }
 
-        // FAST PATH: No exceptions (most common case)
-        // Direct tail call to bitd1unpack128v32 - matches TurboPFor structure
-        if (!(b & 0x80u))
+        // Variable byte exception format
+        case 1u:
         {
-            return bitd1unpack128v32(ip, out, b, start);
+            const unsigned bx = *ip++;
+            b &= 0x3Fu;
+            uint32_t ex[MAX_VALUES + 64]; // No initialization needed - vbDec32 writes all values we read
+            ip = bitunpack128v32(ip, out, b);
+            ip = vbDec32(ip, bx, ex);
+
+            // Exception merge by position list: the IFUNC-resolved kernel
+            // keeps the 8x unrolled scalar loop as its portable variant and
+            // upgrades to gather/scatter on AVX2/AVX-512 hosts
+            scalar::detail::patchPositions32(out, ip, ex, b, bx);
+
+            ip += bx;
+            applyDelta1(out, n, start);
+            return ip;
         }
 
-        // Has exception bitmap but may have zero exceptions
-        b &= 0x7Fu;
-        if (bx == 0u)
+        // All values equal
+        case 3u:
         {
-            return bitd1unpack128v32(ip, out, b, start);
+            b &= 0x3Fu;
+            uint32_t value = loadU32(ip);
+            if (b < MAX_BITS)
+                value &= maskBits(b);
+
+            // Constant delta: emit the arithmetic progression directly
+            // instead of a fill pass followed by the prefix sum
+            applyDelta1Constant(out, n, start, value);
+            return ip + (b + 7u) / 8u;
         }
-
-        // SLOW PATH: Handle exceptions
-        return p4D1Dec128Exceptions(ip, n, out, start, b, bx);
     }
+    __builtin_unreachable();
+}
 
-    // Case 3: Variable byte format (b & 0x40 != 0)
-    unsigned bx = *ip++;
-    b &= 0x3Fu;
-    uint32_t ex[MAX_VALUES + 64]; // No initialization needed - vbDec32 writes all values we read
-    ip = bitunpack128v32(ip, out, b);
-    ip = vbDec32(ip, bx, ex);
-
-    // Unrolled exception merge loop (8x unrolled to match TurboPFor)
-    unsigned i = 0;
-    const unsigned bx8 = bx & ~7u;
-    for (; i < bx8; i += 8)
-    {
-        out[ip[i + 0]] |= static_cast<uint32_t>(ex[i + 0] << b);
-        out[ip[i + 1]] |= static_cast<uint32_t>(ex[i + 1] << b);
-        out[ip[i + 2]] |= static_cast<uint32_t>(ex[i + 2] << b);
-        out[ip[i + 3]] |= static_cast<uint32_t>(ex[i + 3] << b);
-        out[ip[i + 4]] |= static_cast<uint32_t>(ex[i + 4] << b);
-        out[ip[i + 5]] |= static_cast<uint32_t>(ex[i + 5] << b);
-        out[ip[i + 6]] |= static_cast<uint32_t>(ex[i + 6] << b);
-        out[ip[i + 7]] |= static_cast<uint32_t>(ex[i + 7] << b);
-    }
-    for (; i < bx; ++i)
-        out[ip[i]] |= static_cast<uint32_t>(ex[i] << b);
+} // namespace
 
-    ip += bx;
-    applyDelta1(out, n, start);
-    return ip;
+const unsigned char * p4D1Dec128v32(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
+{
+    return p4D1Dec128v32Impl(in, n, out, start);
 }
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+/// AVX2 alternate entry for the dispatch.cpp resolver: the same body compiled
+/// under target("avx2") re-encodes the inlined SSE kernels in VEX form, so
+/// AVX2 hosts avoid SSE/AVX transition stalls around this path. A plain named
+/// variant rather than target_clones: the resolver takes this function's
+/// address, and an IFUNC whose address feeds another IFUNC resolver is
+/// resolved in unspecified IRELATIVE order — the outer resolver can read a
+/// still-empty GOT slot and bind the public symbol to null.
+__attribute__((target("avx2"))) const unsigned char * p4D1Dec128v32Avx2(const unsigned char * in, unsigned n, uint32_t * out, uint32_t start)
+{
+    return p4D1Dec128v32Impl(in, n, out, start);
+}
+
+#endif
+
 } // namespace turbopfor::simd
@@ -93,26 +93,7 @@ p4D1Dec128v64PayloadBitmap(const unsigned char * in, unsigned n, uint64_t * out,
     // Phase 1: Read bitmap + popcount
     uint64_t bitmap[MAX_VALUES / 64] = {0};
     const unsigned words = (n + 63u) / 64u;
-    unsigned exception_count = 0;
-
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = loadU64Fast(in + i * sizeof(uint64_t));
-        if (i == words - 1u && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-#if defined(__GNUC__) || defined(__clang__)
-        exception_count += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        uint64_t tmp = word;
-        while (tmp)
-        {
-            ++exception_count;
-            tmp &= tmp - 1ull;
-        }
-#endif
-    }
+    unsigned exception_count = loadBitmap(in, n, bitmap);
 
     const unsigned char * ip = in + pad8(n);
 
@@ -133,18 +114,7 @@ p4D1Dec128v64PayloadBitmap(const unsigned char * in, unsigned n, uint64_t * out,
         // Overflow fallback: SIMD unpack + scalar patch + scalar delta1
         ip = bitunpack128v64(ex_end, out, b);
 
-        unsigned k = 0;
-        for (unsigned i = 0; i < words; ++i)
-        {
-            uint64_t word = bitmap[i];
-            while (word)
-            {
-                unsigned bit = static_cast<unsigned>(__builtin_ctzll(word));
-                const unsigned idx = i * 64u + bit;
-                out[idx] |= static_cast<uint64_t>(ex[k++]) << b;
-                word &= word - 1ull;
-            }
-        }
+        patchExceptions(out, bitmap, words, ex, b, exception_count);
 
         applyDelta1_64(out, n, start);
 
@@ -161,24 +131,7 @@ p4D1Dec128v64PayloadBitmap(const unsigned char * in, unsigned n, uint64_t * out,
     ip = bitunpack128v64(ip, out, b);
 
     // Phase 4: Apply patches
-    unsigned k = 0;
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = bitmap[i];
-        while (word)
-        {
-#if defined(__GNUC__) || defined(__clang__)
-            unsigned bit = static_cast<unsigned>(__builtin_ctzll(word));
-#else
-            unsigned bit = 0;
-            while (((word >> bit) & 1ull) == 0ull)
-                ++bit;
-#endif
-            const unsigned idx = i * 64u + bit;
-            out[idx] |= exceptions[k++] << b;
-            word &= word - 1ull;
-        }
-    }
+    patchExceptions(out, bitmap, words, exceptions, b, exception_count);
 
     // Phase 5: Apply delta1 decoding
     applyDelta1_64(out, n, start);
@@ -210,8 +163,7 @@ const unsigned char * p4D1Dec128v64(const unsigned char * in, unsigned n, uint64
         if (b < 64u)
             value &= (1ull << b) - 1ull;
 
-        for (unsigned i = 0; i < n; ++i)
-            out[i] = (start += value) + (i + 1u);
+        applyDelta1Constant64(out, n, start, value);
 
         return ip + bytes_stored;
     }
@@ -13,26 +13,13 @@ __attribute__((noinline)) const unsigned char * p4Dec128Exceptions(
     using namespace turbopfor::simd::detail;
 
     uint64_t bitmap[MAX_VALUES / 64] = {0};
-    const unsigned words = (n + 63u) / 64u;
-    unsigned num = 0;
+    unsigned num = loadBitmap(in, n, bitmap);
 
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = loadU64(in + i * sizeof(uint64_t));
-        if (i == words - 1 && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-#if defined(__GNUC__) || defined(__clang__)
-        num += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        while (word)
-        {
-            ++num;
-            word &= word - 1u;
-        }
-#endif
-    }
+    // An all-clear bitmap decodes exactly like a no-exception block: skip the
+    // exception unpack and the patching kernel. Our encoder never emits a
+    // patching header with zero exceptions, but the format allows it.
+    if (num == 0u) [[unlikely]]
+        return bitunpack128v32(in + pad8(n), out, b);
 
     const unsigned char * ip = in + pad8(n);
 
@@ -58,63 +45,65 @@ const unsigned char * p4Dec128v32(const unsigned char * in, unsigned n, uint32_t
     const unsigned char * ip = in;
     unsigned b = *ip++;
 
-    if ((b & 0xC0u) == 0xC0u)
+    // One 4-way dispatch on the two header flag bits instead of three
+    // dependent tests ordered rarest-first, as in p4D1Dec128v32: the common
+    // plain-PFOR block resolves in a single compare.
+    switch ((b >> 6u) & 3u)
     {
-        b &= 0x3Fu;
-        uint32_t value = loadU32(ip);
-        if (b < MAX_BITS)
-            value &= maskBits(b);
-
-        for (unsigned i = 0; i < n; ++i)
-            out[i] = value;
+        // Plain PFOR, no exception byte: the most common header
+        case 0u:
+            return bitunpack128v32(ip, out, b);
 
-        return ip + (b + 7u) / 8u;
-    }
+        // PFOR with exception bitmap (which may have zero exceptions)
+        case 2u:
+        {
+            const unsigned bx = *ip++;
+            b &= 0x3Fu;
+            if (bx == 0u)
+                return bitunpack128v32(ip, out, b);
 
-    if ((b & 0x40u) == 0u)
-    {
-        unsigned bx = 0u;
-        if (b & 0x80u)
-            bx = *ip++;
+            return p4Dec128Exceptions(ip, n, out, b, bx);
+        }
 
-        if (!(b & 0x80u))
+        // Variable byte exception format
+        case 1u:
         {
-            return bitunpack128v32(ip, out, b);
+            const unsigned bx = *ip++;
+            b &= 0x3Fu;
+            uint32_t ex[MAX_VALUES + 64];
+            ip = bitunpack128v32(ip, out, b);
+            ip = vbDec32(ip, bx, ex);
+
+            // Exception merge by position list, as in the d1 twin: the
+            // IFUNC-resolved kernel keeps the 8x unrolled scalar loop as its
+            // portable variant and upgrades to gather/scatter on
+            // AVX2/AVX-512 hosts
+            scalar::detail::patchPositions32(out, ip, ex, b, bx);
+
+            ip += bx;
+            return ip;
         }
 
-        b &= 0x7Fu;
-        if (bx == 0u)
+        // All values equal
+        case 3u:
         {
-            return bitunpack128v32(ip, out, b);
+            b &= 0x3Fu;
+            uint32_t value = loadU32(ip);
+            if (b < MAX_BITS)
+                value &= maskBits(b);
+
+            // Vector fill: store throughput instead of one 4-byte store per value
+            const __m128i vv = _mm_set1_epi32(static_cast<int>(value));
+            unsigned i = 0;
+            for (; i + 4u <= n; i += 4u)
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), vv);
+            for (; i < n; ++i)
+                out[i] = value;
+
+            return ip + (b + 7u) / 8u;
         }
-
-        return p4Dec128Exceptions(ip, n, out, b, bx);
     }
-
-    unsigned bx = *ip++;
-    b &= 0x3Fu;
-    uint32_t ex[MAX_VALUES + 64];
-    ip = bitunpack128v32(ip, out, b);
-    ip = vbDec32(ip, bx, ex);
-
-    unsigned i = 0;
-    const unsigned bx8 = bx & ~7u;
-    for (; i < bx8; i += 8)
-    {
-        out[ip[i + 0]] |= static_cast<uint32_t>(ex[i + 0] << b);
-        out[ip[i + 1]] |= static_cast<uint32_t>(ex[i + 1] << b);
-        out[ip[i + 2]] |= static_cast<uint32_t>(ex[i + 2] << b);
-        out[ip[i + 3]] |= static_cast<uint32_t>(ex[i + 3] << b);
-        out[ip[i + 4]] |= static_cast<uint32_t>(ex[i + 4] << b);
-        out[ip[i + 5]] |= static_cast<uint32_t>(ex[i + 5] << b);
-        out[ip[i + 6]] |= static_cast<uint32_t>(ex[i + 6] << b);
-        out[ip[i + 7]] |= static_cast<uint32_t>(ex[i + 7] << b);
-    }
-    for (; i < bx; ++i)
-        out[ip[i]] |= static_cast<uint32_t>(ex[i] << b);
-
-    ip += bx;
-    return ip;
+    __builtin_unreachable();
 }
 
 } // namespace turbopfor::simd
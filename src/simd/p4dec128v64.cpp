@@ -28,26 +28,7 @@ p4Dec128v64PayloadBitmap(const unsigned char * in, unsigned n, uint64_t * out, u
     // Phase 1: Read bitmap
     uint64_t bitmap[MAX_VALUES / 64] = {0};
     const unsigned words = (n + 63u) / 64u;
-    unsigned exception_count = 0;
-
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = loadU64Fast(in + i * sizeof(uint64_t));
-        if (i == words - 1u && (n & 0x3Fu))
-            word &= (1ull << (n & 0x3Fu)) - 1ull;
-
-        bitmap[i] = word;
-#if defined(__GNUC__) || defined(__clang__)
-        exception_count += static_cast<unsigned>(__builtin_popcountll(word));
-#else
-        uint64_t tmp = word;
-        while (tmp)
-        {
-            ++exception_count;
-            tmp &= tmp - 1ull;
-        }
-#endif
-    }
+    unsigned exception_count = loadBitmap(in, n, bitmap);
 
     const unsigned char * ip = in + pad8(n);
 
@@ -59,24 +40,7 @@ p4Dec128v64PayloadBitmap(const unsigned char * in, unsigned n, uint64_t * out, u
     ip = bitunpack128v64(ip, out, b);
 
     // Phase 4: Apply patches
-    unsigned k = 0;
-    for (unsigned i = 0; i < words; ++i)
-    {
-        uint64_t word = bitmap[i];
-        while (word)
-        {
-#if defined(__GNUC__) || defined(__clang__)
-            unsigned bit = static_cast<unsigned>(__builtin_ctzll(word));
-#else
-            unsigned bit = 0;
-            while (((word >> bit) & 1ull) == 0ull)
-                ++bit;
-#endif
-            const unsigned idx = i * 64u + bit;
-            out[idx] |= exceptions[k++] << b;
-            word &= word - 1ull;
-        }
-    }
+    patchExceptions(out, bitmap, words, exceptions, b, exception_count);
 
     return ip;
 }
@@ -2,29 +2,35 @@
 #include "p4_simd_internal.h"
 #include "p4bits128_simd.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    define TURBOPFOR_P4ENC128_SCAN_AVX512 1
+#endif
+
 namespace turbopfor::simd
 {
 
 namespace
 {
 
-// Optimized payload encoding for 128 elements with exceptions
-// Uses single-pass algorithm to build base values, exceptions, and bitmap simultaneously
-unsigned char * p4Enc128PayloadExceptions(uint32_t * in, unsigned n, unsigned char * out, unsigned b, unsigned bx)
+// Exception scan: masks the base values into in[] in place (the packer reads
+// them straight from there), collects the oversize values (>> b) and their
+// positions in encounter order, and — for the bitmap strategy — serializes
+// the exception bitmap straight into the reserved wire bytes (bitmap_out;
+// nullptr for the vbyte strategy). Returns the exception count. Kernels must
+// produce byte-identical output: ex[]/positions[] in ascending position
+// order and the same bitmap words, including the zeroed padding words of
+// partial blocks.
+unsigned p4Enc128ScanExceptionsPortable(
+    uint32_t * in, unsigned n, unsigned b, uint32_t * ex, uint8_t * positions, unsigned char * bitmap_out)
 {
     using namespace turbopfor::simd::detail;
 
-    const uint32_t msk = (b >= 32u) ? 0xFFFFFFFFu : ((1u << b) - 1u);
-
-    // Aligned arrays for better cache performance
-    alignas(16) uint32_t base[128];
-    alignas(16) uint32_t ex[128];
-    alignas(16) uint64_t bitmap[2] = {0, 0};  // 128 bits = 2 x 64-bit words
-    alignas(16) uint8_t positions[128];
+    const uint32_t msk = maskBits(b);
 
     // Single-pass: extract base values and track exceptions
     // Use SIMD comparison to find exceptions, then scalar to collect them
     unsigned xn = 0;
+    uint64_t word = 0;
 
     // Process with SIMD for base extraction and exception detection
     const __m128i msk_vec = _mm_set1_epi32(static_cast<int>(msk));
@@ -33,7 +39,6 @@ unsigned char * p4Enc128PayloadExceptions(uint32_t * in, unsigned n, unsigned ch
     {
         __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
         __m128i base_v = _mm_and_si128(v, msk_vec);
-        _mm_storeu_si128(reinterpret_cast<__m128i *>(base + i), base_v);
 
         // Check for exceptions: v > msk means high bits are set
         // cmpgt is signed, so we use unsigned comparison trick:
@@ -48,34 +53,177 @@ unsigned char * p4Enc128PayloadExceptions(uint32_t * in, unsigned n, unsigned ch
 
         // Process exceptions (inverted mask)
         unsigned exc_bits = static_cast<unsigned>(~exc_mask) & 0xFu;
+        word |= static_cast<uint64_t>(exc_bits) << (i & 0x3Fu);
+        if ((i & 0x3Fu) == 60u)
+        {
+            if (bitmap_out)
+                storeU64Fast(bitmap_out + (i >> 6u) * sizeof(uint64_t), word);
+            word = 0;
+        }
         while (exc_bits)
         {
             unsigned bit = static_cast<unsigned>(__builtin_ctz(exc_bits));
             unsigned idx = i + bit;
             positions[xn] = static_cast<uint8_t>(idx);
             ex[xn] = in[idx] >> b;
-            bitmap[idx >> 6] |= 1ull << (idx & 0x3Fu);
             ++xn;
             exc_bits &= exc_bits - 1u;
         }
+
+        // The in-place base store goes last: the collection above still reads
+        // the unmasked in[idx] for this group
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(in + i), base_v);
     }
 
+    // Partial blocks: flush the trailing word and zero any reserved words
+    // the loop never completed, keeping the wire bytes deterministic
+    if (bitmap_out != nullptr && n < 128u)
+    {
+        if (n & 0x3Fu)
+            storeU64Fast(bitmap_out + (n >> 6u) * sizeof(uint64_t), word);
+        for (unsigned w = (n + 63u) >> 6u; w < 2u; ++w)
+            storeU64Fast(bitmap_out + w * sizeof(uint64_t), 0);
+    }
+
+    return xn;
+}
+
+#ifdef TURBOPFOR_P4ENC128_SCAN_AVX512
+
+/// AVX-512 tier: the bit-by-bit ctz collection loop becomes two compress
+/// stores per 16 elements. VPTESTMD against ~msk yields the exception kmask
+/// directly, VPCOMPRESSD appends the shifted-down values to ex[] and
+/// VPCOMPRESSB (AVX512-VBMI2) appends the lane indices to positions[], both
+/// preserving ascending position order; the iteration cost no longer depends
+/// on how many exceptions the block has. The kmask doubles as the bitmap
+/// fragment, so the serialization path is unchanged apart from the stride.
+__attribute__((target("avx512f,avx512bw,avx512vl,avx512vbmi2"))) unsigned p4Enc128ScanExceptionsAvx512(
+    uint32_t * in, unsigned n, unsigned b, uint32_t * ex, uint8_t * positions, unsigned char * bitmap_out)
+{
+    using namespace turbopfor::simd::detail;
+
+    const uint32_t msk = maskBits(b);
+    const __m512i msk_vec = _mm512_set1_epi32(static_cast<int>(msk));
+    const __m512i not_msk = _mm512_set1_epi32(static_cast<int>(~msk));
+    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(b));
+    const __m128i iota = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    unsigned xn = 0;
+    // At four kmasks per word both bitmap words fit in registers for the whole
+    // scan, so there is no streaming flush: the epilogue stores both words
+    // once, which also covers the zeroed padding words of partial blocks.
+    uint64_t words[2] = {0, 0};
+
+    for (unsigned i = 0; i < n; i += 16)
+    {
+        // The lane mask keeps loads inside in[] and base stores inside base[]
+        // on partial blocks; inactive lanes read zero and can never test as
+        // exceptions, so the kmask needs no extra clamping.
+        const __mmask16 lane = (n - i >= 16u) ? static_cast<__mmask16>(0xFFFFu) : static_cast<__mmask16>((1u << (n - i)) - 1u);
+        const __m512i v = _mm512_maskz_loadu_epi32(lane, in + i);
+        // In-place base store; the compress stores below read the register
+        _mm512_mask_storeu_epi32(in + i, lane, _mm512_and_si512(v, msk_vec));
+
+        const __mmask16 exc = _mm512_test_epi32_mask(v, not_msk);
+        _mm512_mask_compressstoreu_epi32(ex + xn, exc, _mm512_srl_epi32(v, shift));
+        _mm_mask_compressstoreu_epi8(positions + xn, exc, _mm_add_epi8(iota, _mm_set1_epi8(static_cast<char>(i))));
+        xn += static_cast<unsigned>(__builtin_popcount(exc));
+
+        words[i >> 6u] |= static_cast<uint64_t>(exc) << (i & 0x3Fu);
+    }
+
+    if (bitmap_out != nullptr)
+    {
+        storeU64Fast(bitmap_out, words[0]);
+        storeU64Fast(bitmap_out + sizeof(uint64_t), words[1]);
+    }
+
+    return xn;
+}
+
+#endif
+
+} // namespace
+
+#if defined(TURBOPFOR_P4ENC128_SCAN_AVX512) && defined(__ELF__)
+
+// IFUNC resolver, as in the decode tiers: one load-time selection, no
+// per-call CPUID check.
+extern "C" void * turbopforResolveP4Enc128ScanExceptions()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512vbmi2") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw"))
+        return reinterpret_cast<void *>(&p4Enc128ScanExceptionsAvx512);
+    return reinterpret_cast<void *>(&p4Enc128ScanExceptionsPortable);
+}
+
+namespace
+{
+unsigned p4Enc128ScanExceptions(uint32_t * in, unsigned n, unsigned b, uint32_t * ex, uint8_t * positions, unsigned char * bitmap_out)
+    __attribute__((ifunc("turbopforResolveP4Enc128ScanExceptions")));
+}
+
+#else
+
+namespace
+{
+unsigned p4Enc128ScanExceptions(uint32_t * in, unsigned n, unsigned b, uint32_t * ex, uint8_t * positions, unsigned char * bitmap_out)
+{
+    return p4Enc128ScanExceptionsPortable(in, n, b, ex, positions, bitmap_out);
+}
+}
+
+#endif
+
+namespace
+{
+
+// Optimized payload encoding for 128 elements with exceptions
+// Uses single-pass algorithm to build base values, exceptions, and bitmap simultaneously
+unsigned char * p4Enc128PayloadExceptions(uint32_t * in, unsigned n, unsigned char * out, unsigned b, unsigned bx)
+{
+    using namespace turbopfor::simd::detail;
+
+    // One 64-byte-aligned scratch allocation so the scan's stores and the
+    // packers' reads walk sequential cache lines. No base[] copy: the scan
+    // masks in[] in place and the packer reads it from there, saving a 512 B
+    // store-and-reload pass — the bx == 0 path already packs from in[]
+    // directly, so the 128-element readability precondition is unchanged.
+    alignas(64) struct
+    {
+        uint32_t ex[128];
+        uint8_t positions[128];
+    } scratch;
+    uint32_t * const ex = scratch.ex;
+    uint8_t * const positions = scratch.positions;
+
+    // The strategy is known before the scan, so the bitmap format reserves
+    // its on-wire bytes up front and each completed 64-bit mask word is
+    // serialized straight into the output — no scratch bitmap[] round trip
+    // and no per-exception scatter-OR to rebuild what the compare masks
+    // already provide.
+    unsigned char * bitmap_out = nullptr;
     if (bx <= MAX_BITS)
     {
-        // Bitmap exception encoding
-        // Format: [bitmap][exception bits][base bits]
-        std::memcpy(out, bitmap, 16);  // 128 bits = 16 bytes
-        out += 16;
+        bitmap_out = out;
+        out += 16;  // 128 bits = 16 bytes
+    }
 
+    const unsigned xn = p4Enc128ScanExceptions(in, n, b, ex, positions, bitmap_out);
+
+    if (bx <= MAX_BITS)
+    {
+        // Bitmap exception encoding
+        // Format: [bitmap (already serialized above)][exception bits][base bits]
         out = scalar::detail::bitpack32Scalar(ex, xn, out, bx);
-        out = bitpack128v32(base, out, b);
+        out = bitpack128v32NoMask(in, out, b); // in[] was masked by the scan
         return out;
     }
 
     // Variable-byte exception encoding
     // Format: [count][base bits][vbyte exceptions][positions]
     *out++ = static_cast<unsigned char>(xn);
-    out = bitpack128v32(base, out, b);
+    out = bitpack128v32NoMask(in, out, b); // in[] was masked by the scan
     out = vbEnc32(ex, xn, out);
 
     std::memcpy(out, positions, xn);
@@ -88,9 +236,10 @@ unsigned char * p4Enc128Payload(uint32_t * in, unsigned n, unsigned char * out,
 {
     using namespace turbopfor::simd::detail;
 
-    // No exceptions - simple bitpacking
+    // No exceptions - simple bitpacking. bx == 0 means p4Bits found every
+    // value fits in b bits, so the packer can skip its masking pass too.
     if (bx == 0u)
-        return bitpack128v32(in, out, b);
+        return bitpack128v32NoMask(in, out, b);
 
     // Constant block - all values equal
     if (bx == MAX_BITS + 2u)
@@ -121,8 +270,10 @@ unsigned char * p4Enc128v32(uint32_t * in, unsigned n, unsigned char * out)
     else
         b = p4Bits32(in, n, &bx);
 
-    // Fast path for all-zeros: just write header byte
-    if (b == 0u && bx == 0u) [[unlikely]]
+    // Fast path for all-zeros: just write header byte. No static hint —
+    // delta-encoded runs make all-zero blocks common in some workloads and
+    // rare in others, so the predictor (or PGO) is a better judge here.
+    if (b == 0u && bx == 0u)
     {
         *out++ = 0;
         return out;
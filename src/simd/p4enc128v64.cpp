@@ -29,33 +29,22 @@ unsigned char * p4Enc128v64PayloadExceptions(uint64_t * in, unsigned n, unsigned
 
     uint64_t base[MAX_VALUES];
     uint64_t exceptions[MAX_VALUES];
-    unsigned exception_positions[MAX_VALUES];
+    uint64_t bitmap[MAX_VALUES / 64] = {0};
 
-    // Phase 1: Split values into base and exceptions (branchless)
-    unsigned exception_count = 0;
-    for (unsigned i = 0; i < n; ++i)
-    {
-        exception_positions[exception_count] = i;
-        exception_count += (in[i] > base_mask) ? 1u : 0u;
-        base[i] = in[i] & base_mask;
-    }
+    const unsigned words = (n + 63u) / 64u;
 
-    // Phase 2: Build exception data
-    uint64_t bitmap[MAX_VALUES / 64] = {0};
-    for (unsigned i = 0; i < exception_count; ++i)
-    {
-        const unsigned pos = exception_positions[i];
-        bitmap[pos >> 6] |= 1ull << (pos & 0x3Fu);
-        exceptions[i] = in[pos] >> b;
-    }
+    // Phases 1+2 in one kernel: mask base values out, build the exception
+    // bitmap from the compare masks and compress the high bits into
+    // exceptions[] in position order
+    const unsigned exception_count = scalar::detail::scanExceptions64(in, n, base_mask, b, base, bitmap, exceptions);
 
     // Phase 3: Encode
     if (bx <= MAX_BITS_64)
     {
         // Bitmap patching: [bitmap][patch bits][base bits]
-        const unsigned bitmap_words = (n + 63u) / 64u;
-        for (unsigned i = 0; i < bitmap_words; ++i)
-            storeU64Fast(out + i * sizeof(uint64_t), bitmap[i]);
+        // Always both words (one 16-byte store); the patch bits written next
+        // overwrite any overshoot on partial blocks
+        std::memcpy(out, bitmap, 16); // 128 bits = 16 bytes
 
         out += pad8(n);
 
@@ -74,8 +63,11 @@ unsigned char * p4Enc128v64PayloadExceptions(uint64_t * in, unsigned n, unsigned
     out = bitpack128v64(base, out, b);
     out = scalar::detail::vbEnc64(exceptions, exception_count, out);
 
-    for (unsigned i = 0; i < exception_count; ++i)
-        *out++ = static_cast<unsigned char>(exception_positions[i]);
+    // Only this strategy needs the position list; recover it from the bitmap
+    // straight into the stream — the expansion's trailing 8-byte store
+    // stays within the stream's write slack
+    expandBitmapIndices(bitmap, words, out);
+    out += exception_count;
 
     return out;
 }
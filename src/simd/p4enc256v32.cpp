@@ -1,41 +1,76 @@
 #include "p4_simd.h"
 #include "p4_simd_internal_256v.h"
 
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#    define TURBOPFOR_P4ENC256_SCAN_AVX512 1
+#endif
+
 namespace turbopfor::simd
 {
 
 namespace
 {
 
-// Optimized payload encoding for 256 elements with exceptions
-// Uses single-pass algorithm to build base values, exceptions, and bitmap simultaneously
-unsigned char * p4Enc256PayloadExceptions(uint32_t * in, unsigned n, unsigned char * out, unsigned b, unsigned bx)
+/// Byte-packed compaction control per 8-bit exception mask: byte j of entry m
+/// holds the lane index of the j-th set bit (the Masked-VByte layout kept at
+/// byte width). One entry feeds both sides of the record emission: widened
+/// through VPMOVZXBD it is the VPERMD control that packs the exception lanes
+/// to the front, and added to a broadcast of the block offset it IS the
+/// positions[] byte string.
+consteval std::array<uint64_t, 256> makeCompactLut8()
 {
-    using namespace turbopfor::simd::detail;
+    std::array<uint64_t, 256> lut{};
+    for (unsigned m = 0; m < 256u; ++m)
+    {
+        unsigned k = 0;
+        for (unsigned j = 0; j < 8u; ++j)
+            if ((m >> j) & 1u)
+                lut[m] |= static_cast<uint64_t>(j) << (8u * k++);
+    }
+    return lut;
+}
 
-    const uint32_t msk = (b >= 32u) ? 0xFFFFFFFFu : ((1u << b) - 1u);
+alignas(64) constexpr auto compact_lut8 = makeCompactLut8();
+
+// Exception scan: collects the oversize values (>> b) and their positions in
+// encounter order, and — for the bitmap strategy — serializes the exception
+// bitmap straight into the reserved wire bytes (bitmap_out; nullptr for the
+// vbyte strategy). Returns the exception count. The base values are not
+// staged anywhere: both bitpack256v32 tiers mask every load against the base
+// width themselves, so the packer reads in[] directly. Kernels must produce
+// byte-identical output: ex[]/positions[] in ascending position order and
+// the same bitmap words, including the zeroed padding words of partial
+// blocks.
+//
+// The block length is a template parameter following the p4Bits32Impl
+// pattern: N == 0 compiles the runtime-length version, N == 256 pins the
+// full block so the loop gets a constant trip count and the partial-block
+// epilogue folds away.
+template <unsigned N>
+ALWAYS_INLINE unsigned p4Enc256ScanExceptionsPortableImpl(
+    const uint32_t * in, unsigned n_rt, unsigned b, uint32_t * ex, uint8_t * positions, unsigned char * bitmap_out)
+{
+    using namespace turbopfor::simd::detail;
 
-    // Aligned arrays for better cache performance
-    alignas(32) uint32_t base[256];
-    alignas(32) uint32_t ex[256];
-    alignas(32) uint64_t bitmap[4] = {0, 0, 0, 0};  // 256 bits = 4 x 64-bit words
-    alignas(32) uint8_t positions[256];
+    const unsigned n = (N != 0u) ? N : n_rt;
+    const uint32_t msk = maskBits(b);
 
-    // Single-pass: extract base values and track exceptions
+    // Single-pass exception detection
     unsigned xn = 0;
+    uint64_t word = 0;
 
-    // Process with AVX2 SIMD for base extraction and exception detection
     const __m256i msk_vec = _mm256_set1_epi32(static_cast<int>(msk));
+    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(b));
 
     for (unsigned i = 0; i < n; i += 8)
     {
         __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
-        __m256i base_v = _mm256_and_si256(v, msk_vec);
-        _mm256_storeu_si256(reinterpret_cast<__m256i *>(base + i), base_v);
 
-        // Check for exceptions: v > msk means high bits are set
-        __m256i high_bits = _mm256_andnot_si256(msk_vec, v);
-        __m256i has_exc = _mm256_cmpeq_epi32(high_bits, _mm256_setzero_si256());
+        // Check for exceptions: v > msk means high bits are set. The
+        // unsigned-min clip folds the range test into one op — min(v, msk)
+        // only survives the equality compare when v fits the base width —
+        // so no andnot and no zero register on the detection path.
+        __m256i has_exc = _mm256_cmpeq_epi32(_mm256_min_epu32(v, msk_vec), v);
         // has_exc is 0xFFFFFFFF where NO exception, 0 where exception exists
 
         int exc_mask = _mm256_movemask_ps(_mm256_castsi256_ps(has_exc));
@@ -43,37 +78,203 @@ unsigned char * p4Enc256PayloadExceptions(uint32_t * in, unsigned n, unsigned ch
 
         // Process exceptions (inverted mask)
         unsigned exc_bits = static_cast<unsigned>(~exc_mask) & 0xFFu;
-        while (exc_bits)
+        word |= static_cast<uint64_t>(exc_bits) << (i & 0x3Fu);
+        if ((i & 0x3Fu) == 56u)
         {
-            unsigned bit = static_cast<unsigned>(__builtin_ctz(exc_bits));
-            unsigned idx = i + bit;
-            positions[xn] = static_cast<uint8_t>(idx);
-            ex[xn] = in[idx] >> b;
-            bitmap[idx >> 6] |= 1ull << (idx & 0x3Fu);
-            ++xn;
-            exc_bits &= exc_bits - 1u;
+            if (bitmap_out)
+                storeU64Fast(bitmap_out + (i >> 6u) * sizeof(uint64_t), word);
+            word = 0;
         }
+        // Branchless record emission: a LUT-driven VPERMD packs the shifted
+        // high bits of the exception lanes to the front and one full-width
+        // store appends them at xn; the same LUT entry plus a per-byte
+        // broadcast of i emits the positions. No ctz chain and no
+        // data-dependent branch per exception. The stores past xn stay
+        // inside the scratch arrays because xn never exceeds the lanes
+        // already processed.
+        const uint64_t lanes = compact_lut8[exc_bits];
+        const __m256i perm = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(static_cast<long long>(lanes)));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(ex + xn), _mm256_permutevar8x32_epi32(_mm256_srl_epi32(v, shift), perm));
+        storeU64Fast(positions + xn, lanes + 0x0101010101010101ull * i);
+        xn += static_cast<unsigned>(__builtin_popcount(exc_bits));
+    }
+
+    // Partial blocks: flush the trailing word and zero any reserved words
+    // the loop never completed, keeping the wire bytes deterministic
+    if (bitmap_out != nullptr && n < 256u)
+    {
+        if (n & 0x3Fu)
+            storeU64Fast(bitmap_out + (n >> 6u) * sizeof(uint64_t), word);
+        for (unsigned w = (n + 63u) >> 6u; w < 4u; ++w)
+            storeU64Fast(bitmap_out + w * sizeof(uint64_t), 0);
+    }
+
+    return xn;
+}
+
+unsigned p4Enc256ScanExceptionsPortable(
+    const uint32_t * in, unsigned n, unsigned b, uint32_t * ex, uint8_t * positions, unsigned char * bitmap_out)
+{
+    if (n == 256u)
+        return p4Enc256ScanExceptionsPortableImpl<256u>(in, n, b, ex, positions, bitmap_out);
+    return p4Enc256ScanExceptionsPortableImpl<0u>(in, n, b, ex, positions, bitmap_out);
+}
+
+#ifdef TURBOPFOR_P4ENC256_SCAN_AVX512
+
+/// AVX-512 tier, the 256-element twin of the 128v encoder's scan: the
+/// bit-by-bit ctz collection loop becomes two compress stores per 16
+/// elements. VPTESTMD against ~msk yields the exception kmask directly,
+/// VPCOMPRESSD appends the shifted-down values to ex[] and VPCOMPRESSB
+/// (AVX512-VBMI2) appends the lane indices to positions[], both preserving
+/// ascending position order; the iteration cost no longer depends on how
+/// many exceptions the block has.
+template <unsigned N>
+__attribute__((target("avx512f,avx512bw,avx512vl,avx512vbmi2"))) ALWAYS_INLINE unsigned p4Enc256ScanExceptionsAvx512Impl(
+    const uint32_t * in, unsigned n_rt, unsigned b, uint32_t * ex, uint8_t * positions, unsigned char * bitmap_out)
+{
+    using namespace turbopfor::simd::detail;
+
+    const unsigned n = (N != 0u) ? N : n_rt;
+    const __m512i not_msk = _mm512_set1_epi32(static_cast<int>(~maskBits(b)));
+    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(b));
+    const __m128i iota = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    unsigned xn = 0;
+    // At four kmasks per word all four bitmap words fit in registers for the
+    // whole scan, so there is no streaming flush: the epilogue stores them
+    // once, which also covers the zeroed padding words of partial blocks.
+    uint64_t words[4] = {0, 0, 0, 0};
+
+    for (unsigned i = 0; i < n; i += 16)
+    {
+        // The lane mask keeps loads inside in[] on partial blocks; inactive
+        // lanes read zero and can never test as exceptions, so the kmask
+        // needs no extra clamping.
+        const __mmask16 lane = (n - i >= 16u) ? static_cast<__mmask16>(0xFFFFu) : static_cast<__mmask16>((1u << (n - i)) - 1u);
+        const __m512i v = _mm512_maskz_loadu_epi32(lane, in + i);
+
+        const __mmask16 exc = _mm512_test_epi32_mask(v, not_msk);
+        _mm512_mask_compressstoreu_epi32(ex + xn, exc, _mm512_srl_epi32(v, shift));
+        _mm_mask_compressstoreu_epi8(positions + xn, exc, _mm_add_epi8(iota, _mm_set1_epi8(static_cast<char>(i))));
+        xn += static_cast<unsigned>(__builtin_popcount(exc));
+
+        words[i >> 6u] |= static_cast<uint64_t>(exc) << (i & 0x3Fu);
+    }
+
+    if (bitmap_out != nullptr)
+    {
+        for (unsigned w = 0; w < 4u; ++w)
+            storeU64Fast(bitmap_out + w * sizeof(uint64_t), words[w]);
+    }
+
+    return xn;
+}
+
+__attribute__((target("avx512f,avx512bw,avx512vl,avx512vbmi2"))) unsigned p4Enc256ScanExceptionsAvx512(
+    const uint32_t * in, unsigned n, unsigned b, uint32_t * ex, uint8_t * positions, unsigned char * bitmap_out)
+{
+    if (n == 256u)
+        return p4Enc256ScanExceptionsAvx512Impl<256u>(in, n, b, ex, positions, bitmap_out);
+    return p4Enc256ScanExceptionsAvx512Impl<0u>(in, n, b, ex, positions, bitmap_out);
+}
+
+#endif
+
+} // namespace
+
+#if defined(TURBOPFOR_P4ENC256_SCAN_AVX512) && defined(__ELF__)
+
+// IFUNC resolver, as in the decode tiers: one load-time selection, no
+// per-call CPUID check.
+extern "C" void * turbopforResolveP4Enc256ScanExceptions()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512vbmi2") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw"))
+        return reinterpret_cast<void *>(&p4Enc256ScanExceptionsAvx512);
+    return reinterpret_cast<void *>(&p4Enc256ScanExceptionsPortable);
+}
+
+namespace
+{
+unsigned p4Enc256ScanExceptions(
+    const uint32_t * in, unsigned n, unsigned b, uint32_t * ex, uint8_t * positions, unsigned char * bitmap_out)
+    __attribute__((ifunc("turbopforResolveP4Enc256ScanExceptions")));
+}
+
+#else
+
+namespace
+{
+unsigned p4Enc256ScanExceptions(
+    const uint32_t * in, unsigned n, unsigned b, uint32_t * ex, uint8_t * positions, unsigned char * bitmap_out)
+{
+    return p4Enc256ScanExceptionsPortable(in, n, b, ex, positions, bitmap_out);
+}
+}
+
+#endif
+
+namespace
+{
+
+// Optimized payload encoding for 256 elements with exceptions
+// Uses single-pass algorithm to build exceptions and bitmap simultaneously
+unsigned char * p4Enc256PayloadExceptions(uint32_t * in, unsigned n, unsigned char * out, unsigned b, unsigned bx)
+{
+    using namespace turbopfor::simd::detail;
+
+    // One 64-byte-aligned scratch allocation so the scan's stores and the
+    // packers' reads walk sequential cache lines. There is no base[] staging
+    // copy: both bitpack256v32 tiers mask every load against the base width
+    // themselves, so they pack straight from in[] — the same reason the
+    // bx == 0 path feeds in[] to the packer directly.
+    alignas(64) struct
+    {
+        uint32_t ex[256];
+        uint8_t positions[256];
+    } scratch;
+    uint32_t * const ex = scratch.ex;
+    uint8_t * const positions = scratch.positions;
+
+    // The strategy is known before the scan, so the bitmap format reserves
+    // its on-wire bytes up front and each completed 64-bit mask word is
+    // serialized straight into the output — no scratch bitmap[] round trip
+    // and no per-exception scatter-OR to rebuild what the compare masks
+    // already provide.
+    unsigned char * bitmap_out = nullptr;
+    if (bx <= MAX_BITS)
+    {
+        bitmap_out = out;
+        out += 32;  // 256 bits = 32 bytes
     }
 
+    const unsigned xn = p4Enc256ScanExceptions(in, n, b, ex, positions, bitmap_out);
+
     if (bx <= MAX_BITS)
     {
         // Bitmap exception encoding
-        // Format: [bitmap][exception bits][base bits]
-        std::memcpy(out, bitmap, 32);  // 256 bits = 32 bytes
-        out += 32;
-
+        // Format: [bitmap (already serialized above)][exception bits][base bits]
         out = scalar::detail::bitpack32Scalar(ex, xn, out, bx);
-        out = bitpack256v32(base, out, b);
+        out = bitpack256v32(in, out, b);
         return out;
     }
 
     // Variable-byte exception encoding
     // Format: [count][base bits][vbyte exceptions][positions]
     *out++ = static_cast<unsigned char>(xn);
-    out = bitpack256v32(base, out, b);
+    out = bitpack256v32(in, out, b);
     out = vbEnc32_256v(ex, xn, out);
 
-    std::memcpy(out, positions, xn);
+    // Position list: guaranteed ymm stores for the bulk instead of trusting
+    // the memcpy expansion; the sub-32-byte tail keeps the byte-exact copy so
+    // the encoder never stores past the returned end.
+    unsigned i = 0;
+    for (; i + 32u <= xn; i += 32u)
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(out + i), _mm256_load_si256(reinterpret_cast<const __m256i *>(positions + i)));
+    std::memcpy(out + i, positions + i, xn - i);
     out += xn;
 
     return out;
@@ -110,8 +311,10 @@ unsigned char * p4Enc256v32(uint32_t * in, unsigned n, unsigned char * out)
     unsigned bx = 0;
     unsigned b = p4Bits32_256v(in, n, &bx);
 
-    // Fast path for all-zeros: just write header byte
-    if (b == 0u && bx == 0u) [[unlikely]]
+    // Fast path for all-zeros: just write header byte. No static hint —
+    // delta-encoded runs make all-zero blocks common in some workloads and
+    // rare in others, so the predictor (or PGO) is a better judge here.
+    if (b == 0u && bx == 0u)
     {
         *out++ = 0;
         return out;
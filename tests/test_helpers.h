@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <immintrin.h>
 #include <cstdio>
 #include <cstring>
 #include <functional>
@@ -76,15 +77,75 @@ unsigned popcount64(uint64_t v)
 #endif
 }
 
+// Count the set bits of an exception bitmap without a per-word loop: blocks
+// cap at 256 elements, so the bitmap is at most 32 bytes and a zero-padded
+// copy into a fixed buffer lets four popcounts cover every n.
+unsigned popcountBitmap(const unsigned char * p, unsigned bytes)
+{
+    alignas(16) unsigned char tmp[32] = {0};
+    std::memcpy(tmp, p, bytes);
+    uint64_t w[4];
+    std::memcpy(w, tmp, sizeof(w));
+    return popcount64(w[0]) + popcount64(w[1]) + popcount64(w[2]) + popcount64(w[3]);
+}
+
+// Byte-wise buffer equality over 16-byte vector compares: equal lanes raise
+// every movemask bit, so one integer compare covers 16 bytes where the
+// std::equal loop took 16 iterations. The tail re-checks the last 16-byte
+// window (overlap is harmless for equality) and sub-16 buffers go through a
+// zero-padded copy, as in popcountBitmap above.
+bool bufEqual(const void * a, const void * b, size_t bytes)
+{
+    const unsigned char * pa = static_cast<const unsigned char *>(a);
+    const unsigned char * pb = static_cast<const unsigned char *>(b);
+
+    auto eq16 = [](const unsigned char * x, const unsigned char * y)
+    {
+        const __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i *>(x));
+        const __m128i vy = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(vx, vy)) == 0xFFFF;
+    };
+
+    if (bytes < 16u)
+    {
+        alignas(16) unsigned char ta[16] = {0};
+        alignas(16) unsigned char tb[16] = {0};
+        std::memcpy(ta, pa, bytes);
+        std::memcpy(tb, pb, bytes);
+        return eq16(ta, tb);
+    }
+
+    size_t i = 0;
+    for (; i + 16u <= bytes; i += 16u)
+        if (!eq16(pa + i, pb + i))
+            return false;
+    return i == bytes || eq16(pa + bytes - 16u, pb + bytes - 16u);
+}
+
+// Clear the padding bits past total_bits in the final packed byte. One BZHI
+// over the 8-byte window covering the tail replaces the remainder branch and
+// the mask construction: when total_bits is byte-aligned the keep count hits
+// the operand width and BZHI leaves the word untouched by definition.
 void maskPaddingBits(unsigned char * buf, unsigned total_bits)
 {
-    unsigned rem = total_bits & 7u;
-    if (rem == 0u || total_bits == 0u)
+    if (total_bits == 0u)
         return;
 
     unsigned bytes = pad8(total_bits);
-    unsigned char mask = static_cast<unsigned char>((1u << rem) - 1u);
-    buf[bytes - 1] &= mask;
+    if (bytes >= 8u)
+    {
+        uint64_t w;
+        std::memcpy(&w, buf + bytes - 8u, 8u);
+        w = _bzhi_u64(w, 64u - (8u * bytes - total_bits));
+        std::memcpy(buf + bytes - 8u, &w, 8u);
+    }
+    else
+    {
+        uint64_t w = 0;
+        std::memcpy(&w, buf, bytes);
+        w = _bzhi_u64(w, total_bits);
+        std::memcpy(buf, &w, bytes);
+    }
 }
 
 void fillSequential(std::vector<uint32_t> & data, uint32_t base, uint32_t step)
@@ -93,11 +154,65 @@ void fillSequential(std::vector<uint32_t> & data, uint32_t base, uint32_t step)
         data[i] = base + static_cast<uint32_t>(i) * step;
 }
 
+// xoshiro256+ (Blackman/Vigna): four words of state, one add/xor/rotl step
+// per 8 output bytes. The random patterns regenerate every array for each
+// of the 127 sizes, and mt19937 through uniform_int_distribution — with its
+// per-element rejection loop — dominated that. The patterns only ever ask
+// for max_val = 2^bw - 1, so a bitwise AND maps the raw stream exactly onto
+// [0, max_val]; mt19937 seeds the state (via splitmix64, as the authors
+// recommend) so each pattern stays deterministic under the fixed test seed.
+struct Xoshiro256p
+{
+    uint64_t s[4];
+
+    explicit Xoshiro256p(std::mt19937 & seed_rng)
+    {
+        uint64_t x = (static_cast<uint64_t>(seed_rng()) << 32) | seed_rng();
+        for (auto & w : s)
+        {
+            uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            w = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t next()
+    {
+        const uint64_t result = s[0] + s[3];
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = (s[3] << 45) | (s[3] >> 19);
+        return result;
+    }
+};
+
 void fillRandom(std::vector<uint32_t> & data, uint32_t max_val, std::mt19937 & rng)
 {
-    std::uniform_int_distribution<uint32_t> dist(0u, max_val);
-    for (auto & v : data)
-        v = dist(rng);
+    // Bounds that are not all-ones below some bit keep the rejection path;
+    // the patterns never take it, but the helper stays correct for them.
+    if ((max_val & (max_val + 1u)) != 0u)
+    {
+        std::uniform_int_distribution<uint32_t> dist(0u, max_val);
+        for (auto & v : data)
+            v = dist(rng);
+        return;
+    }
+
+    Xoshiro256p prng(rng);
+    size_t i = 0;
+    for (; i + 2 <= data.size(); i += 2)
+    {
+        const uint64_t r = prng.next();
+        data[i] = static_cast<uint32_t>(r) & max_val;
+        data[i + 1] = static_cast<uint32_t>(r >> 32) & max_val;
+    }
+    if (i < data.size())
+        data[i] = static_cast<uint32_t>(prng.next()) & max_val;
 }
 
 void fillConstant(std::vector<uint32_t> & data, uint32_t value)
@@ -120,6 +235,67 @@ void fillWithExceptions(std::vector<uint32_t> & data, uint32_t base_max, uint32_
     }
 }
 
+// Shared fill patterns for the 32-bit cross-validation drivers. A tagged
+// kind plus one argument replaces the std::function closures the drivers
+// used to build per-pattern: dispatch is a direct switch over the free fill
+// helpers, so invoking a pattern is an inlinable call with no type erasure
+// and building the vector allocates nothing beyond the names.
+enum PatternKind : uint8_t
+{
+    PATTERN_SEQ,
+    PATTERN_CONST,
+    PATTERN_RANDOM_BW,
+    PATTERN_EXC,
+};
+
+struct TestPattern
+{
+    char name[24]; // inline storage; the random_bw names are snprintf'd in
+    PatternKind kind;
+    uint32_t arg; // constant value, random max_val, or exception percent
+};
+
+void fillPattern(const TestPattern & pattern, std::vector<uint32_t> & data, std::mt19937 & rng)
+{
+    switch (pattern.kind)
+    {
+        case PATTERN_SEQ:
+            fillSequential(data, 0u, 1u);
+            break;
+        case PATTERN_CONST:
+            fillConstant(data, pattern.arg);
+            break;
+        case PATTERN_RANDOM_BW:
+            fillRandom(data, pattern.arg, rng);
+            break;
+        case PATTERN_EXC:
+            fillWithExceptions(data, 255u, 100000u, pattern.arg, rng);
+            break;
+    }
+}
+
+std::vector<TestPattern> makeTestPatterns32()
+{
+    std::vector<TestPattern> patterns;
+
+    patterns.push_back({"sequential", PATTERN_SEQ, 0u});
+    patterns.push_back({"all_zeros", PATTERN_CONST, 0u});
+    patterns.push_back({"all_same", PATTERN_CONST, 42u});
+
+    for (unsigned bw = 1; bw <= 32; ++bw)
+    {
+        TestPattern p{"", PATTERN_RANDOM_BW, (bw == 32u) ? 0xFFFFFFFFu : ((1u << bw) - 1u)};
+        std::snprintf(p.name, sizeof(p.name), "random_bw%u", bw);
+        patterns.push_back(p);
+    }
+
+    patterns.push_back({"exceptions_5pct", PATTERN_EXC, 5u});
+    patterns.push_back({"exceptions_10pct", PATTERN_EXC, 10u});
+    patterns.push_back({"exceptions_25pct", PATTERN_EXC, 25u});
+
+    return patterns;
+}
+
 void fillSequential64(std::vector<uint64_t> & data, uint64_t base, uint64_t step)
 {
     for (size_t i = 0; i < data.size(); ++i)
@@ -154,15 +330,30 @@ void fillWithExceptions64(std::vector<uint64_t> & data, uint64_t base_max, uint6
     }
 }
 
-void normalizeP4Enc32(unsigned char * buf, unsigned n)
+// Parsed padding layout of an encoded 32-bit block. The comparison drivers
+// normalize two or three buffers per trial; computing the layout once on the
+// first buffer and applying it to all of them runs the header parse and the
+// bitmap popcount a single time. Sharing the info is sound even when the
+// buffers disagree: masking only zeroes bits, and any disagreement in the
+// header or bitmap bytes — which the mask never touches — already fails the
+// byte comparison on its own.
+struct NormInfo
+{
+    bool constant; // constant block (or malformed width): nothing to mask
+    unsigned offset; // byte offset of the first packed section
+    unsigned ex_bits; // packed exception bits (bitmap strategy), else 0
+    unsigned base_bits; // packed base bits
+};
+
+NormInfo computeNormInfo32(const unsigned char * buf, unsigned n)
 {
     if (n == 0u)
-        return;
+        return {true, 0u, 0u, 0u};
 
     unsigned b = buf[0];
 
     if ((b & 0xC0u) == 0xC0u)
-        return;
+        return {true, 0u, 0u, 0u};
 
     if ((b & 0x40u) == 0u)
     {
@@ -176,39 +367,38 @@ void normalizeP4Enc32(unsigned char * buf, unsigned n)
         b &= 0x3Fu;
 
         if (bx == 0u)
-        {
-            maskPaddingBits(buf + offset, n * b);
-            return;
-        }
+            return {false, offset, 0u, n * b};
 
         if (bx <= 32u)
         {
             unsigned bitmap_bytes = pad8(n);
-            unsigned xn = 0u;
-            for (unsigned i = 0; i < bitmap_bytes; i += 8)
-            {
-                uint64_t word = 0;
-                unsigned chunk = (bitmap_bytes - i) < 8 ? (bitmap_bytes - i) : 8;
-                std::memcpy(&word, buf + offset + i, chunk);
-                xn += popcount64(word);
-            }
-
-            unsigned char * ex_pack = buf + offset + bitmap_bytes;
-            maskPaddingBits(ex_pack, xn * bx);
-            unsigned ex_bytes = pad8(xn * bx);
-            unsigned char * base_pack = ex_pack + ex_bytes;
-            maskPaddingBits(base_pack, n * b);
-            return;
+            unsigned xn = popcountBitmap(buf + offset, bitmap_bytes);
+            return {false, offset + bitmap_bytes, xn * bx, n * b};
         }
 
+        return {true, 0u, 0u, 0u};
+    }
+
+    return {false, 2u, 0u, n * (b & 0x3Fu)};
+}
+
+void applyNorm32(unsigned char * buf, const NormInfo & info)
+{
+    if (info.constant)
         return;
+
+    unsigned char * p = buf + info.offset;
+    if (info.ex_bits != 0u)
+    {
+        maskPaddingBits(p, info.ex_bits);
+        p += pad8(info.ex_bits);
     }
+    maskPaddingBits(p, info.base_bits);
+}
 
-    unsigned bx = buf[1];
-    unsigned offset = 2u;
-    b &= 0x3Fu;
-    (void)bx;
-    maskPaddingBits(buf + offset, n * b);
+void normalizeP4Enc32(unsigned char * buf, unsigned n)
+{
+    applyNorm32(buf, computeNormInfo32(buf, n));
 }
 
 void normalizeP4Enc64(unsigned char * buf, unsigned n)
@@ -248,14 +438,7 @@ void normalizeP4Enc64(unsigned char * buf, unsigned n)
         if (bx <= 64u)
         {
             unsigned bitmap_bytes = pad8(n);
-            unsigned xn = 0u;
-            for (unsigned i = 0; i < bitmap_bytes; i += 8)
-            {
-                uint64_t word = 0;
-                unsigned chunk = (bitmap_bytes - i) < 8 ? (bitmap_bytes - i) : 8;
-                std::memcpy(&word, buf + offset + i, chunk);
-                xn += popcount64(word);
-            }
+            unsigned xn = popcountBitmap(buf + offset, bitmap_bytes);
 
             unsigned char * ex_pack = buf + offset + bitmap_bytes;
             maskPaddingBits(ex_pack, static_cast<unsigned>(static_cast<uint64_t>(xn) * bx));
@@ -8,6 +8,7 @@ unsigned runBitunpackCompatibilityTest();
 unsigned runBitunpackD1CompatibilityTest();
 unsigned runCrossValidation256vTest();
 unsigned runBinaryCompatibility256vTest();
+unsigned runStreamVByteTest();
 
 // 32-bit non-delta decode tests
 unsigned runP4Dec32CompatibilityTest();
@@ -39,6 +40,7 @@ int main()
     unsigned failed_bitunpack_d1 = runBitunpackD1CompatibilityTest();
     unsigned failed_256v_cross = runCrossValidation256vTest();
     unsigned failed_256v_compat = runBinaryCompatibility256vTest();
+    unsigned failed_svb32 = runStreamVByteTest();
 
     unsigned failed_p4dec32 = runP4Dec32CompatibilityTest();
     unsigned failed_p4dec128v32 = runP4Dec128v32CompatibilityTest();
@@ -59,7 +61,7 @@ int main()
     unsigned failed_d1enc256v64 = runD1Enc256v64RoundtripTest();
 
     unsigned total = failed_p4_32 + failed_128v_cross + failed_128v_compat + failed_bitunpack + failed_bitunpack_d1 + failed_256v_cross
-        + failed_256v_compat + failed_p4dec32 + failed_p4dec128v32 + failed_p4dec256v32 + failed_bitpack64 + failed_p4_64 + failed_128v64 + failed_256v64 + failed_vbyte64
+        + failed_256v_compat + failed_svb32 + failed_p4dec32 + failed_p4dec128v32 + failed_p4dec256v32 + failed_bitpack64 + failed_p4_64 + failed_128v64 + failed_256v64 + failed_vbyte64
         + failed_p4dec64
         + failed_d1enc32 + failed_d1enc128v32 + failed_d1enc256v32 + failed_d1enc64 + failed_d1enc128v64 + failed_d1enc256v64;
 
@@ -71,6 +73,7 @@ int main()
     std::printf("  bitunpack32 d1:        %u failures\n", failed_bitunpack_d1);
     std::printf("  256v32 cross:          %u failures\n", failed_256v_cross);
     std::printf("  256v32 compat:         %u failures\n", failed_256v_compat);
+    std::printf("  streamvbyte32:         %u failures\n", failed_svb32);
     std::printf("  p4dec32:               %u failures\n", failed_p4dec32);
     std::printf("  p4dec128v32:           %u failures\n", failed_p4dec128v32);
     std::printf("  p4dec256v32:           %u failures\n", failed_p4dec256v32);
@@ -126,52 +126,55 @@ unsigned runBinaryCompatibility64Test()
     std::printf("=== Verifying C p4enc64/p4d1dec64 <-> C++ turbopfor::p4Enc64/p4D1Dec64 ===\n");
     std::printf("=== Testing n = 1 to 127 ===\n\n");
 
-    for (unsigned n : sizes)
+    // The patterns only parameterize the fill, never n, so build the vector
+    // (and its type-erased closures) once instead of re-allocating all of it
+    // for each of the 127 sizes
+    struct TestPattern
     {
-        struct TestPattern
-        {
-            std::string name;
-            std::function<void(std::vector<uint64_t> &, std::mt19937_64 &)> fill;
-        };
-
-        std::vector<TestPattern> patterns;
+        std::string name;
+        std::function<void(std::vector<uint64_t> &, std::mt19937_64 &)> fill;
+    };
 
-        patterns.push_back({"sequential", [](std::vector<uint64_t> & d, std::mt19937_64 &) { fillSequential64(d, 0ull, 1ull); }});
-        patterns.push_back({"all_zeros", [](std::vector<uint64_t> & d, std::mt19937_64 &) { fillConstant64(d, 0ull); }});
-        patterns.push_back({"all_same", [](std::vector<uint64_t> & d, std::mt19937_64 &) { fillConstant64(d, 42ull); }});
+    std::vector<TestPattern> patterns;
 
-        // Test various bit widths including values that span the 32-bit boundary
-        for (unsigned bw : {1u, 2u, 4u, 8u, 16u, 24u, 31u, 32u, 33u, 40u, 48u, 56u, 63u, 64u})
-        {
-            uint64_t max_val = (bw == 64) ? 0xFFFFFFFFFFFFFFFFull : ((1ull << bw) - 1ull);
-            patterns.push_back({"random_bw" + std::to_string(bw), [max_val](std::vector<uint64_t> & d, std::mt19937_64 & r) {
-                                    fillRandom64(d, max_val, r);
-                                }});
-        }
+    patterns.push_back({"sequential", [](std::vector<uint64_t> & d, std::mt19937_64 &) { fillSequential64(d, 0ull, 1ull); }});
+    patterns.push_back({"all_zeros", [](std::vector<uint64_t> & d, std::mt19937_64 &) { fillConstant64(d, 0ull); }});
+    patterns.push_back({"all_same", [](std::vector<uint64_t> & d, std::mt19937_64 &) { fillConstant64(d, 42ull); }});
 
-        // Exception patterns: base values fit in 8 bits, exceptions require more bits
-        patterns.push_back({"exceptions_5pct_32b", [](std::vector<uint64_t> & d, std::mt19937_64 & r) {
-                                fillWithExceptions64(d, 255ull, 100000ull, 5u, r);
-                            }});
-        patterns.push_back({"exceptions_10pct_32b", [](std::vector<uint64_t> & d, std::mt19937_64 & r) {
-                                fillWithExceptions64(d, 255ull, 100000ull, 10u, r);
-                            }});
-        patterns.push_back({"exceptions_25pct_32b", [](std::vector<uint64_t> & d, std::mt19937_64 & r) {
-                                fillWithExceptions64(d, 255ull, 100000ull, 25u, r);
+    // Test various bit widths including values that span the 32-bit boundary
+    for (unsigned bw : {1u, 2u, 4u, 8u, 16u, 24u, 31u, 32u, 33u, 40u, 48u, 56u, 63u, 64u})
+    {
+        uint64_t max_val = (bw == 64) ? 0xFFFFFFFFFFFFFFFFull : ((1ull << bw) - 1ull);
+        patterns.push_back({"random_bw" + std::to_string(bw), [max_val](std::vector<uint64_t> & d, std::mt19937_64 & r) {
+                                fillRandom64(d, max_val, r);
                             }});
+    }
 
-        // Exception patterns with 64-bit exception values
-        patterns.push_back({"exceptions_5pct_64b", [](std::vector<uint64_t> & d, std::mt19937_64 & r) {
-                                fillWithExceptions64(d, 255ull, 0x100000000ull, 5u, r);
-                            }});
-        patterns.push_back({"exceptions_10pct_64b", [](std::vector<uint64_t> & d, std::mt19937_64 & r) {
-                                fillWithExceptions64(d, 255ull, 0x100000000ull, 10u, r);
-                            }});
+    // Exception patterns: base values fit in 8 bits, exceptions require more bits
+    patterns.push_back({"exceptions_5pct_32b", [](std::vector<uint64_t> & d, std::mt19937_64 & r) {
+                            fillWithExceptions64(d, 255ull, 100000ull, 5u, r);
+                        }});
+    patterns.push_back({"exceptions_10pct_32b", [](std::vector<uint64_t> & d, std::mt19937_64 & r) {
+                            fillWithExceptions64(d, 255ull, 100000ull, 10u, r);
+                        }});
+    patterns.push_back({"exceptions_25pct_32b", [](std::vector<uint64_t> & d, std::mt19937_64 & r) {
+                            fillWithExceptions64(d, 255ull, 100000ull, 25u, r);
+                        }});
 
-        // Edge case: values requiring exactly 63 bits (tests 63→64 quirk)
-        patterns.push_back(
-            {"random_bw63_large", [](std::vector<uint64_t> & d, std::mt19937_64 & r) { fillRandom64(d, 0x7FFFFFFFFFFFFFFFull, r); }});
+    // Exception patterns with 64-bit exception values
+    patterns.push_back({"exceptions_5pct_64b", [](std::vector<uint64_t> & d, std::mt19937_64 & r) {
+                            fillWithExceptions64(d, 255ull, 0x100000000ull, 5u, r);
+                        }});
+    patterns.push_back({"exceptions_10pct_64b", [](std::vector<uint64_t> & d, std::mt19937_64 & r) {
+                            fillWithExceptions64(d, 255ull, 0x100000000ull, 10u, r);
+                        }});
+
+    // Edge case: values requiring exactly 63 bits (tests 63→64 quirk)
+    patterns.push_back(
+        {"random_bw63_large", [](std::vector<uint64_t> & d, std::mt19937_64 & r) { fillRandom64(d, 0x7FFFFFFFFFFFFFFFull, r); }});
 
+    for (unsigned n : sizes)
+    {
         for (const auto & pattern : patterns)
         {
             const unsigned input_extra = 32u;